@@ -0,0 +1,94 @@
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <cmath>
+#include <string>
+#include <thread>
+#include "STFT.h"
+#include "hammingFunction.h"
+#include "test-helpers/test-helpers.h"
+#include "bench-helpers/bench-helpers.h"
+
+// The previous STFT, kept here as the baseline: a complex-to-complex
+// transform planned with FFTW_ESTIMATE on every call.
+static std::vector<std::vector<double>> STFTComplex(const std::vector<double>& data, int windowSize, int hopSize) {
+    fftw_complex* in = (fftw_complex*)fftw_malloc(sizeof(fftw_complex) * windowSize);
+    fftw_complex* out = (fftw_complex*)fftw_malloc(sizeof(fftw_complex) * windowSize);
+    fftw_plan plan = fftw_plan_dft_1d(windowSize, in, out, FFTW_FORWARD, FFTW_ESTIMATE);
+    std::vector<double> window = hammingFunction(windowSize);
+
+    std::vector<std::vector<double>> spectrogram;
+    bool stop = false;
+    for (size_t pos = 0; pos < data.size() && !stop; pos += hopSize) {
+        for (int i = 0; i < windowSize; i++) {
+            size_t index = pos + i;
+            in[i][0] = index < data.size() ? data[index] * window[i] : 0.0;
+            in[i][1] = 0.0;
+            stop = stop || index >= data.size();
+        }
+        fftw_execute(plan);
+        std::vector<double> magnitudes(windowSize / 2 + 1);
+        for (int i = 0; i < windowSize / 2 + 1; i++) {
+            magnitudes[i] = std::sqrt(out[i][0] * out[i][0] + out[i][1] * out[i][1]);
+        }
+        spectrogram.push_back(magnitudes);
+    }
+    fftw_destroy_plan(plan);
+    fftw_free(in);
+    fftw_free(out);
+    return spectrogram;
+}
+
+// Many short calls, the pattern where per-call planning dominated.
+TEST(STFTBench, RealCachedVersusComplex) {
+    const int windowSize = 2048;
+    const int hopSize = 512;
+    std::vector<double> clip = generateSineWave(440.0, 44100.0, 0.25);
+
+    std::vector<std::vector<double>> reference;
+    Spectrogram cached;
+    double complexMs = bestTimeMs([&] {
+        for (int i = 0; i < 200; i++) reference = STFTComplex(clip, windowSize, hopSize);
+    });
+    STFT(clip, windowSize, hopSize); // first call plans; later calls reuse the plan
+    double cachedMs = bestTimeMs([&] {
+        for (int i = 0; i < 200; i++) cached = STFT(clip, windowSize, hopSize);
+    });
+    reportBench("STFT c2c, planned per call  x200", complexMs);
+    reportBench("STFT r2c, cached plan       x200", cachedMs, complexMs);
+
+    ASSERT_EQ(cached.numFrames(), reference.size());
+    for (size_t f = 0; f < cached.numFrames(); f++) {
+        for (size_t k = 0; k < cached.numBins(); k++) {
+            ASSERT_NEAR(cached(f, k), reference[f][k], 1e-9);
+        }
+    }
+}
+
+// One minute of audio split across 1, 2, 4, ... workers up to the hardware
+// thread count.
+TEST(STFTBench, ThreadScaling) {
+    const int windowSize = 2048;
+    const int hopSize = 512;
+    std::vector<double> signal = generateSineWave(440.0, 44100.0, 60.0);
+    Spectrogram serial = STFT(signal, windowSize, hopSize);
+
+    const size_t hardwareThreads = std::max(1u, std::thread::hardware_concurrency());
+    double singleMs = 0.0;
+    for (size_t threads = 1; ; threads = std::min(threads * 2, hardwareThreads)) {
+        ThreadPool pool(threads);
+        Spectrogram parallel;
+        double ms = bestTimeMs([&] { parallel = STFT(signal, windowSize, hopSize, pool); });
+        if (threads == 1) {
+            singleMs = ms;
+        }
+        reportBench("STFT 60 s, threads " + std::to_string(threads), ms, threads == 1 ? 0.0 : singleMs);
+
+        ASSERT_EQ(parallel.numFrames(), serial.numFrames());
+        for (size_t i = 0; i < serial.numFrames() * serial.numBins(); i += 101) {
+            ASSERT_EQ(parallel.data()[i], serial.data()[i]);
+        }
+        if (threads == hardwareThreads) {
+            break;
+        }
+    }
+}
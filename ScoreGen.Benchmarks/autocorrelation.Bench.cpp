@@ -0,0 +1,33 @@
+#include <gtest/gtest.h>
+#include <cmath>
+#include <vector>
+#include "autocorrelation.h"
+#include "note_duration_extractor.h"
+#include "bench-helpers/bench-helpers.h"
+
+// detectPitch's workload: 2048-sample frames, lags up to 44100 / 100 Hz.
+TEST(AutocorrelationBench, FFTVersusDirect) {
+    const size_t frameSize = PITCH_FRAME_SIZE;
+    const size_t maxLag = 441;
+    const int frames = 500;
+
+    std::vector<float> frame(frameSize);
+    for (size_t i = 0; i < frameSize; i++) {
+        frame[i] = static_cast<float>(std::sin(2 * 3.14159265358979 * 220.0 * i / 44100.0));
+    }
+    std::vector<double> direct(maxLag + 1), fast(maxLag + 1);
+    Autocorrelator autocorrelator;
+
+    double directMs = bestTimeMs([&] {
+        for (int f = 0; f < frames; f++) Autocorrelator::computeDirect(frame.data(), frameSize, maxLag, direct.data());
+    });
+    double fftMs = bestTimeMs([&] {
+        for (int f = 0; f < frames; f++) autocorrelator.compute(frame.data(), frameSize, maxLag, fast.data());
+    });
+    reportBench("autocorrelation direct  x500 frames", directMs);
+    reportBench("autocorrelation FFT     x500 frames", fftMs, directMs);
+
+    for (size_t lag = 0; lag <= maxLag; lag++) {
+        ASSERT_NEAR(fast[lag], direct[lag], 1e-9 * direct[0]);
+    }
+}
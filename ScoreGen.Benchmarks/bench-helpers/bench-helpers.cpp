@@ -0,0 +1,71 @@
+#define _USE_MATH_DEFINES
+#include "bench-helpers.h"
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+
+std::string datasetPath(const std::string& relativePath) {
+    return std::string(SCOREGEN_TEST_DATA_DIR) + "/" + relativePath;
+}
+
+static void writeLE(std::ofstream& out, uint32_t value, int bytes) {
+    for (int i = 0; i < bytes; i++) {
+        out.put(static_cast<char>((value >> (8 * i)) & 0xFF));
+    }
+}
+
+void writeBenchWav(const std::string& path, size_t frames, int channels, int sampleRate,
+                   int bitsPerSample, int audioFormat) {
+    std::ofstream out(path, std::ios::binary);
+    const int bytesPerSample = bitsPerSample / 8;
+    const uint32_t dataSize = static_cast<uint32_t>(frames * channels * bytesPerSample);
+
+    out.write("RIFF", 4);
+    writeLE(out, 36 + dataSize, 4);
+    out.write("WAVE", 4);
+    out.write("fmt ", 4);
+    writeLE(out, 16, 4);
+    writeLE(out, audioFormat, 2);
+    writeLE(out, channels, 2);
+    writeLE(out, sampleRate, 4);
+    writeLE(out, sampleRate * channels * bytesPerSample, 4);
+    writeLE(out, channels * bytesPerSample, 2);
+    writeLE(out, bitsPerSample, 2);
+    out.write("data", 4);
+    writeLE(out, dataSize, 4);
+
+    std::vector<char> block;
+    block.reserve(static_cast<size_t>(65536) * channels * bytesPerSample);
+    for (size_t i = 0; i < frames; i++) {
+        double t = static_cast<double>(i) / sampleRate;
+        double value = 0.5 * std::sin(2.0 * M_PI * (220.0 + 20.0 * t) * t);
+        for (int ch = 0; ch < channels; ch++) {
+            double v = ch % 2 ? 0.5 * value : value;
+            char bytes[4];
+            if (audioFormat == 3) {
+                float f = static_cast<float>(v);
+                std::memcpy(bytes, &f, 4);
+            } else {
+                int32_t scaled = static_cast<int32_t>(std::lround(v * ((1u << (bitsPerSample - 1)) - 1)));
+                for (int b = 0; b < bytesPerSample; b++) {
+                    bytes[b] = static_cast<char>((scaled >> (8 * b)) & 0xFF);
+                }
+            }
+            block.insert(block.end(), bytes, bytes + bytesPerSample);
+        }
+        if (block.size() >= block.capacity() - 64) {
+            out.write(block.data(), block.size());
+            block.clear();
+        }
+    }
+    out.write(block.data(), block.size());
+}
+
+void reportBench(const std::string& name, double ms, double baselineMs) {
+    if (baselineMs > 0.0) {
+        std::printf("[ BENCH    ] %-48s %10.2f ms  (%.2fx)\n", name.c_str(), ms, baselineMs / ms);
+    } else {
+        std::printf("[ BENCH    ] %-48s %10.2f ms\n", name.c_str(), ms);
+    }
+}
@@ -0,0 +1,40 @@
+#ifndef BENCH_HELPERS_H
+#define BENCH_HELPERS_H
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#ifndef SCOREGEN_TEST_DATA_DIR
+#define SCOREGEN_TEST_DATA_DIR "test/TestingDatasets"
+#endif
+
+// Returns the best wall time in milliseconds over `repetitions` runs of fn.
+template <typename Fn>
+double bestTimeMs(Fn&& fn, int repetitions = 3) {
+    double best = 0.0;
+    for (int i = 0; i < repetitions; i++) {
+        auto start = std::chrono::steady_clock::now();
+        fn();
+        auto end = std::chrono::steady_clock::now();
+        double ms = std::chrono::duration<double, std::milli>(end - start).count();
+        if (i == 0 || ms < best) {
+            best = ms;
+        }
+    }
+    return best;
+}
+
+// Absolute path of a file under test/TestingDatasets.
+std::string datasetPath(const std::string& relativePath);
+
+// Writes a WAV file of a slowly swept sine in every channel. audioFormat is 1
+// (PCM, 16/24/32 bit) or 3 (32-bit float).
+void writeBenchWav(const std::string& path, size_t frames, int channels, int sampleRate,
+                   int bitsPerSample, int audioFormat = 1);
+
+// Prints one benchmark result line in a fixed format.
+void reportBench(const std::string& name, double ms, double baselineMs = 0.0);
+
+#endif // BENCH_HELPERS_H
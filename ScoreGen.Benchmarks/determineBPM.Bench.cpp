@@ -0,0 +1,113 @@
+#define _USE_MATH_DEFINES
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <cmath>
+#include <vector>
+#include "determineBPM.h"
+#include "bench-helpers/bench-helpers.h"
+
+#define BENCH_RATE 44100
+#define BENCH_CHUNK_HOPS 5168 // about a minute of hops
+#define BENCH_CHUNKS 60
+
+// The original getBufferBPM loop: one fvec_set_sample() per sample, converting
+// from double, fed one hop at a time.
+static float perSampleBPM(const std::vector<double>& chunk, int chunks) {
+    aubio_tempo_t* tempo = new_aubio_tempo("specdiff", WIN_S, HOP_S, BENCH_RATE);
+    fvec_t* input = new_fvec(HOP_S);
+    fvec_t* tempoOut = new_fvec(1);
+    std::vector<float> beats;
+    for (int c = 0; c < chunks; c++) {
+        for (size_t i = 0; i < chunk.size(); i += HOP_S) {
+            for (size_t j = 0; j < HOP_S && (i + j) < chunk.size(); ++j) {
+                fvec_set_sample(input, chunk[i + j], j);
+            }
+            aubio_tempo_do(tempo, input, tempoOut);
+            if (fvec_get_sample(tempoOut, 0) != 0) {
+                beats.push_back(aubio_tempo_get_last_s(tempo));
+            }
+        }
+    }
+    del_aubio_tempo(tempo);
+    del_fvec(input);
+    del_fvec(tempoOut);
+    std::vector<float> bpms;
+    for (size_t i = 1; i < beats.size(); i++) {
+        bpms.push_back(60.0f / (beats[i] - beats[i - 1]));
+    }
+    return calculateMedian(bpms);
+}
+
+// `size` samples of a 120 BPM track of 50 ms 880 Hz bursts.
+static std::vector<double> clickTrack(size_t size) {
+    std::vector<double> signal(size, 0.0);
+    for (size_t start = 0; start < signal.size(); start += BENCH_RATE / 2) {
+        for (size_t i = 0; i < BENCH_RATE / 20 && start + i < signal.size(); i++) {
+            signal[start + i] = 0.5 * std::sin(2.0 * M_PI * 880.0 * i / BENCH_RATE);
+        }
+    }
+    return signal;
+}
+
+// One hour of a 120 BPM click track, fed to the tempo detector a minute at a
+// time: the per-sample loop, the TempoTracker from doubles (bulk conversion)
+// and from Samples (aubio reads the hops in place).
+TEST(DetermineBPMBench, OneHourHandoff) {
+    std::vector<double> chunk = clickTrack(BENCH_CHUNK_HOPS * HOP_S);
+    std::vector<Sample> samples(chunk.begin(), chunk.end());
+
+    float loopBPM = 0.0f;
+    double loopMs = bestTimeMs([&] { loopBPM = perSampleBPM(chunk, BENCH_CHUNKS); }, 1);
+
+    float doubleBPM = 0.0f;
+    double doubleMs = bestTimeMs([&] {
+        TempoTracker tracker(BENCH_RATE);
+        for (int c = 0; c < BENCH_CHUNKS; c++) {
+            tracker.push(chunk.data(), chunk.size());
+        }
+        doubleBPM = tracker.finish();
+    }, 1);
+
+    float sampleBPM = 0.0f;
+    double sampleMs = bestTimeMs([&] {
+        TempoTracker tracker(BENCH_RATE);
+        for (int c = 0; c < BENCH_CHUNKS; c++) {
+            tracker.push(samples.data(), samples.size());
+        }
+        sampleBPM = tracker.finish();
+    }, 1);
+
+    reportBench("tempo 1 h, per-sample fvec_set_sample", loopMs);
+    reportBench("tempo 1 h, TempoTracker from doubles", doubleMs, loopMs);
+    reportBench("tempo 1 h, TempoTracker in place", sampleMs, loopMs);
+    EXPECT_EQ(doubleBPM, loopBPM);
+    EXPECT_EQ(sampleBPM, loopBPM);
+}
+
+// Ten minutes of the click track through all three window configurations,
+// one after another and as the concurrent consensus. Given three cores the
+// consensus takes about as long as the slowest mode ("super-fast").
+TEST(DetermineBPMBench, ConsensusOfThreeModes) {
+    std::vector<double> clicks = clickTrack(10 * BENCH_CHUNK_HOPS * HOP_S);
+    std::vector<Sample> signal(clicks.begin(), clicks.end());
+
+    double slowestMs = 0.0;
+    std::vector<float> estimates;
+    double sequentialMs = bestTimeMs([&] {
+        estimates.clear();
+        for (const char* mode : {"default", "fast", "super-fast"}) {
+            double ms = bestTimeMs([&] {
+                estimates.push_back(getBufferBPM(signal.data(), signal.size(), BENCH_RATE, {{"mode", mode}}));
+            }, 1);
+            slowestMs = std::max(slowestMs, ms);
+        }
+    }, 1);
+
+    TempoConsensus consensus;
+    double consensusMs = bestTimeMs([&] { consensus = getConsensusBPM(signal.data(), signal.size(), BENCH_RATE); }, 1);
+
+    reportBench("tempo 10 min, three modes in turn", sequentialMs);
+    reportBench("tempo 10 min, slowest single mode", slowestMs, sequentialMs);
+    reportBench("tempo 10 min, concurrent consensus", consensusMs, sequentialMs);
+    EXPECT_EQ(consensus.bpm, reconcileTempi(estimates).bpm);
+}
@@ -0,0 +1,53 @@
+#include <gtest/gtest.h>
+#include <future>
+#include <vector>
+#include "audioBuffer.h"
+#include "determineBPM.h"
+#include "note_duration_extractor.h"
+#include "bench-helpers/bench-helpers.h"
+
+// Tempo detection and melody frames of a minute of piano, back to back as
+// dsp() used to run them and side by side as it does now. The concurrent
+// time drops toward the longer of the two stages given a spare core.
+TEST(DSPBench, TempoAlongsideFrames) {
+    AudioBuffer audio;
+    ASSERT_TRUE(audio.load(datasetPath("piano-samples/other/piano-c4-major-scale.wav").c_str()));
+    std::vector<Sample> signal;
+    while (signal.size() < static_cast<size_t>(60 * audio.sampleRate())) {
+        signal.insert(signal.end(), audio.data(), audio.data() + audio.size());
+    }
+
+    float tempoOnly = 0.0f;
+    double tempoMs = bestTimeMs([&] {
+        tempoOnly = getBufferBPM(signal.data(), signal.size(), audio.sampleRate());
+    }, 1);
+    double framesMs = bestTimeMs([&] {
+        analyzeFrames(signal.data(), signal.size(), audio.sampleRate());
+    }, 1);
+
+    float sequentialBPM = 0.0f;
+    FrameAnalysis sequential;
+    double sequentialMs = bestTimeMs([&] {
+        sequentialBPM = getBufferBPM(signal.data(), signal.size(), audio.sampleRate());
+        sequential = analyzeFrames(signal.data(), signal.size(), audio.sampleRate());
+    }, 1);
+
+    float concurrentBPM = 0.0f;
+    FrameAnalysis concurrent;
+    double concurrentMs = bestTimeMs([&] {
+        std::future<float> bpm = std::async(std::launch::async, [&] {
+            return getBufferBPM(signal.data(), signal.size(), audio.sampleRate());
+        });
+        concurrent = analyzeFrames(signal.data(), signal.size(), audio.sampleRate());
+        concurrentBPM = bpm.get();
+    }, 1);
+
+    reportBench("tempo 60 s", tempoMs);
+    reportBench("melody frames 60 s", framesMs);
+    reportBench("tempo then frames", sequentialMs);
+    reportBench("tempo alongside frames", concurrentMs, sequentialMs);
+    EXPECT_EQ(concurrentBPM, sequentialBPM);
+    EXPECT_EQ(sequentialBPM, tempoOnly);
+    EXPECT_EQ(concurrent.pitchEstimates, sequential.pitchEstimates);
+    EXPECT_EQ(concurrent.onsetTimes, sequential.onsetTimes);
+}
@@ -0,0 +1,62 @@
+#include <gtest/gtest.h>
+#include <cmath>
+#include <random>
+#include <vector>
+#include "energyEnvelope.h"
+#include "note_duration_extractor.h"
+#include "hanningFunction.h"
+#include "bench-helpers/bench-helpers.h"
+
+// Frame energies for 60 s of audio: the onset RMS (512 / 256) and the pitch
+// gate's windowed RMS (2048 / 512), summed directly per frame versus read
+// from one EnergyEnvelope pass.
+TEST(EnergyEnvelopeBench, FrameEnergies) {
+    const size_t size = 60 * 44100;
+    std::vector<Sample> signal(size);
+    std::mt19937 rng(3);
+    std::uniform_real_distribution<float> dist(-1.0f, 1.0f);
+    for (Sample& x : signal) {
+        x = dist(rng);
+    }
+    std::vector<double> window = hanningFunction(PITCH_FRAME_SIZE);
+    const size_t onsetFrames = (size - ONSET_FRAME_SIZE) / ONSET_HOP_SIZE + 1;
+    const size_t pitchFrames = (size - PITCH_FRAME_SIZE) / PITCH_HOP_SIZE + 1;
+
+    double directSum = 0.0;
+    double directMs = bestTimeMs([&] {
+        directSum = 0.0;
+        for (size_t f = 0; f < onsetFrames; f++) {
+            double sumSq = 0.0;
+            for (int n = 0; n < ONSET_FRAME_SIZE; n++) {
+                double x = signal[f * ONSET_HOP_SIZE + n];
+                sumSq += x * x;
+            }
+            directSum += std::sqrt(sumSq / ONSET_FRAME_SIZE);
+        }
+        for (size_t f = 0; f < pitchFrames; f++) {
+            double sumSq = 0.0;
+            for (int n = 0; n < PITCH_FRAME_SIZE; n++) {
+                double x = signal[f * PITCH_HOP_SIZE + n] * window[n];
+                sumSq += x * x;
+            }
+            directSum += std::sqrt(sumSq / PITCH_FRAME_SIZE);
+        }
+    });
+
+    double envelopeSum = 0.0;
+    double envelopeMs = bestTimeMs([&] {
+        EnergyEnvelope envelope(ENERGY_ENVELOPE_RESOLUTION, PITCH_FRAME_SIZE);
+        envelope.append(signal.data(), signal.size());
+        envelopeSum = 0.0;
+        for (size_t f = 0; f < onsetFrames; f++) {
+            envelopeSum += envelope.rms(f * ONSET_HOP_SIZE, ONSET_FRAME_SIZE);
+        }
+        for (size_t f = 0; f < pitchFrames; f++) {
+            envelopeSum += envelope.hannRMS(f * PITCH_HOP_SIZE);
+        }
+    });
+
+    reportBench("frame energies 60 s, direct", directMs);
+    reportBench("frame energies 60 s, envelope", envelopeMs, directMs);
+    EXPECT_NEAR(envelopeSum, directSum, 1e-6 * directSum);
+}
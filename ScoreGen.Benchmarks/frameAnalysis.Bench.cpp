@@ -0,0 +1,42 @@
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <string>
+#include <thread>
+#include <vector>
+#include "audioBuffer.h"
+#include "note_duration_extractor.h"
+#include "bench-helpers/bench-helpers.h"
+
+// Pitch and onset passes over a long recording (a piano scale repeated to
+// about a minute) with growing pool sizes.
+TEST(FrameAnalysisBench, ThreadScaling) {
+    AudioBuffer audio;
+    ASSERT_TRUE(audio.load(datasetPath("piano-samples/other/piano-c4-major-scale.wav").c_str()));
+    std::vector<Sample> signal;
+    while (signal.size() < static_cast<size_t>(60 * audio.sampleRate())) {
+        signal.insert(signal.end(), audio.data(), audio.data() + audio.size());
+    }
+
+    ThreadPool serialPool(1);
+    FrameAnalysis serial = analyzeFrames(signal.data(), signal.size(), audio.sampleRate(), serialPool);
+
+    const size_t hardwareThreads = std::max(1u, std::thread::hardware_concurrency());
+    double singleMs = 0.0;
+    for (size_t threads = 1; ; threads = std::min(threads * 2, hardwareThreads)) {
+        ThreadPool pool(threads);
+        FrameAnalysis parallel;
+        double ms = bestTimeMs([&] {
+            parallel = analyzeFrames(signal.data(), signal.size(), audio.sampleRate(), pool);
+        });
+        if (threads == 1) {
+            singleMs = ms;
+        }
+        reportBench("frame analysis 60 s, threads " + std::to_string(threads), ms, threads == 1 ? 0.0 : singleMs);
+
+        ASSERT_EQ(parallel.pitchEstimates, serial.pitchEstimates);
+        ASSERT_EQ(parallel.onsetTimes, serial.onsetTimes);
+        if (threads == hardwareThreads) {
+            break;
+        }
+    }
+}
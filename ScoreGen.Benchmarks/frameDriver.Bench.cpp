@@ -0,0 +1,42 @@
+#include <gtest/gtest.h>
+#include <vector>
+#include "audioBuffer.h"
+#include "determineBPM.h"
+#include "note_duration_extractor.h"
+#include "bench-helpers/bench-helpers.h"
+
+// Tempo, onset and pitch analysis of a minute of piano on one thread: tempo
+// as its own pass over the signal followed by frame analysis, versus tempo
+// riding along on the frame analysis' driver pass.
+TEST(FrameDriverBench, SharedTempoPass) {
+    AudioBuffer audio;
+    ASSERT_TRUE(audio.load(datasetPath("piano-samples/other/piano-c4-major-scale.wav").c_str()));
+    std::vector<Sample> signal;
+    while (signal.size() < static_cast<size_t>(60 * audio.sampleRate())) {
+        signal.insert(signal.end(), audio.data(), audio.data() + audio.size());
+    }
+    ThreadPool serialPool(1);
+
+    float separateBPM = 0.0f;
+    FrameAnalysis separate;
+    double separateMs = bestTimeMs([&] {
+        separateBPM = getBufferBPM(signal.data(), signal.size(), audio.sampleRate());
+        separate = analyzeFrames(signal.data(), signal.size(), audio.sampleRate(), serialPool);
+    });
+
+    float sharedBPM = 0.0f;
+    FrameAnalysis shared;
+    double sharedMs = bestTimeMs([&] {
+        FrameDriver driver;
+        TempoTracker tempo(audio.sampleRate());
+        driver.add(tempo);
+        shared = analyzeFrames(signal.data(), signal.size(), audio.sampleRate(), driver, serialPool);
+        sharedBPM = tempo.finish();
+    });
+
+    reportBench("tempo + frames 60 s, separate passes", separateMs);
+    reportBench("tempo + frames 60 s, shared driver", sharedMs, separateMs);
+    EXPECT_EQ(sharedBPM, separateBPM);
+    EXPECT_EQ(shared.pitchEstimates, separate.pitchEstimates);
+    EXPECT_EQ(shared.onsetTimes, separate.onsetTimes);
+}
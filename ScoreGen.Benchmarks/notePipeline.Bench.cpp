@@ -0,0 +1,92 @@
+#include <gtest/gtest.h>
+#include <cctype>
+#include <cmath>
+#include <map>
+#include <string>
+#include <vector>
+#include "dsp.h"
+#include "pitchSpelling.h"
+#include "bench-helpers/bench-helpers.h"
+
+// The pipeline as it was when pitches travelled as names: every frame's
+// estimate became a string, segments merged on string equality and the
+// name was parsed back apart for the key histogram.
+static std::vector<int> stringPathDurations(const std::vector<double>& pitches) {
+    const char* noteNames[] = {"C", "C#", "D", "D#", "E", "F",
+                               "F#", "G", "G#", "A", "A#", "B"};
+    std::vector<std::string> segments;
+    std::vector<int> lengths;
+    for (double pitch : pitches) {
+        std::string name = "Rest";
+        if (pitch > 0) {
+            int midi = static_cast<int>(std::round(12 * std::log2(pitch / 440.0))) + 69;
+            name = std::string(noteNames[midi % 12]) + std::to_string(midi / 12 - 1);
+        }
+        if (!segments.empty() && segments.back() == name) {
+            lengths.back()++;
+        } else {
+            segments.push_back(name);
+            lengths.push_back(1);
+        }
+    }
+
+    std::map<std::string, int> pitchClasses = {
+        {"C", 0}, {"C#", 1}, {"D", 2}, {"D#", 3},
+        {"E", 4}, {"F", 5}, {"F#", 6}, {"G", 7},
+        {"G#", 8}, {"A", 9}, {"A#", 10}, {"B", 11}
+    };
+    std::vector<int> durations(12, 0);
+    for (size_t i = 0; i < segments.size(); i++) {
+        if (segments[i] == "Rest") {
+            continue;
+        }
+        std::string step;
+        for (char c : segments[i]) {
+            if (std::isalpha(static_cast<unsigned char>(c)) || c == '#') {
+                step += c;
+            }
+        }
+        durations[pitchClasses[step]] += lengths[i];
+    }
+    return durations;
+}
+
+static std::vector<int> midiPathDurations(const std::vector<double>& pitches) {
+    std::vector<XMLNote> notes;
+    for (double pitch : pitches) {
+        int midi = frequencyToMidi(pitch);
+        if (!notes.empty() && notes.back().midi == midi) {
+            notes.back().duration++;
+        } else {
+            Note note = {0.0f, 0.0f, midi, "quarter"};
+            notes.push_back(convertToXMLNote(note, 120));
+            notes.back().duration = 1;
+        }
+    }
+    return calculatePitchDurations(notes);
+}
+
+// Frame pitches to key histogram over a dense stream of short notes and
+// rests (two million frames, a new note every three frames on average).
+TEST(NotePipelineBench, MidiVersusNames) {
+    std::vector<double> pitches(2000000);
+    unsigned state = 12345;
+    double pitch = 440.0;
+    for (size_t i = 0; i < pitches.size(); i++) {
+        state = state * 1103515245u + 12345u;
+        if ((state >> 16) % 3 == 0) {
+            int midi = 36 + static_cast<int>((state >> 8) % 49);
+            pitch = (state >> 4) % 7 == 0 ? 0.0 : 440.0 * std::pow(2.0, (midi - 69) / 12.0);
+        }
+        pitches[i] = pitch;
+    }
+
+    std::vector<int> byName;
+    double nameMs = bestTimeMs([&] { byName = stringPathDurations(pitches); });
+    std::vector<int> byMidi;
+    double midiMs = bestTimeMs([&] { byMidi = midiPathDurations(pitches); });
+
+    reportBench("2M frames to pitch-class durations, note names", nameMs);
+    reportBench("2M frames to pitch-class durations, MIDI numbers", midiMs, nameMs);
+    EXPECT_EQ(byMidi, byName);
+}
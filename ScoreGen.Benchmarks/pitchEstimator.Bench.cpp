@@ -0,0 +1,90 @@
+#include <gtest/gtest.h>
+#include <cstdio>
+#include <vector>
+#include "audioBuffer.h"
+#include "note_duration_extractor.h"
+#include "pitchEstimator.h"
+#include "pitchSpelling.h"
+#include "bench-helpers/bench-helpers.h"
+
+// Pitch pass over a decoded piano scale with each estimator. The RMS gate and
+// windowing are shared, so the differences come from the estimators.
+TEST(PitchEstimatorBench, EstimatorsOnPianoScale) {
+    AudioBuffer audio;
+    ASSERT_TRUE(audio.load(datasetPath("piano-samples/other/piano-c4-major-scale.wav").c_str()));
+
+    struct Variant {
+        const char* name;
+        PitchMethod method;
+        bool earlyTermination;
+    };
+    const Variant variants[] = {
+        {"pitch pass autocorrelation         ", PitchMethod::Autocorrelation, true},
+        {"pitch pass YIN (early termination) ", PitchMethod::YIN, true},
+        {"pitch pass YIN (FFT)               ", PitchMethod::YIN, false},
+        {"pitch pass MPM (early termination) ", PitchMethod::MPM, true},
+        {"pitch pass MPM (FFT)               ", PitchMethod::MPM, false},
+    };
+
+    double baselineMs = 0.0;
+    for (const Variant& variant : variants) {
+        PitchOptions options = defaultPitchOptions(variant.method);
+        options.earlyTermination = variant.earlyTermination;
+        size_t frames = 0;
+        double ms = bestTimeMs([&] {
+            frames = analyzeFrames(audio.data(), audio.size(), audio.sampleRate(), options).pitchEstimates.size();
+        });
+        ASSERT_GT(frames, 0u);
+        reportBench(variant.name, ms, baselineMs);
+        if (baselineMs == 0.0) {
+            baselineMs = ms;
+        }
+    }
+}
+
+// Autocorrelation pitch pass over the computer-generated D4-E5 scales at each
+// decimation factor of the coarse-to-fine search, single-threaded. Accuracy is
+// the share of frames that land on the same MIDI note as the full search.
+TEST(PitchEstimatorBench, CoarseToFineOnGeneratedScales) {
+    struct Fixture {
+        const char* label;
+        const char* path;
+    };
+    const Fixture fixtures[] = {
+        {"D4-E5", "Computer-Generated-Samples/D4_to_E5_1_second_per_note.wav"},
+        {"D4-E5 rests", "Computer-Generated-Samples/D4_to_E5_1_second_per_note_half_second_rest.wav"}
+    };
+    ThreadPool serialPool(1);
+    for (const Fixture& fixture : fixtures) {
+        AudioBuffer audio;
+        ASSERT_TRUE(audio.load(datasetPath(fixture.path).c_str()));
+
+        std::vector<double> reference;
+        double baselineMs = 0.0;
+        for (int decimation : {1, 2, 4}) {
+            PitchOptions options;
+            options.decimation = decimation;
+            std::vector<double> pitches;
+            double ms = bestTimeMs([&] {
+                pitches = analyzeFrames(audio.data(), audio.size(), audio.sampleRate(), serialPool,
+                                        options).pitchEstimates;
+            });
+            if (decimation == 1) {
+                reference = pitches;
+            }
+            ASSERT_EQ(pitches.size(), reference.size());
+            size_t agree = 0;
+            for (size_t i = 0; i < pitches.size(); i++) {
+                agree += frequencyToMidi(pitches[i]) == frequencyToMidi(reference[i]);
+            }
+            double accuracy = 100.0 * agree / pitches.size();
+            char name[64];
+            std::snprintf(name, sizeof(name), "%s, decimation %dx, %.1f%% agree", fixture.label, decimation, accuracy);
+            reportBench(name, ms, baselineMs);
+            if (decimation == 1) {
+                baselineMs = ms;
+            }
+            EXPECT_GT(accuracy, 98.0) << fixture.path << " at " << decimation << "x";
+        }
+    }
+}
@@ -0,0 +1,35 @@
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <string>
+#include <thread>
+#include <vector>
+#include "audioBuffer.h"
+#include "polyphonicDetector.h"
+#include "bench-helpers/bench-helpers.h"
+
+// The chord pass over the chord progression recording, on one thread and on
+// every hardware thread, against the recording's own length.
+TEST(PolyphonicDetectorBench, ChordProgression) {
+    AudioBuffer audio;
+    ASSERT_TRUE(audio.load(datasetPath("piano-samples/sample-chords/piano-chord-progression1.wav").c_str()));
+    const double audioMs = 1000.0 * audio.size() / audio.sampleRate();
+
+    ThreadPool serialPool(1);
+    PolyphonicAnalysis serial;
+    double serialMs = bestTimeMs([&] {
+        serial = analyzePolyphonicFrames(audio.data(), audio.size(), audio.sampleRate(), serialPool);
+    });
+
+    ThreadPool pool(std::max(1u, std::thread::hardware_concurrency()));
+    PolyphonicAnalysis parallel;
+    double parallelMs = bestTimeMs([&] {
+        parallel = analyzePolyphonicFrames(audio.data(), audio.size(), audio.sampleRate(), pool);
+    });
+
+    reportBench("chord pass, real time", audioMs);
+    reportBench("chord pass, threads 1", serialMs, audioMs);
+    reportBench("chord pass, threads " + std::to_string(pool.size()), parallelMs, audioMs);
+
+    ASSERT_EQ(parallel.frameKeys, serial.frameKeys);
+    EXPECT_LT(serialMs, audioMs);
+}
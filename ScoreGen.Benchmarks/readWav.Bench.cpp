@@ -0,0 +1,125 @@
+#include <gtest/gtest.h>
+#include <cstring>
+#include <cstdio>
+#include <fstream>
+#include "readWav.h"
+#include "bench-helpers/bench-helpers.h"
+
+// The previous ifstream-based reader, kept here as the baseline: one stream
+// read per sample per channel with the format switch in the inner loop.
+template <typename T>
+static T readLE(std::ifstream &in) {
+    T value;
+    in.read(reinterpret_cast<char*>(&value), sizeof(T));
+    return value;
+}
+
+static bool readWavStream(const std::string& filename, std::vector<double>& samples, int& sampleRate) {
+    std::ifstream in(filename, std::ios::binary);
+    if (!in) return false;
+    char id[4];
+    in.read(id, 4);
+    readLE<uint32_t>(in);
+    in.read(id, 4);
+
+    uint16_t audioFormat = 0, numChannels = 0, bitsPerSample = 0;
+    uint32_t sRate = 0, size = 0;
+    bool fmtFound = false;
+    while (!fmtFound && in.read(id, 4)) {
+        size = readLE<uint32_t>(in);
+        if (std::strncmp(id, "fmt ", 4) == 0) {
+            fmtFound = true;
+            audioFormat = readLE<uint16_t>(in);
+            numChannels = readLE<uint16_t>(in);
+            sRate = readLE<uint32_t>(in);
+            readLE<uint32_t>(in);
+            readLE<uint16_t>(in);
+            bitsPerSample = readLE<uint16_t>(in);
+            if (size > 16) in.ignore(size - 16);
+        } else {
+            in.ignore(size);
+        }
+    }
+    bool dataFound = false;
+    while (!dataFound && in.read(id, 4)) {
+        size = readLE<uint32_t>(in);
+        if (std::strncmp(id, "data", 4) == 0) dataFound = true;
+        else in.ignore(size);
+    }
+    if (!fmtFound || !dataFound) return false;
+    sampleRate = sRate;
+
+    size_t totalFrames = size / (numChannels * (bitsPerSample / 8));
+    samples.resize(totalFrames);
+    for (size_t i = 0; i < totalFrames; i++) {
+        double mixedSample = 0.0;
+        for (int ch = 0; ch < numChannels; ch++) {
+            double sampleValue = 0.0;
+            if (audioFormat == 1) {
+                if (bitsPerSample == 16) {
+                    int16_t s;
+                    in.read(reinterpret_cast<char*>(&s), sizeof(s));
+                    sampleValue = s / 32768.0;
+                } else if (bitsPerSample == 24) {
+                    unsigned char b[3];
+                    in.read(reinterpret_cast<char*>(b), 3);
+                    int32_t s = b[0] | (b[1] << 8) | (b[2] << 16);
+                    if (s & 0x800000) s |= 0xFF000000;
+                    sampleValue = s / 8388608.0;
+                } else if (bitsPerSample == 32) {
+                    int32_t s;
+                    in.read(reinterpret_cast<char*>(&s), sizeof(s));
+                    sampleValue = s / 2147483648.0;
+                }
+            } else if (audioFormat == 3) {
+                float s;
+                in.read(reinterpret_cast<char*>(&s), sizeof(s));
+                sampleValue = s;
+            }
+            mixedSample += sampleValue;
+        }
+        samples[i] = mixedSample / numChannels;
+    }
+    return true;
+}
+
+struct WavBenchCase {
+    const char* name;
+    int channels;
+    int bitsPerSample;
+    int audioFormat;
+};
+
+class ReadWavBench : public ::testing::TestWithParam<WavBenchCase> {};
+
+// 10 minutes at 48 kHz, the case called out in the original report.
+TEST_P(ReadWavBench, MappedVersusStream) {
+    const WavBenchCase& c = GetParam();
+    const size_t frames = static_cast<size_t>(48000) * 600;
+    const std::string path = std::string("bench_") + c.name + ".wav";
+    writeBenchWav(path, frames, c.channels, 48000, c.bitsPerSample, c.audioFormat);
+
+    std::vector<Sample> mapped;
+    std::vector<double> stream;
+    int mappedRate = 0, streamRate = 0;
+    double streamMs = bestTimeMs([&] { readWavStream(path, stream, streamRate); }, 1);
+    double mappedMs = bestTimeMs([&] { readWav(path, mapped, mappedRate); });
+    reportBench(std::string("readWav stream  ") + c.name, streamMs);
+    reportBench(std::string("readWav mapped  ") + c.name, mappedMs, streamMs);
+
+    ASSERT_EQ(mapped.size(), stream.size());
+    EXPECT_EQ(mappedRate, streamRate);
+    for (size_t i = 0; i < mapped.size(); i += 997) {
+        ASSERT_NEAR(mapped[i], stream[i], 1e-6) << "frame " << i;
+    }
+    std::remove(path.c_str());
+}
+
+INSTANTIATE_TEST_SUITE_P(Formats, ReadWavBench, ::testing::Values(
+    WavBenchCase{"pcm16_mono", 1, 16, 1},
+    WavBenchCase{"pcm16_stereo", 2, 16, 1},
+    WavBenchCase{"pcm24_mono", 1, 24, 1},
+    WavBenchCase{"pcm24_stereo", 2, 24, 1},
+    WavBenchCase{"pcm32_stereo", 2, 32, 1},
+    WavBenchCase{"float32_stereo", 2, 32, 3}
+), [](const ::testing::TestParamInfo<WavBenchCase>& info) { return std::string(info.param.name); });
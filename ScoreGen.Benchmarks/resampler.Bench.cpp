@@ -0,0 +1,49 @@
+#include <gtest/gtest.h>
+#include <cstdio>
+#include <vector>
+#include "audioBuffer.h"
+#include "note_duration_extractor.h"
+#include "resampler.h"
+#include "bench-helpers/bench-helpers.h"
+
+// Melody analysis of a minute of piano on one thread at the recorded 44.1 kHz
+// and resampled to 16 and 11.025 kHz with frame sizes scaled to match; the
+// resampled timings include the resampling. Agreement is the share of pitch
+// frames on the same MIDI note as at the recorded rate (frame counts match
+// within one or two frames at the end).
+TEST(ResamplerBench, AnalysisRates) {
+    AudioBuffer audio;
+    ASSERT_TRUE(audio.load(datasetPath("piano-samples/other/piano-c4-major-scale.wav").c_str()));
+    std::vector<Sample> signal;
+    while (signal.size() < static_cast<size_t>(60 * audio.sampleRate())) {
+        signal.insert(signal.end(), audio.data(), audio.data() + audio.size());
+    }
+    ThreadPool serialPool(1);
+
+    FrameAnalysis native;
+    double nativeMs = bestTimeMs([&] {
+        native = analyzeFrames(signal.data(), signal.size(), audio.sampleRate(), serialPool);
+    });
+    reportBench("melody 60 s at 44.1 kHz", nativeMs);
+
+    for (int analysisRate : {16000, 11025}) {
+        FrameAnalysis analysis;
+        double ms = bestTimeMs([&] {
+            Resampler<Sample> resampler(audio.sampleRate(), analysisRate);
+            std::vector<Sample> resampled(resampler.outputSize(signal.size()));
+            resampler.process(signal, resampled);
+            analysis = analyzeFrames(resampled.data(), resampled.size(), analysisRate, serialPool, PitchOptions(),
+                                     FrameGeometry::scaled(audio.sampleRate(), analysisRate));
+        });
+        const size_t frames = std::min(analysis.pitchEstimates.size(), native.pitchEstimates.size());
+        size_t agree = 0;
+        for (size_t i = 0; i < frames; i++) {
+            agree += frequencyToMidi(analysis.pitchEstimates[i]) == frequencyToMidi(native.pitchEstimates[i]);
+        }
+        char name[64];
+        std::snprintf(name, sizeof(name), "melody 60 s at %.5g kHz, %.1f%% agree", analysisRate / 1000.0,
+                      100.0 * agree / frames);
+        reportBench(name, ms, nativeMs);
+        EXPECT_GT(agree, frames * 9 / 10);
+    }
+}
@@ -0,0 +1,52 @@
+#include <gtest/gtest.h>
+#include <vector>
+#include "audioBuffer.h"
+#include "determineBPM.h"
+#include "tempogram.h"
+#include "tempoMap.h"
+#include "bench-helpers/bench-helpers.h"
+
+#define BENCH_MINUTES 60
+
+// An hour of piano, fed a scale recording at a time the way dsp() streams a
+// file that long: the single aubio estimate, the single tempogram estimate
+// dsp() makes by default, and the tempo map, which is the tempogram's flux
+// pass plus the windows, on one thread and across the shared pool.
+TEST(TempoMapBench, OneHour) {
+    AudioBuffer audio;
+    ASSERT_TRUE(audio.load(datasetPath("piano-samples/sample-scales/c-major-scale-on-treble-clef.wav").c_str()));
+    const size_t repeats = static_cast<size_t>(BENCH_MINUTES * 60 * audio.sampleRate()) / audio.size() + 1;
+    ThreadPool serialPool(1);
+
+    double aubioMs = bestTimeMs([&] {
+        TempoTracker tracker(audio.sampleRate());
+        for (size_t i = 0; i < repeats; i++) {
+            tracker.push(audio.data(), audio.size());
+        }
+        tracker.finish();
+    }, 1);
+
+    std::vector<double> envelope;
+    double framesPerSecond = 0.0;
+    double fluxMs = bestTimeMs([&] {
+        TempogramTracker tracker(audio.sampleRate());
+        for (size_t i = 0; i < repeats; i++) {
+            tracker.push(audio.data(), audio.size());
+        }
+        tracker.finish();
+        envelope = tracker.envelope();
+        framesPerSecond = tracker.framesPerSecond();
+    }, 1);
+
+    TempoMap serial;
+    double serialMs = bestTimeMs([&] { serial = estimateTempoMap(envelope, framesPerSecond, serialPool); }, 1);
+
+    TempoMap parallel;
+    double parallelMs = bestTimeMs([&] { parallel = estimateTempoMap(envelope, framesPerSecond); }, 1);
+
+    reportBench("tempo 1 h, single aubio estimate", aubioMs);
+    reportBench("tempo 1 h, single tempogram estimate", fluxMs, aubioMs);
+    reportBench("tempo map 1 h, windows on one thread", fluxMs + serialMs, aubioMs);
+    reportBench("tempo map 1 h, windows on the shared pool", fluxMs + parallelMs, aubioMs);
+    EXPECT_EQ(parallel.bpms, serial.bpms);
+}
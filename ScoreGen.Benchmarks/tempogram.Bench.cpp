@@ -0,0 +1,38 @@
+#include <gtest/gtest.h>
+#include <cstdio>
+#include <vector>
+#include "audioBuffer.h"
+#include "determineBPM.h"
+#include "tempogram.h"
+#include "STFT.h"
+#include "bench-helpers/bench-helpers.h"
+
+// Tempo of a minute of piano scales: the aubio tracker, the tempogram
+// tracker with its own transforms, and the tempogram read from a spectrogram
+// that another analysis already computed (flux and autocorrelation only).
+TEST(TempogramBench, OneMinuteOfScales) {
+    AudioBuffer audio;
+    ASSERT_TRUE(audio.load(datasetPath("piano-samples/sample-scales/c-major-scale-on-treble-clef.wav").c_str()));
+    std::vector<Sample> signal;
+    while (signal.size() < static_cast<size_t>(60 * audio.sampleRate())) {
+        signal.insert(signal.end(), audio.data(), audio.data() + audio.size());
+    }
+
+    float aubioBPM = 0.0f;
+    double aubioMs = bestTimeMs([&] { aubioBPM = getBufferBPM(signal.data(), signal.size(), audio.sampleRate()); });
+
+    float trackerBPM = 0.0f;
+    double trackerMs = bestTimeMs([&] { trackerBPM = getTempogramBPM(signal.data(), signal.size(), audio.sampleRate()); });
+
+    SpectrogramF spectrogram = STFT<float>(signal, TEMPOGRAM_WINDOW, TEMPOGRAM_HOP);
+    float sharedBPM = 0.0f;
+    double sharedMs = bestTimeMs([&] { sharedBPM = tempogramBPM(spectrogram, audio.sampleRate(), TEMPOGRAM_HOP); });
+
+    char name[64];
+    std::snprintf(name, sizeof(name), "tempo 60 s, aubio specdiff, %.1f BPM", aubioBPM);
+    reportBench(name, aubioMs);
+    std::snprintf(name, sizeof(name), "tempo 60 s, tempogram tracker, %.1f BPM", trackerBPM);
+    reportBench(name, trackerMs, aubioMs);
+    reportBench("tempo 60 s, tempogram of a shared STFT", sharedMs, aubioMs);
+    EXPECT_NEAR(sharedBPM, trackerBPM, 0.01);
+}
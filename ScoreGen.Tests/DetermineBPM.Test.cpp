@@ -94,4 +94,38 @@ TEST_F(BPMDetectionTest, InvalidMode) {
     std::vector<double> buffer = loadAudioFile(testCases[0].filepath);
     std::map<std::string, std::string> params{ {"mode", "invalid"} };
     EXPECT_THROW(getBufferBPM(buffer, 44100, params), std::invalid_argument);
-}
\ No newline at end of file
+}
+
+TEST(TempoConsensusTest, OctaveErrorsBackTheMajority) {
+    TempoConsensus consensus = reconcileTempi({ 120.0f, 60.0f, 121.0f });
+    EXPECT_NEAR(consensus.bpm, (120.0f + 120.0f + 121.0f) / 3, 1e-3);
+    EXPECT_NEAR(consensus.confidence, 2.5f / 3, 1e-6);
+}
+
+TEST(TempoConsensusTest, DisagreementFallsBackToTheFirstEstimate) {
+    TempoConsensus consensus = reconcileTempi({ 100.0f, 137.0f, 81.0f });
+    EXPECT_EQ(consensus.bpm, 100.0f);
+    EXPECT_NEAR(consensus.confidence, 1.0f / 3, 1e-6);
+}
+
+TEST(TempoConsensusTest, ModesWithoutBeatsDoNotVote) {
+    TempoConsensus consensus = reconcileTempi({ 0.0f, 90.0f, 0.0f });
+    EXPECT_EQ(consensus.bpm, 90.0f);
+    EXPECT_NEAR(consensus.confidence, 1.0f / 3, 1e-6);
+    EXPECT_EQ(reconcileTempi({ 0.0f, 0.0f, 0.0f }).bpm, 0.0f);
+    EXPECT_EQ(reconcileTempi({}).confidence, 0.0f);
+}
+
+TEST_F(BPMDetectionTest, ConsensusReconcilesTheThreeModes) {
+    std::vector<double> buffer = loadAudioFile(testCases[0].filepath);
+    std::vector<float> estimates;
+    for (const char* mode : { "default", "fast", "super-fast" }) {
+        estimates.push_back(getBufferBPM(buffer, 44100, { {"mode", mode} }));
+    }
+    TempoConsensus expected = reconcileTempi(estimates);
+
+    TempoConsensus consensus = getConsensusBPM(buffer.data(), buffer.size(), 44100);
+    EXPECT_EQ(consensus.bpm, expected.bpm);
+    EXPECT_EQ(consensus.confidence, expected.confidence);
+    EXPECT_EQ(getBufferBPM(buffer, 44100, { {"mode", "consensus"} }), expected.bpm);
+}
@@ -26,10 +26,10 @@ TEST(STFTTests, SpectrogramDimensions) {
     auto constSignal = generateConstantSignal(val, SAMPLE_RATE, duration);
     auto spectrogram = STFT(constSignal, WINDOW_SIZE, HOP_SIZE);
     int expectedFrames = static_cast<int>(ceil((duration * SAMPLE_RATE - WINDOW_SIZE) / HOP_SIZE)) + 1;
-    EXPECT_EQ(spectrogram.size(), static_cast<size_t>(expectedFrames));
+    EXPECT_EQ(spectrogram.numFrames(), static_cast<size_t>(expectedFrames));
 
     // Number of freq bins should be windowSize / 2 + 1
-    EXPECT_EQ(spectrogram[0].size(), static_cast<size_t>(WINDOW_SIZE / 2 + 1));
+    EXPECT_EQ(spectrogram.numBins(), static_cast<size_t>(WINDOW_SIZE / 2 + 1));
 }
 
 TEST(STFTTests, ConstantSignal) {
@@ -52,10 +52,10 @@ TEST(STFTTests, ConstantSignal) {
     fftw_execute(planForward);
 
     // Skip the last frame, padded with zeros by STFT operation
-    for (int i = 0; i < spectrogram.size() - 1 ; i++) {
-        for (int j = 0; j < spectrogram[i].size(); j++) {
+    for (size_t i = 0; i + 1 < spectrogram.numFrames(); i++) {
+        for (size_t j = 0; j < spectrogram.numBins(); j++) {
             double expected = sqrt(out[j][0]*out[j][0] + out[j][1]*out[j][1]);
-            EXPECT_NEAR(spectrogram[i][j], expected, FP_TOL);
+            EXPECT_NEAR(spectrogram(i, j), expected, FP_TOL);
         }
     }
 }
@@ -65,4 +65,52 @@ TEST(STFTTests, EmptySignal) {
     auto spectrogram = STFT(emptySignal, WINDOW_SIZE, HOP_SIZE);
 
     EXPECT_TRUE(spectrogram.empty());
-}
\ No newline at end of file
+}
+
+TEST(STFTTests, FrameAndBinViewsShareStorage) {
+    auto sineWave = generateSineWave(440.0, SAMPLE_RATE, 0.25);
+    const Spectrogram spectrogram = STFT(sineWave, WINDOW_SIZE, HOP_SIZE);
+    ASSERT_FALSE(spectrogram.empty());
+
+    size_t f = spectrogram.numFrames() / 2;
+    size_t k = 20;
+    Span<const double> frame = spectrogram.frame(f);
+    StridedView<const double> column = spectrogram.bin(k);
+    EXPECT_EQ(frame.size(), spectrogram.numBins());
+    EXPECT_EQ(column.size(), spectrogram.numFrames());
+    EXPECT_EQ(column.stride(), spectrogram.frameStride());
+    EXPECT_EQ(frame[k], spectrogram(f, k));
+    EXPECT_EQ(column[f], spectrogram(f, k));
+    const size_t alignment = AlignedBuffer<double>::ALIGNMENT;
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(spectrogram.data()) % alignment, 0u);
+}
+
+TEST(STFTTests, FloatStorageMatchesDouble) {
+    auto sineWave = generateSineWave(440.0, SAMPLE_RATE, 0.25);
+    Spectrogram reference = STFT(sineWave, WINDOW_SIZE, HOP_SIZE);
+    SpectrogramF single = STFT<float>(sineWave, WINDOW_SIZE, HOP_SIZE);
+
+    ASSERT_EQ(single.numFrames(), reference.numFrames());
+    ASSERT_EQ(single.numBins(), reference.numBins());
+    for (size_t f = 0; f < reference.numFrames(); f++) {
+        for (size_t k = 0; k < reference.numBins(); k++) {
+            EXPECT_NEAR(single(f, k), reference(f, k), 1e-4 * (1.0 + reference(f, k)));
+        }
+    }
+}
+
+TEST(STFTTests, ParallelMatchesSerial) {
+    auto sineWave = generateSineWave(440.0, SAMPLE_RATE, 1.0);
+    Spectrogram serial = STFT(sineWave, WINDOW_SIZE, HOP_SIZE);
+
+    ThreadPool pool(4);
+    Spectrogram parallel = STFT(sineWave, WINDOW_SIZE, HOP_SIZE, pool);
+
+    ASSERT_EQ(parallel.numFrames(), serial.numFrames());
+    ASSERT_EQ(parallel.numBins(), serial.numBins());
+    for (size_t f = 0; f < serial.numFrames(); f++) {
+        for (size_t k = 0; k < serial.numBins(); k++) {
+            ASSERT_EQ(parallel(f, k), serial(f, k));
+        }
+    }
+}
@@ -0,0 +1,59 @@
+#include <gtest/gtest.h>
+#include <cstdlib>
+#include <new>
+#include <vector>
+#include "analysisContext.h"
+#include "energyEnvelope.h"
+#include "test-helpers/analysisContext-helpers.h"
+
+// This file builds into its own executable (ScoreGen.AllocationTests): the
+// operator new below replaces the global one for the whole program.
+
+// Counts operator new calls on the current thread, so the test can check the
+// steady-state per-frame path for heap traffic.
+static thread_local size_t allocationCount = 0;
+
+void* operator new(std::size_t size) {
+    allocationCount++;
+    void* p = std::malloc(size ? size : 1);
+    if (!p) {
+        throw std::bad_alloc();
+    }
+    return p;
+}
+
+void operator delete(void* p) noexcept {
+    std::free(p);
+}
+
+void operator delete(void* p, std::size_t) noexcept {
+    std::free(p);
+}
+
+class AnalysisContextAllocationTest : public ::testing::TestWithParam<ContextCase> {};
+
+TEST_P(AnalysisContextAllocationTest, SteadyStateFramesDoNotAllocate) {
+    AnalysisContext context(SAMPLE_RATE, GetParam().options());
+    std::vector<Sample> signal = testSignal();
+    EnergyEnvelope envelope(ENERGY_ENVELOPE_RESOLUTION, PITCH_FRAME_SIZE);
+    envelope.append(signal.data(), signal.size());
+    const size_t frames = (signal.size() - PITCH_FRAME_SIZE) / PITCH_HOP_SIZE + 1;
+
+    // Warm-up: the first frames may create FFT plans and grow the arena.
+    for (size_t f = 0; f < frames; f++) {
+        context.pitchFrame(signal.data() + f * PITCH_HOP_SIZE, envelope.hannRMS(f * PITCH_HOP_SIZE));
+    }
+
+    size_t arenaAllocations = context.scratch().heapAllocations();
+    size_t before = allocationCount;
+    double sum = 0.0;
+    for (size_t f = 0; f < frames; f++) {
+        sum += context.pitchFrame(signal.data() + f * PITCH_HOP_SIZE, envelope.hannRMS(f * PITCH_HOP_SIZE));
+        sum += envelope.rms(f * PITCH_HOP_SIZE, ONSET_FRAME_SIZE);
+    }
+    EXPECT_EQ(allocationCount - before, 0u);
+    EXPECT_EQ(context.scratch().heapAllocations(), arenaAllocations);
+    EXPECT_GT(sum, 0.0);
+}
+
+INSTANTIATE_TEST_SUITE_P(Methods, AnalysisContextAllocationTest, ::testing::ValuesIn(contextCases));
@@ -0,0 +1,17 @@
+#include <gtest/gtest.h>
+#include <vector>
+#include "analysisContext.h"
+#include "test-helpers/analysisContext-helpers.h"
+
+class AnalysisContextTest : public ::testing::TestWithParam<ContextCase> {};
+
+TEST_P(AnalysisContextTest, InitialArenaFitsAFrame) {
+    AnalysisContext context(SAMPLE_RATE, GetParam().options());
+    std::vector<Sample> signal = testSignal();
+
+    size_t initial = context.scratch().heapAllocations();
+    context.pitchFrame(signal.data(), 1.0);
+    EXPECT_EQ(context.scratch().heapAllocations(), initial);
+}
+
+INSTANTIATE_TEST_SUITE_P(Methods, AnalysisContextTest, ::testing::ValuesIn(contextCases));
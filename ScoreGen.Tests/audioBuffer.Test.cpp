@@ -0,0 +1,72 @@
+#define _USE_MATH_DEFINES
+#define FP_TOL 1e-4 // 16 bit PCM round trip
+
+#include <gtest/gtest.h>
+#include <filesystem>
+#include <cmath>
+#include "audioBuffer.h"
+#include "test-helpers/test-helpers.h"
+
+TEST(AudioBufferTest, LoadsMonoFile) {
+    std::filesystem::create_directory("test-data");
+
+    SF_INFO sfinfo;
+    memset(&sfinfo, 0, sizeof(sfinfo));
+    sfinfo.channels = 1;
+    sfinfo.samplerate = 44100;
+    sfinfo.format = SF_FORMAT_WAV | SF_FORMAT_PCM_16;
+    SNDFILE* file = sf_open("test-data/mono.wav", SFM_WRITE, &sfinfo);
+    std::vector<double> sineWave = generateSineWave(440.0, sfinfo.samplerate, 1.0);
+    sf_write_double(file, sineWave.data(), sineWave.size());
+    sf_close(file);
+
+    AudioBuffer audio;
+    ASSERT_TRUE(audio.load("test-data/mono.wav"));
+    EXPECT_EQ(audio.sampleRate(), 44100);
+    EXPECT_EQ(audio.channels(), 1);
+    ASSERT_EQ(audio.size(), sineWave.size());
+    EXPECT_EQ(audio.paddedSize(), audio.size());
+    EXPECT_NEAR(audio.data()[100], sineWave[100], FP_TOL);
+    EXPECT_NEAR(audio.data()[1234], sineWave[1234], FP_TOL);
+
+    std::filesystem::remove_all("test-data");
+}
+
+TEST(AudioBufferTest, MixesStereoAndReservesSilence) {
+    std::filesystem::create_directory("test-data");
+
+    SF_INFO sfinfo;
+    memset(&sfinfo, 0, sizeof(sfinfo));
+    sfinfo.channels = 2;
+    sfinfo.samplerate = 44100;
+    sfinfo.format = SF_FORMAT_WAV | SF_FORMAT_PCM_16;
+    SNDFILE* file = sf_open("test-data/stereo.wav", SFM_WRITE, &sfinfo);
+    std::vector<double> interleaved;
+    for (int i = 0; i < 5000; i++) {
+        interleaved.push_back(0.5);
+        interleaved.push_back(-0.25);
+    }
+    sf_write_double(file, interleaved.data(), interleaved.size());
+    sf_close(file);
+
+    const size_t silence = 512;
+    AudioBuffer audio;
+    ASSERT_TRUE(audio.load("test-data/stereo.wav", silence));
+    EXPECT_EQ(audio.channels(), 2);
+    ASSERT_EQ(audio.size(), 5000u);
+    ASSERT_EQ(audio.paddedSize(), 5000u + silence);
+    EXPECT_EQ(audio.padded() + silence, audio.data());
+    for (size_t i = 0; i < silence; i++) {
+        EXPECT_EQ(audio.padded()[i], 0.0);
+    }
+    EXPECT_NEAR(audio.data()[0], 0.125, FP_TOL);
+    EXPECT_NEAR(audio.data()[4999], 0.125, FP_TOL);
+
+    std::filesystem::remove_all("test-data");
+}
+
+TEST(AudioBufferTest, LoadNonExistentFile) {
+    AudioBuffer audio;
+    EXPECT_FALSE(audio.load("fakefile.wav"));
+    EXPECT_EQ(audio.size(), 0u);
+}
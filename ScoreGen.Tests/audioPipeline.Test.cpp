@@ -0,0 +1,83 @@
+#include <gtest/gtest.h>
+#include <vector>
+#include "audioPipeline.h"
+#include "channelConverter.h"
+#include "windowProcessor.h"
+#include "normalizer.h"
+#include "hanningFunction.h"
+
+TEST(WindowProcessorTest, AppliesWindowPerFrame) {
+    std::vector<double> window = {0.0, 0.5, 1.0, 0.5};
+    std::vector<double> data(8, 2.0);
+    WindowProcessor<double> windower(window);
+    windower.process(data, data);
+
+    for (size_t i = 0; i < data.size(); i++) {
+        EXPECT_DOUBLE_EQ(data[i], 2.0 * window[i % window.size()]);
+    }
+}
+
+TEST(NormalizerTest, ScalesToPeak) {
+    std::vector<double> data = {0.1, -0.4, 0.2};
+    std::vector<double> result(data.size());
+    Normalizer<double> normalizer;
+    normalizer.process(data, result);
+
+    EXPECT_DOUBLE_EQ(result[0], 0.25);
+    EXPECT_DOUBLE_EQ(result[1], -1.0);
+    EXPECT_DOUBLE_EQ(result[2], 0.5);
+}
+
+TEST(NormalizerTest, SilenceUnchanged) {
+    std::vector<float> data(16, 0.0f);
+    Normalizer<float> normalizer;
+    normalizer.process(data, data);
+
+    for (float sample : data) {
+        EXPECT_EQ(sample, 0.0f);
+    }
+}
+
+// Stereo in, mono out: downmix, window, normalize.
+static void buildPipeline(AudioPipeline<double>& pipeline, const std::vector<double>& window) {
+    pipeline.add(std::unique_ptr<AudioProcessor<double>>(new ChannelConverter<double>(2)));
+    pipeline.add(std::unique_ptr<AudioProcessor<double>>(new WindowProcessor<double>(window)));
+    pipeline.add(std::unique_ptr<AudioProcessor<double>>(new Normalizer<double>(0.5)));
+}
+
+TEST(AudioPipelineTest, MatchesStagesRunSeparately) {
+    std::vector<double> window = hanningFunction(8);
+    std::vector<double> stereo(16);
+    for (size_t i = 0; i < stereo.size(); i++) {
+        stereo[i] = std::sin(0.3 * i);
+    }
+
+    std::vector<double> expected(8);
+    ChannelConverter<double>(2).process(stereo, expected);
+    WindowProcessor<double>(window).process(expected, expected);
+    Normalizer<double>(0.5).process(expected, expected);
+
+    AudioPipeline<double> pipeline;
+    buildPipeline(pipeline, window);
+    ASSERT_EQ(pipeline.outputSize(stereo.size()), 8u);
+    std::vector<double> result(pipeline.outputSize(stereo.size()));
+    ASSERT_EQ(pipeline.run(stereo, result), 8u);
+    for (size_t i = 0; i < result.size(); i++) {
+        EXPECT_DOUBLE_EQ(result[i], expected[i]);
+    }
+
+    // Same chain run entirely in the input buffer.
+    ASSERT_EQ(pipeline.run(stereo, stereo), 8u);
+    for (size_t i = 0; i < result.size(); i++) {
+        EXPECT_DOUBLE_EQ(stereo[i], expected[i]);
+    }
+}
+
+TEST(AudioPipelineTest, EmptyPipelineCopies) {
+    std::vector<float> data = {1.0f, 2.0f, 3.0f};
+    std::vector<float> result(3);
+    AudioPipeline<float> pipeline;
+
+    EXPECT_EQ(pipeline.run(data, result), 3u);
+    EXPECT_EQ(result, data);
+}
@@ -0,0 +1,57 @@
+#include <gtest/gtest.h>
+#include <cmath>
+#include <vector>
+#include "autocorrelation.h"
+#include "test-helpers/test-helpers.h"
+
+static void expectMatchesDirect(const std::vector<double>& frame, size_t maxLag) {
+    std::vector<double> direct(maxLag + 1), fast(maxLag + 1);
+    Autocorrelator::computeDirect(frame.data(), frame.size(), maxLag, direct.data());
+    Autocorrelator autocorrelator;
+    autocorrelator.compute(frame.data(), frame.size(), maxLag, fast.data());
+
+    for (size_t lag = 0; lag <= maxLag; lag++) {
+        EXPECT_NEAR(fast[lag], direct[lag], 1e-9 * direct[0]) << "lag " << lag;
+    }
+}
+
+TEST(AutocorrelationTest, FFTMatchesDirectForPitchFrame) {
+    std::vector<double> frame = generateSineWave(220.0, 44100.0, 2048 / 44100.0);
+    frame.resize(2048);
+    expectMatchesDirect(frame, 441);
+}
+
+TEST(AutocorrelationTest, FFTMatchesDirectForFullLagRange) {
+    std::vector<double> frame(1000);
+    for (size_t i = 0; i < frame.size(); i++) {
+        frame[i] = std::sin(0.05 * i) + 0.3 * std::sin(0.37 * i * i);
+    }
+    expectMatchesDirect(frame, frame.size() - 1);
+}
+
+TEST(AutocorrelationTest, TinyFrameUsesDirectLoop) {
+    std::vector<float> frame = {1.0f, 2.0f, 3.0f};
+    std::vector<double> out(3);
+    Autocorrelator autocorrelator;
+    autocorrelator.compute(frame.data(), frame.size(), 2, out.data());
+
+    EXPECT_DOUBLE_EQ(out[0], 14.0);
+    EXPECT_DOUBLE_EQ(out[1], 8.0);
+    EXPECT_DOUBLE_EQ(out[2], 3.0);
+}
+
+TEST(AutocorrelationTest, ReusedAcrossFrameSizes) {
+    Autocorrelator autocorrelator;
+    for (size_t size : {2048u, 512u, 4096u}) {
+        std::vector<double> frame(size);
+        for (size_t i = 0; i < size; i++) {
+            frame[i] = std::cos(0.01 * i * i);
+        }
+        std::vector<double> direct(size / 4 + 1), fast(size / 4 + 1);
+        Autocorrelator::computeDirect(frame.data(), size, size / 4, direct.data());
+        autocorrelator.compute(frame.data(), size, size / 4, fast.data());
+        for (size_t lag = 0; lag < direct.size(); lag++) {
+            EXPECT_NEAR(fast[lag], direct[lag], 1e-9 * direct[0]);
+        }
+    }
+}
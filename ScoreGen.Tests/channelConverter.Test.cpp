@@ -5,8 +5,9 @@
 TEST(ChannelConverterTest, SingleChannel) {
     std::vector<double> data = {0.5, 1.5, -2.0, 3.0};
     int channels = 1;
-    ChannelConverter converter(channels, data);
-    std::vector<double> result = converter.process();
+    ChannelConverter<double> converter(channels);
+    std::vector<double> result(converter.outputSize(data.size()));
+    ASSERT_EQ(converter.process(data, result), data.size());
 
     ASSERT_EQ(result.size(), data.size());
     for (size_t i = 0; i < result.size(); ++i) {
@@ -17,8 +18,9 @@ TEST(ChannelConverterTest, SingleChannel) {
 TEST(ChannelConverterTest, TwoChannelConversion) {
     std::vector<double> data = {1.0, 2.0, 1.1, 2.1, 1.2, 2.2};
     int channels = 2;
-    ChannelConverter converter(channels, data);
-    std::vector<double> result = converter.process();
+    ChannelConverter<double> converter(channels);
+    std::vector<double> result(converter.outputSize(data.size()));
+    converter.process(data, result);
 
     ASSERT_EQ(result.size(), data.size() / channels);
     EXPECT_DOUBLE_EQ(result[0], (data[0] + data[1]) / channels);
@@ -29,8 +31,9 @@ TEST(ChannelConverterTest, TwoChannelConversion) {
 TEST(ChannelConverterTest, ThreeChannelConversion) {
     std::vector<double> data = {1.0, 2.0, 3.0, 1.1, 2.1, 3.1};
     int channels = 3;
-    ChannelConverter converter(channels, data);
-    std::vector<double> result = converter.process();
+    ChannelConverter<double> converter(channels);
+    std::vector<double> result(converter.outputSize(data.size()));
+    converter.process(data, result);
 
     ASSERT_EQ(result.size(), data.size() / channels);
     EXPECT_DOUBLE_EQ(result[0], (data[0] + data[1] + data[2]) / channels);
@@ -40,8 +43,20 @@ TEST(ChannelConverterTest, ThreeChannelConversion) {
 TEST(ChannelConverterTest, EmptyData) {
     std::vector<double> data;
     int channels = 2;
-    ChannelConverter converter(channels, data);
-    std::vector<double> result = converter.process();
+    ChannelConverter<double> converter(channels);
+    std::vector<double> result(converter.outputSize(data.size()));
 
+    EXPECT_EQ(converter.process(data, result), 0u);
     EXPECT_TRUE(result.empty());
-}
\ No newline at end of file
+}
+
+TEST(ChannelConverterTest, InPlaceConversion) {
+    std::vector<float> data = {1.0f, 3.0f, -1.0f, -3.0f, 0.5f, 1.5f};
+    ChannelConverter<float> converter(2);
+    size_t written = converter.process(data, data);
+
+    ASSERT_EQ(written, 3u);
+    EXPECT_FLOAT_EQ(data[0], 2.0f);
+    EXPECT_FLOAT_EQ(data[1], -2.0f);
+    EXPECT_FLOAT_EQ(data[2], 1.0f);
+}
@@ -0,0 +1,61 @@
+#define _USE_MATH_DEFINES
+#include <gtest/gtest.h>
+#include <cmath>
+#include <filesystem>
+#include <stdexcept>
+#include <vector>
+#include <sndfile.h>
+#include "dsp.h"
+
+#define MELODY_FILE "Computer-Generated-Samples/D4_to_E5_1_second_per_note.wav"
+
+TEST(DSPTest, ResampledAnalysisFindsTheMelody) {
+    DSPResult native = dsp(MELODY_FILE);
+    DSPResult resampled = dsp(MELODY_FILE, false, false, 16000);
+    // The opening notes are clean one-second steps (D4, D#4, E4, F4).
+    ASSERT_GE(native.XMLNotes.size(), 4u);
+    ASSERT_GE(resampled.XMLNotes.size(), 4u);
+    for (size_t i = 0; i < 4; i++) {
+        EXPECT_EQ(resampled.XMLNotes[i].midi, native.XMLNotes[i].midi) << i;
+        EXPECT_EQ(resampled.XMLNotes[i].duration, native.XMLNotes[i].duration) << i;
+    }
+}
+
+TEST(DSPTest, RejectsAnalysisRatesTooLowToFrame) {
+    EXPECT_THROW(dsp(MELODY_FILE, false, false, MIN_ANALYSIS_RATE - 1), std::invalid_argument);
+    EXPECT_THROW(dsp(MELODY_FILE, false, false, -16000), std::invalid_argument);
+}
+
+// Four half-second notes (A4, B4, C#5, D5): too short for the tempogram,
+// which needs two of its slowest beats, so the tempo has to come from the
+// fallback.
+TEST(DSPTest, TwoSecondMelodyStillGetsATempo) {
+    const int sampleRate = 44100;
+    const double frequencies[] = {440.0, 493.88, 554.37, 587.33};
+    std::vector<double> melody;
+    for (double frequency : frequencies) {
+        for (int i = 0; i < sampleRate / 2; i++) {
+            double envelope = std::min(1.0, (sampleRate / 2 - i) / (0.02 * sampleRate));
+            melody.push_back(0.5 * envelope * std::sin(2.0 * M_PI * frequency * i / sampleRate));
+        }
+    }
+
+    std::filesystem::create_directory("test-data");
+    SF_INFO info = {};
+    info.channels = 1;
+    info.samplerate = sampleRate;
+    info.format = SF_FORMAT_WAV | SF_FORMAT_PCM_16;
+    SNDFILE* file = sf_open("test-data/short-melody.wav", SFM_WRITE, &info);
+    ASSERT_NE(file, nullptr);
+    sf_writef_double(file, melody.data(), melody.size());
+    sf_close(file);
+
+    for (bool streaming : {false, true}) {
+        DSPResult result = dsp("test-data/short-melody.wav", streaming);
+        ASSERT_FALSE(result.XMLNotes.empty()) << streaming;
+        for (const XMLNote& note : result.XMLNotes) {
+            EXPECT_GT(note.duration, 0) << streaming;
+        }
+    }
+    std::filesystem::remove_all("test-data");
+}
@@ -0,0 +1,100 @@
+#include <gtest/gtest.h>
+#include <cmath>
+#include <random>
+#include <stdexcept>
+#include <vector>
+#include "energyEnvelope.h"
+#include "hanningFunction.h"
+
+static std::vector<Sample> noise(size_t size, float amplitude, unsigned seed = 7) {
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<float> dist(-amplitude, amplitude);
+    std::vector<Sample> signal(size);
+    for (Sample& x : signal) {
+        x = dist(rng);
+    }
+    return signal;
+}
+
+static double directEnergy(const std::vector<Sample>& signal, size_t start, size_t length) {
+    double sum = 0.0;
+    for (size_t i = start; i < start + length; i++) {
+        sum += static_cast<double>(signal[i]) * signal[i];
+    }
+    return sum;
+}
+
+TEST(EnergyEnvelopeTest, MatchesDirectSums) {
+    std::vector<Sample> signal = noise(20000, 0.8f);
+    EnergyEnvelope envelope;
+    envelope.append(signal.data(), signal.size());
+
+    for (size_t length : {256u, 512u, 2048u}) {
+        for (size_t start = 0; start + length <= signal.size(); start += 768) {
+            double expected = directEnergy(signal, start, length);
+            EXPECT_NEAR(envelope.energy(start, length), expected, 1e-12 * expected);
+            EXPECT_NEAR(envelope.rms(start, length), std::sqrt(expected / length), 1e-12);
+        }
+    }
+}
+
+TEST(EnergyEnvelopeTest, HannEnergyMatchesWindowedFrame) {
+    const size_t frameSize = 2048;
+    std::vector<Sample> signal = noise(30000, 0.5f);
+    EnergyEnvelope envelope(ENERGY_ENVELOPE_RESOLUTION, frameSize);
+    envelope.append(signal.data(), signal.size());
+    std::vector<double> window = hanningFunction(frameSize);
+
+    for (size_t start = 0; start + frameSize <= signal.size(); start += 512) {
+        double expected = 0.0;
+        for (size_t n = 0; n < frameSize; n++) {
+            double x = signal[start + n] * window[n];
+            expected += x * x;
+        }
+        EXPECT_NEAR(envelope.hannEnergy(start), expected, 1e-9 * expected) << "frame at " << start;
+    }
+}
+
+TEST(EnergyEnvelopeTest, BlockedAppendMatchesWhole) {
+    std::vector<Sample> signal = noise(10000, 1.0f);
+    EnergyEnvelope whole(ENERGY_ENVELOPE_RESOLUTION, 2048);
+    whole.append(signal.data(), signal.size());
+
+    EnergyEnvelope blocked(ENERGY_ENVELOPE_RESOLUTION, 2048);
+    for (size_t i = 0; i < signal.size(); i += 333) {
+        blocked.append(signal.data() + i, std::min<size_t>(333, signal.size() - i));
+    }
+    ASSERT_EQ(blocked.size(), whole.size());
+    for (size_t start = 0; start + 2048 <= signal.size(); start += 512) {
+        EXPECT_EQ(blocked.hannEnergy(start), whole.hannEnergy(start));
+        EXPECT_EQ(blocked.energy(start, 512), whole.energy(start, 512));
+    }
+}
+
+TEST(EnergyEnvelopeTest, KeepsPrecisionAfterLongLoudSignal) {
+    // Ten million loud samples, then a quiet stretch: the quiet window's
+    // energy is a tiny difference of two large totals.
+    std::vector<Sample> signal = noise(10240000, 1.0f);
+    std::vector<Sample> quiet = noise(4096, 1e-3f, 11);
+    signal.insert(signal.end(), quiet.begin(), quiet.end());
+
+    EnergyEnvelope envelope;
+    envelope.append(signal.data(), signal.size());
+    size_t start = 10240000;
+    double expected = directEnergy(signal, start, 2048);
+    EXPECT_NEAR(envelope.energy(start, 2048), expected, 1e-6 * expected);
+}
+
+TEST(EnergyEnvelopeTest, RejectsUnavailableWindows) {
+    std::vector<Sample> signal = noise(4096, 1.0f);
+    EnergyEnvelope envelope;
+    envelope.append(signal.data(), signal.size());
+
+    EXPECT_THROW(envelope.energy(100, 256), std::out_of_range);  // off the resolution
+    EXPECT_THROW(envelope.energy(3840, 512), std::out_of_range); // past the end
+    EXPECT_THROW(envelope.hannEnergy(0), std::logic_error);      // no Hann length
+
+    envelope.discardBefore(1024);
+    EXPECT_THROW(envelope.energy(512, 512), std::out_of_range);
+    EXPECT_NEAR(envelope.energy(1024, 512), directEnergy(signal, 1024, 512), 1e-9);
+}
@@ -0,0 +1,70 @@
+#define _USE_MATH_DEFINES
+#include <gtest/gtest.h>
+#include <cmath>
+#include <cstdio>
+#include <vector>
+#include <filesystem>
+#include "fftPlanCache.h"
+
+TEST(FFTPlanCacheTest, ReusesPlanForSameSize) {
+    FFTPlanCache& cache = FFTPlanCache::instance();
+    EXPECT_EQ(cache.forward(256), cache.forward(256));
+    EXPECT_NE(cache.forward(256), cache.forward(512));
+    EXPECT_NE(cache.forward(256), cache.inverse(256));
+}
+
+TEST(FFTPlanCacheTest, ForwardMatchesDirectDFT) {
+    const int size = 64;
+    double* in = fftw_alloc_real(size);
+    fftw_complex* out = fftw_alloc_complex(size / 2 + 1);
+    for (int i = 0; i < size; i++) {
+        in[i] = std::sin(2 * M_PI * 5 * i / size) + 0.25 * std::cos(2 * M_PI * 12 * i / size);
+    }
+    fftw_execute_dft_r2c(FFTPlanCache::instance().forward(size), in, out);
+
+    for (int k = 0; k < size / 2 + 1; k++) {
+        double re = 0.0, im = 0.0;
+        for (int n = 0; n < size; n++) {
+            re += in[n] * std::cos(2 * M_PI * k * n / size);
+            im -= in[n] * std::sin(2 * M_PI * k * n / size);
+        }
+        EXPECT_NEAR(out[k][0], re, 1e-9) << "bin " << k;
+        EXPECT_NEAR(out[k][1], im, 1e-9) << "bin " << k;
+    }
+    fftw_free(in);
+    fftw_free(out);
+}
+
+TEST(FFTPlanCacheTest, InverseRoundTrip) {
+    const int size = 128;
+    double* in = fftw_alloc_real(size);
+    double* result = fftw_alloc_real(size);
+    fftw_complex* spectrum = fftw_alloc_complex(size / 2 + 1);
+    for (int i = 0; i < size; i++) {
+        in[i] = std::sin(0.1 * i * i);
+    }
+    FFTPlanCache& cache = FFTPlanCache::instance();
+    fftw_execute_dft_r2c(cache.forward(size), in, spectrum);
+    fftw_execute_dft_c2r(cache.inverse(size), spectrum, result);
+
+    for (int i = 0; i < size; i++) {
+        EXPECT_NEAR(result[i] / size, in[i], 1e-9);
+    }
+    fftw_free(in);
+    fftw_free(result);
+    fftw_free(spectrum);
+}
+
+TEST(FFTPlanCacheTest, WisdomRoundTrip) {
+    std::filesystem::create_directory("test-data");
+    const char* path = "test-data/fftw.wisdom";
+    FFTPlanCache& cache = FFTPlanCache::instance();
+    cache.forward(1000); // a size no other test plans, so there is new wisdom to save
+    ASSERT_TRUE(cache.saveWisdom(path));
+    EXPECT_TRUE(cache.loadWisdom(path));
+    std::remove(path);
+}
+
+TEST(FFTPlanCacheTest, LoadMissingWisdom) {
+    EXPECT_FALSE(FFTPlanCache::instance().loadWisdom("fakefile.wisdom"));
+}
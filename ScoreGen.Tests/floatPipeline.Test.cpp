@@ -0,0 +1,111 @@
+#include <gtest/gtest.h>
+#include <vector>
+#include <cstring>
+#include <sndfile.h>
+#include "audioBuffer.h"
+#include "note_duration_extractor.h"
+#include "determineBPM.h"
+#include "hanningFunction.h"
+
+// The analysis chain runs on single-precision samples. These checks compare
+// it against the double-precision path it replaced on the testing datasets.
+
+static std::vector<double> loadMonoDouble(const char* filename, int& sampleRate) {
+    SF_INFO sfinfo;
+    memset(&sfinfo, 0, sizeof(sfinfo));
+    SNDFILE* file = sf_open(filename, SFM_READ, &sfinfo);
+    if (!file) {
+        throw std::runtime_error("Could not open audio file");
+    }
+    std::vector<double> interleaved(sfinfo.frames * sfinfo.channels);
+    sf_readf_double(file, interleaved.data(), sfinfo.frames);
+    sf_close(file);
+
+    std::vector<double> mono(sfinfo.frames);
+    for (sf_count_t i = 0; i < sfinfo.frames; i++) {
+        double sum = 0.0;
+        for (int ch = 0; ch < sfinfo.channels; ch++) {
+            sum += interleaved[i * sfinfo.channels + ch];
+        }
+        mono[i] = sum / sfinfo.channels;
+    }
+    sampleRate = sfinfo.samplerate;
+    return mono;
+}
+
+// Double-precision pitch pass as it was before the switch to Sample.
+static std::vector<double> referencePitchEstimates(const std::vector<double>& audio, int sampleRate) {
+    std::vector<double> window = hanningFunction(PITCH_FRAME_SIZE);
+    std::vector<double> frame(PITCH_FRAME_SIZE);
+    std::vector<double> estimates;
+    for (size_t start = 0; start + PITCH_FRAME_SIZE <= audio.size(); start += PITCH_HOP_SIZE) {
+        double sumSq = 0.0;
+        for (int n = 0; n < PITCH_FRAME_SIZE; n++) {
+            frame[n] = audio[start + n] * window[n];
+            sumSq += frame[n] * frame[n];
+        }
+        if (std::sqrt(sumSq / PITCH_FRAME_SIZE) < 0.001) {
+            estimates.push_back(0.0);
+            continue;
+        }
+
+        const int N = PITCH_FRAME_SIZE;
+        double r0 = sumSq;
+        if (r0 < 1e-6) {
+            estimates.push_back(0.0);
+            continue;
+        }
+        int maxLag = std::min(N - 1, static_cast<int>(sampleRate / 100.0));
+        int minLag = std::max(1, static_cast<int>(sampleRate / 2000.0));
+        double bestCorr = 0.0;
+        int bestLag = 0;
+        for (int lag = minLag; lag <= maxLag; lag++) {
+            double sum = 0.0;
+            for (int i = 0; i < N - lag; i++) {
+                sum += frame[i] * frame[i + lag];
+            }
+            if (sum / r0 > bestCorr) {
+                bestCorr = sum / r0;
+                bestLag = lag;
+            }
+        }
+        estimates.push_back(bestCorr < 0.5 ? 0.0 : sampleRate / static_cast<double>(bestLag));
+    }
+    return estimates;
+}
+
+class FloatPipelineTest : public ::testing::TestWithParam<const char*> {};
+
+TEST_P(FloatPipelineTest, PitchMatchesDoublePath) {
+    int sampleRate = 0;
+    std::vector<double> signal = loadMonoDouble(GetParam(), sampleRate);
+    std::vector<double> reference = referencePitchEstimates(signal, sampleRate);
+
+    AudioBuffer audio;
+    ASSERT_TRUE(audio.load(GetParam()));
+    FrameAnalysis analysis = analyzeFrames(audio.data(), audio.size(), audio.sampleRate());
+
+    ASSERT_EQ(analysis.pitchEstimates.size(), reference.size());
+    for (size_t i = 0; i < reference.size(); i++) {
+        EXPECT_DOUBLE_EQ(analysis.pitchEstimates[i], reference[i]) << "frame " << i;
+    }
+}
+
+TEST_P(FloatPipelineTest, BPMMatchesDoublePath) {
+    int sampleRate = 0;
+    std::vector<double> reference = loadMonoDouble(GetParam(), sampleRate);
+
+    AudioBuffer audio;
+    ASSERT_TRUE(audio.load(GetParam()));
+    EXPECT_FLOAT_EQ(getBufferBPM(audio.data(), audio.size(), audio.sampleRate()),
+                    getBufferBPM(reference, sampleRate));
+}
+
+INSTANTIATE_TEST_SUITE_P(TestingDatasets, FloatPipelineTest, ::testing::Values(
+    "Computer-Generated-Samples/D4_to_E5_1_second_per_note.wav",
+    "Computer-Generated-Samples/D4_to_E5_1_second_per_note_half_second_rest.wav",
+    "piano-samples/sample-scales/c-major-scale-on-treble-clef.wav",
+    "piano-samples/sample-scales/c-major-scale-on-bass-clef.wav",
+    "piano-samples/other/piano-c4-major-scale.wav",
+    "piano-samples/sample-chords/piano-chord-progression1.wav"
+));
@@ -0,0 +1,111 @@
+#include <gtest/gtest.h>
+#include <stdexcept>
+#include <vector>
+#include "frameDriver.h"
+
+// Records the start of every frame it is given and checks the frame's
+// samples against the ramp signal below.
+class RecordingConsumer : public FrameConsumer {
+public:
+    RecordingConsumer(size_t frameSize, size_t hopSize) : flushed(-1), frameSize_(frameSize), hopSize_(hopSize) {}
+
+    size_t frameSize() const override { return frameSize_; }
+    size_t hopSize() const override { return hopSize_; }
+
+    void consume(const Sample* frame, size_t start) override {
+        starts.push_back(start);
+        for (size_t i = 0; i < frameSize_; i++) {
+            if (frame[i] != static_cast<Sample>(start + i)) {
+                mismatches++;
+            }
+        }
+    }
+
+    void flush(const Sample* rest, size_t size) override {
+        flushed = static_cast<long>(size);
+        size_t start = starts.empty() ? 0 : starts.back() + hopSize_;
+        for (size_t i = 0; i < size; i++) {
+            if (rest[i] != static_cast<Sample>(start + i)) {
+                mismatches++;
+            }
+        }
+    }
+
+    std::vector<size_t> starts;
+    size_t mismatches = 0;
+    long flushed;
+
+private:
+    size_t frameSize_;
+    size_t hopSize_;
+};
+
+static std::vector<Sample> ramp(size_t size) {
+    std::vector<Sample> signal(size);
+    for (size_t i = 0; i < size; i++) {
+        signal[i] = static_cast<Sample>(i);
+    }
+    return signal;
+}
+
+class FrameDriverTest : public ::testing::TestWithParam<size_t> {};
+
+TEST_P(FrameDriverTest, EveryConsumerSeesItsOwnFrames) {
+    const size_t size = 20000;
+    std::vector<Sample> signal = ramp(size);
+    std::vector<RecordingConsumer> consumers = {
+        RecordingConsumer(2048, 512),
+        RecordingConsumer(512, 256),
+        RecordingConsumer(1000, 1000),
+        RecordingConsumer(300, 700) // hop longer than the frame
+    };
+    FrameDriver driver;
+    for (RecordingConsumer& consumer : consumers) {
+        driver.add(consumer);
+    }
+    for (size_t i = 0; i < size; i += GetParam()) {
+        driver.push(signal.data() + i, std::min(GetParam(), size - i));
+    }
+    driver.finish();
+    EXPECT_EQ(driver.size(), size);
+
+    for (RecordingConsumer& consumer : consumers) {
+        const size_t frameSize = consumer.frameSize();
+        const size_t hopSize = consumer.hopSize();
+        const size_t expectedFrames = (size - frameSize) / hopSize + 1;
+        ASSERT_EQ(consumer.starts.size(), expectedFrames) << "frame size " << frameSize;
+        for (size_t f = 0; f < expectedFrames; f++) {
+            EXPECT_EQ(consumer.starts[f], f * hopSize);
+        }
+        EXPECT_EQ(consumer.mismatches, 0u) << "frame size " << frameSize;
+        size_t next = expectedFrames * hopSize;
+        EXPECT_EQ(consumer.flushed, static_cast<long>(next < size ? size - next : 0));
+    }
+}
+
+INSTANTIATE_TEST_SUITE_P(BlockSizes, FrameDriverTest,
+    ::testing::Values(1, 7, 300, 2048, 8191, 20000));
+
+TEST(FrameDriverTest, ShortSignalIsOnlyFlushed) {
+    std::vector<Sample> signal = ramp(100);
+    RecordingConsumer consumer(256, 128);
+    FrameDriver driver;
+    driver.add(consumer);
+    driver.push(signal.data(), signal.size());
+    driver.finish();
+    EXPECT_TRUE(consumer.starts.empty());
+    EXPECT_EQ(consumer.flushed, 100);
+    EXPECT_EQ(consumer.mismatches, 0u);
+}
+
+TEST(FrameDriverTest, ConsumersMustBeAddedBeforePushing) {
+    std::vector<Sample> signal = ramp(10);
+    RecordingConsumer first(4, 4);
+    RecordingConsumer late(4, 4);
+    FrameDriver driver;
+    driver.add(first);
+    driver.push(signal.data(), signal.size());
+    EXPECT_THROW(driver.add(late), std::logic_error);
+    driver.finish();
+    EXPECT_THROW(driver.push(signal.data(), signal.size()), std::logic_error);
+}
@@ -68,18 +68,18 @@ protected:
 };
 
 TEST_F(MusicXMLGeneratorTest, NoteElementCreation) {
-    // Quarter note at C, not flat/sharp, octave 4, duration 4 divisions, not a rest
-    XMLNote regularNote = {"C", 0, 4, 4, "quarter", false};
+    // Quarter note at C4 (MIDI 60), not flat/sharp, duration 4 divisions
+    XMLNote regularNote = {60, 0, 4, "quarter"};
     TElement regularNoteElement = testCreateNoteElement(regularNote, 4, 4);
     EXPECT_NE(regularNoteElement, nullptr);
 
     // Rest note with all fields
-    XMLNote restNote = {"", 0, 0, 4, "quarter", true};
+    XMLNote restNote = {REST_MIDI, 0, 4, "quarter"};
     TElement restNoteElement = testCreateNoteElement(restNote, 4, 4);
     EXPECT_NE(restNoteElement, nullptr);
 
     // Note with accidental (C-sharp)
-    XMLNote accidentalNote = {"C", 1, 4, 4, "quarter", false};
+    XMLNote accidentalNote = {61, 1, 4, "quarter"};
     TElement accidentalNoteElement = testCreateNoteElement(accidentalNote, 4, 4);
     EXPECT_NE(accidentalNoteElement, nullptr);
 }
@@ -94,14 +94,14 @@ TEST_F(MusicXMLGeneratorTest, MeasureCreation) {
 TEST_F(MusicXMLGeneratorTest, PartCreation) {
     // Multiple measures with various notes
     vector<XMLNote> noteSequence = {
-        {"C", 0, 4, 4, "quarter", false},
-        {"D", 0, 4, 4, "quarter", false},
-        {"E", 0, 4, 4, "quarter", false},
-        {"F", 0, 4, 4, "quarter", false},
-        {"G", 1, 4, 4, "quarter", false},
-        {"", 0, 0, 8, "half", true},
-        {"A", 0, 4, 4, "quarter", false},
-        {"B", -1, 4, 4, "quarter", false}
+        {60, 0, 4, "quarter"},
+        {62, 0, 4, "quarter"},
+        {64, 0, 4, "quarter"},
+        {65, 0, 4, "quarter"},
+        {68, 1, 4, "quarter"},
+        {REST_MIDI, 0, 8, "half"},
+        {69, 0, 4, "quarter"},
+        {70, -1, 4, "quarter"}
     };
 
     TElement part = testCreatePart(noteSequence);
@@ -119,32 +119,32 @@ TEST_F(MusicXMLGeneratorTest, AllNoteTypes) {}
 TEST_F(MusicXMLGeneratorTest, FullGeneration) {
     vector<XMLNote> noteSequence = {
         // Measure 1: Standard notes and a double-sharp
-        {"C", 0, 4, 4, "quarter", false},
-        {"D", 1, 4, 4, "quarter", false},   // D-sharp
-        {"E", 0, 4, 4, "quarter", false},
-        {"F", 2, 4, 4, "quarter", false},     // F double-sharp
+        {60, 0, 4, "quarter"},
+        {63, 1, 4, "quarter"},   // D-sharp
+        {64, 0, 4, "quarter"},
+        {67, 2, 4, "quarter"},     // F double-sharp
 
         // Measure 2: Double-flat and missing type for a non-rest note
-        {"G", -2, 4, 4, "quarter", false},    // G double-flat
-        {"A", 0, 4, 4, "", false},            // A note with missing type
-        {"B", -1, 4, 4, "quarter", false},    // B-flat
-        {"C", 0, 5, 4, "quarter", false},     // C in octave 5
+        {65, -2, 4, "quarter"},    // G double-flat
+        {69, 0, 4, ""},            // A note with missing type
+        {70, -1, 4, "quarter"},    // B-flat
+        {72, 0, 4, "quarter"},     // C in octave 5
 
         // Measure 3: Different durations and accidentals
-        {"D", 0, 5, 8, "half", false},        // Half note
-        {"E", -1, 5, 2, "eighth", false},     // E-flat eighth note
-        {"F", 0, 5, 4, "quarter", false},
-        {"G", 0, 5, 4, "quarter", false},
+        {74, 0, 8, "half"},        // Half note
+        {75, -1, 2, "eighth"},     // E-flat eighth note
+        {77, 0, 4, "quarter"},
+        {79, 0, 4, "quarter"},
 
         // Measure 4: Rests with and without note type
-        {"", 0, 0, 4, "quarter", true},       // Quarter rest with type specified
-        {"", 0, 0, 8, "", true},              // Half rest without type
-        {"A", 0, 5, 4, "quarter", false},     // Normal note after rests
-        {"B", 0, 5, 4, "quarter", false},
+        {REST_MIDI, 0, 4, "quarter"},       // Quarter rest with type specified
+        {REST_MIDI, 0, 8, ""},              // Half rest without type
+        {81, 0, 4, "quarter"},     // Normal note after rests
+        {83, 0, 4, "quarter"},
 
         // Measure 5: Extreme octave values
-        {"C", 0, 2, 4, "quarter", false},     // Lower octave note
-        {"D", 1, 7, 4, "quarter", false}      // Higher octave with sharp
+        {36, 0, 4, "quarter"},     // Lower octave note
+        {99, 1, 4, "quarter"}      // Higher octave with sharp
     };
 
     const char *filename = "full_generation_test.musicxml";
@@ -178,3 +178,32 @@ TEST_F(MusicXMLGeneratorTest, EmptySequenceGeneration) {
         4
     ));
 }
+
+TEST_F(MusicXMLGeneratorTest, ChordGeneration) {
+    XMLNote root = {62, 0, 8, "half"};
+    XMLNote third = {65, 0, 8, "half"};
+    third.chord = true;
+    XMLNote fifth = {69, 0, 8, "half"};
+    fifth.chord = true;
+    vector<XMLNote> noteSequence = {
+        {60, 0, 12, "dotted half"},
+        root, third, fifth, // crosses the barline: split and tied as a chord
+        {64, 0, 4, "quarter"}
+    };
+
+    const char *filename = "chord_generation_test.musicxml";
+    EXPECT_TRUE(generator.generate(filename, noteSequence, "G", 2, 0, 4));
+
+    std::ifstream outputFile(filename);
+    ASSERT_TRUE(outputFile.good());
+    std::string content((std::istreambuf_iterator<char>(outputFile)), std::istreambuf_iterator<char>());
+    outputFile.close();
+    std::remove(filename);
+
+    // Two chord tones in each half of the split chord.
+    size_t chords = 0;
+    for (size_t pos = content.find("<chord/>"); pos != std::string::npos; pos = content.find("<chord/>", pos + 1)) {
+        chords++;
+    }
+    EXPECT_EQ(chords, 4u);
+}
@@ -56,9 +56,9 @@ TEST(SineWaveTest, HighFrequency) {
 TEST(FundamentalFrequencyTest, SingleFramePeak) {
     int numBins = WINDOW_SIZE / 2 + 1;
     int maxBin = 100;
-    std::vector<std::vector<double>> spectrogram(1, std::vector<double>(numBins, 0.0));
+    Spectrogram spectrogram(1, numBins);
     
-    spectrogram[0][maxBin] = 1.0;
+    spectrogram(0, maxBin) = 1.0;
     
     float resolution = SAMPLE_RATE / (numBins * 2 - 1);
     float expectedFrequency = resolution * maxBin;
@@ -70,10 +70,10 @@ TEST(FundamentalFrequencyTest, SingleFramePeak) {
 
 TEST(FundamentalFrequencyTest, MultiFrameCompetingPeaks) {
     int numBins = WINDOW_SIZE / 2 + 1;
-    std::vector<std::vector<double>> spectrogram(2, std::vector<double>(numBins, 0.0));
+    Spectrogram spectrogram(2, numBins);
     
-    spectrogram[0][50] = 1.0;
-    spectrogram[1][75] = 2.0;
+    spectrogram(0, 50) = 1.0;
+    spectrogram(1, 75) = 2.0;
     
     float freqResolution = SAMPLE_RATE / (numBins * 2 - 1);
     float expectedFrequency = freqResolution * 75;
@@ -83,7 +83,7 @@ TEST(FundamentalFrequencyTest, MultiFrameCompetingPeaks) {
 }
 
 TEST(FundamentalFrequencyTest, EmptySpectrogram) {
-    std::vector<std::vector<double>> emptySpectrogram;
+    Spectrogram emptySpectrogram;
     
     float frequency = extractFundamentalFrequency(emptySpectrogram, SAMPLE_RATE);
     EXPECT_EQ(frequency, 0.0f);
@@ -93,9 +93,9 @@ TEST(FundamentalFrequencyTest, DifferentSampleRate) {
     int numBins = 1024;
     int maxBin = 100;
     double sampleRate = 16000.0;
-    std::vector<std::vector<double>> spectrogram(1, std::vector<double>(numBins, 0.0));
+    Spectrogram spectrogram(1, numBins);
     
-    spectrogram[0][maxBin] = 1.0;
+    spectrogram(0, maxBin) = 1.0;
     
     float resolution = sampleRate / (numBins * 2 - 1);
     float expectedFrequency = resolution * maxBin;
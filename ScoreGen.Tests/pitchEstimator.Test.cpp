@@ -0,0 +1,151 @@
+#define _USE_MATH_DEFINES
+#include <gtest/gtest.h>
+#include <cmath>
+#include <cstdint>
+#include <stdexcept>
+#include <vector>
+#include "pitchEstimator.h"
+#include "pitchSpelling.h"
+#include "note_duration_extractor.h"
+#include "audioBuffer.h"
+
+#define SAMPLE_RATE 44100
+
+// A piano-like tone: a fundamental with decaying harmonics.
+static std::vector<Sample> harmonicTone(double frequency, size_t size) {
+    std::vector<Sample> tone(size);
+    for (size_t i = 0; i < size; i++) {
+        double t = i / static_cast<double>(SAMPLE_RATE);
+        double value = 0.0;
+        for (int h = 1; h <= 4; h++) {
+            value += std::sin(2.0 * M_PI * frequency * h * t) / h;
+        }
+        tone[i] = static_cast<Sample>(0.3 * value);
+    }
+    return tone;
+}
+
+static double semitonesBetween(double a, double b) {
+    return std::abs(12.0 * std::log2(a / b));
+}
+
+struct EstimatorCase {
+    PitchMethod method;
+    bool earlyTermination;
+};
+
+class PitchEstimatorTest : public ::testing::TestWithParam<EstimatorCase> {
+protected:
+    std::unique_ptr<PitchEstimator> make() const {
+        PitchOptions options = defaultPitchOptions(GetParam().method);
+        options.earlyTermination = GetParam().earlyTermination;
+        return makePitchEstimator(options);
+    }
+};
+
+TEST_P(PitchEstimatorTest, TracksPianoRangeTones) {
+    auto estimator = make();
+    for (double frequency : {32.70, 65.41, 110.0, 261.63, 440.0, 1046.5, 2093.0}) {
+        std::vector<Sample> tone = harmonicTone(frequency, PITCH_FRAME_SIZE);
+        double estimate = estimator->estimate(tone.data(), tone.size(), SAMPLE_RATE);
+        EXPECT_LT(semitonesBetween(estimate, frequency), 0.1) << frequency << " Hz -> " << estimate;
+    }
+}
+
+TEST_P(PitchEstimatorTest, SilenceIsUnvoiced) {
+    auto estimator = make();
+    std::vector<Sample> silence(PITCH_FRAME_SIZE, 0.0f);
+    EXPECT_EQ(estimator->estimate(silence.data(), silence.size(), SAMPLE_RATE), 0.0);
+}
+
+INSTANTIATE_TEST_SUITE_P(Methods, PitchEstimatorTest, ::testing::Values(
+    EstimatorCase{PitchMethod::YIN, true},
+    EstimatorCase{PitchMethod::YIN, false},
+    EstimatorCase{PitchMethod::MPM, true},
+    EstimatorCase{PitchMethod::MPM, false}
+));
+
+TEST(PitchEstimatorTest, EarlyTerminationMatchesFFTPath) {
+    for (PitchMethod method : {PitchMethod::YIN, PitchMethod::MPM}) {
+        PitchOptions options = defaultPitchOptions(method);
+        auto early = makePitchEstimator(options);
+        options.earlyTermination = false;
+        auto full = makePitchEstimator(options);
+
+        for (double frequency : {49.0, 155.56, 587.33}) {
+            std::vector<Sample> tone = harmonicTone(frequency, PITCH_FRAME_SIZE);
+            EXPECT_NEAR(early->estimate(tone.data(), tone.size(), SAMPLE_RATE),
+                        full->estimate(tone.data(), tone.size(), SAMPLE_RATE), 1e-3 * frequency);
+        }
+    }
+}
+
+TEST(PitchEstimatorTest, MPMEarlyTerminationUsesRelativeThreshold) {
+    // 441 Hz (a 100-sample period) with a quiet subharmonic and some noise:
+    // clarity is about 0.90 at the true period and 0.96 at twice it. 0.90 is
+    // below the 0.93 threshold but within 0.93 of the best, so both paths
+    // must keep the true period rather than drop an octave.
+    std::vector<Sample> frame(PITCH_FRAME_SIZE);
+    uint32_t seed = 12345;
+    for (size_t i = 0; i < frame.size(); i++) {
+        seed = (seed * 1103515245u + 12345u) & 0x7fffffffu;
+        double noise = 2.0 * seed / 2147483648.0 - 1.0;
+        frame[i] = static_cast<Sample>(std::sin(2.0 * M_PI * i / 100.0) + 0.18 * std::sin(M_PI * i / 100.0) + 0.25 * noise);
+    }
+
+    PitchOptions options = defaultPitchOptions(PitchMethod::MPM);
+    auto early = makePitchEstimator(options);
+    options.earlyTermination = false;
+    auto full = makePitchEstimator(options);
+    EXPECT_NEAR(early->estimate(frame.data(), frame.size(), SAMPLE_RATE), 441.0, 2.0);
+    EXPECT_NEAR(full->estimate(frame.data(), frame.size(), SAMPLE_RATE), 441.0, 2.0);
+}
+
+TEST(PitchEstimatorTest, AutocorrelationKeepsItsSearchRange) {
+    // The original detector does not look below 100 Hz.
+    AutocorrelationPitchEstimator estimator;
+    std::vector<Sample> tone = harmonicTone(440.0, PITCH_FRAME_SIZE);
+    EXPECT_NEAR(estimator.estimate(tone.data(), tone.size(), SAMPLE_RATE), 440.0, 1.0);
+    EXPECT_TRUE(estimator.windowed());
+
+    std::vector<Sample> low = harmonicTone(32.70, PITCH_FRAME_SIZE);
+    EXPECT_GT(semitonesBetween(estimator.estimate(low.data(), low.size(), SAMPLE_RATE), 32.70), 1.0);
+}
+
+TEST(PitchEstimatorTest, LowPianoScaleStartsOnC1) {
+    AudioBuffer audio;
+    ASSERT_TRUE(audio.load("piano-samples/other/piano-c1-major-scale.wav"));
+
+    for (PitchMethod method : {PitchMethod::YIN, PitchMethod::MPM}) {
+        FrameAnalysis analysis = analyzeFrames(audio.data(), audio.size(), audio.sampleRate(),
+                                               defaultPitchOptions(method));
+        // The first note is held through these frames.
+        ASSERT_GT(analysis.pitchEstimates.size(), 100u);
+        EXPECT_LT(semitonesBetween(analysis.pitchEstimates[86], 32.70), 0.5);
+    }
+}
+
+TEST(PitchEstimatorTest, CoarseToFineMatchesFullSearch) {
+    AutocorrelationPitchEstimator full;
+    for (int decimation : {2, 4}) {
+        PitchOptions options;
+        options.decimation = decimation;
+        AutocorrelationPitchEstimator coarse(options);
+        for (double frequency : {110.0, 293.66, 440.0, 659.26, 1046.5, 1975.5}) {
+            std::vector<Sample> tone = harmonicTone(frequency, PITCH_FRAME_SIZE);
+            double expected = full.estimate(tone.data(), tone.size(), SAMPLE_RATE);
+            double estimate = coarse.estimate(tone.data(), tone.size(), SAMPLE_RATE);
+            // The full search reports whole lags, so compare notes.
+            EXPECT_EQ(frequencyToMidi(estimate), frequencyToMidi(expected))
+                << decimation << "x, " << frequency << " Hz -> " << estimate;
+        }
+        std::vector<Sample> silence(PITCH_FRAME_SIZE, 0.0f);
+        EXPECT_EQ(coarse.estimate(silence.data(), silence.size(), SAMPLE_RATE), 0.0);
+    }
+}
+
+TEST(PitchEstimatorTest, DecimationMustBePositive) {
+    PitchOptions options;
+    options.decimation = 0;
+    EXPECT_THROW(AutocorrelationPitchEstimator estimator(options), std::invalid_argument);
+}
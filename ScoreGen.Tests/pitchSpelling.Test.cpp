@@ -0,0 +1,73 @@
+#include <gtest/gtest.h>
+#include <stdexcept>
+#include <string>
+#include "pitchSpelling.h"
+#include "dsp.h"
+
+TEST(PitchSpellingTest, FrequencyToMidi) {
+    EXPECT_EQ(frequencyToMidi(440.0), 69);
+    EXPECT_EQ(frequencyToMidi(261.63), 60);
+    EXPECT_EQ(frequencyToMidi(27.5), 21);
+    EXPECT_EQ(frequencyToMidi(452.0), 69); // within half a semitone of A4
+    EXPECT_EQ(frequencyToMidi(0.0), REST_MIDI);
+}
+
+TEST(PitchSpellingTest, NoteNames) {
+    EXPECT_EQ(midiToNoteString(60), "C4");
+    EXPECT_EQ(midiToNoteString(61), "C#4");
+    EXPECT_EQ(midiToNoteString(21), "A0");
+    EXPECT_EQ(midiToNoteString(108), "C8");
+    EXPECT_EQ(midiToNoteString(REST_MIDI), "Rest");
+}
+
+TEST(PitchSpellingTest, AlterFollowsTheKeySignature) {
+    EXPECT_EQ(spellingAlter(60, 0), 0);
+    EXPECT_EQ(spellingAlter(61, 0), 1);
+    EXPECT_EQ(spellingAlter(70, 2), 1);
+    EXPECT_EQ(spellingAlter(70, -1), -1);
+    EXPECT_EQ(spellingAlter(64, -3), 0);
+}
+
+TEST(PitchSpellingTest, StepAndOctave) {
+    struct Case { int midi; int alter; std::string step; int octave; };
+    const Case cases[] = {
+        {60, 0, "C", 4},
+        {63, 1, "D", 4},   // D-sharp
+        {63, -1, "E", 4},  // E-flat
+        {67, 2, "F", 4},   // F double-sharp
+        {65, -2, "G", 4},  // G double-flat
+        {60, 1, "B", 3},   // B-sharp 3 sounds as C4
+        {59, -1, "C", 4},  // C-flat 4 sounds as B3
+        {21, 0, "A", 0}
+    };
+    for (const Case& c : cases) {
+        EXPECT_EQ(spelledStep(c.midi, c.alter), c.step) << c.midi << " " << c.alter;
+        EXPECT_EQ(spelledOctave(c.midi, c.alter), c.octave) << c.midi << " " << c.alter;
+    }
+    EXPECT_THROW(spelledStep(61, 0), std::invalid_argument);
+}
+
+TEST(PitchSpellingTest, PitchClassDurationsCountFlatsAndSharps) {
+    std::vector<XMLNote> notes = {
+        {61, 1, 4, "quarter"},       // C-sharp
+        {61, -1, 8, "half"},         // D-flat, the same pitch class
+        {REST_MIDI, 0, 4, "quarter"},
+        {70, -1, 2, "eighth"}        // B-flat
+    };
+    std::vector<int> durations = calculatePitchDurations(notes);
+    ASSERT_EQ(durations.size(), 12u);
+    EXPECT_EQ(durations[1], 12);
+    EXPECT_EQ(durations[10], 2);
+    EXPECT_EQ(durations[0], 0);
+}
+
+TEST(PitchSpellingTest, ConvertToXMLNoteKeepsTheMidiNumber) {
+    Note note = {0.0f, 0.5f, 66, "quarter"};
+    XMLNote xmlNote = convertToXMLNote(note, 120);
+    EXPECT_EQ(xmlNote.midi, 66);
+    EXPECT_EQ(xmlNote.alter, 1);
+    EXPECT_FALSE(xmlNote.isRest());
+
+    Note rest = {0.5f, 1.0f, REST_MIDI, "quarter"};
+    EXPECT_TRUE(convertToXMLNote(rest, 120).isRest());
+}
@@ -0,0 +1,182 @@
+#define _USE_MATH_DEFINES
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <cmath>
+#include <vector>
+#include "polyphonicDetector.h"
+#include "audioBuffer.h"
+
+#define TEST_SAMPLE_RATE 44100
+
+// Piano-like tones: ten stretched partials at 1 / h, summed over the keys.
+static std::vector<Sample> synthesizeChord(const std::vector<int>& midiNotes, double seconds) {
+    std::vector<Sample> signal(static_cast<size_t>(seconds * TEST_SAMPLE_RATE));
+    for (int midi : midiNotes) {
+        double f0 = 440.0 * std::pow(2.0, (midi - 69) / 12.0);
+        for (int h = 1; h <= 10; h++) {
+            double frequency = h * f0 * std::sqrt(1.0 + PIANO_INHARMONICITY * h * h);
+            for (size_t i = 0; i < signal.size(); i++) {
+                signal[i] += static_cast<Sample>(0.1 / h * std::sin(2.0 * M_PI * frequency * i / TEST_SAMPLE_RATE));
+            }
+        }
+    }
+    return signal;
+}
+
+static KeySet keysOf(const std::vector<int>& midiNotes) {
+    KeySet keys;
+    for (int midi : midiNotes) {
+        keys.set(midi - PIANO_LOWEST_MIDI);
+    }
+    return keys;
+}
+
+TEST(PianoTemplatesTest, RowsAreUnitNormOverTheirRange) {
+    PianoTemplates templates(TEST_SAMPLE_RATE, POLY_FRAME_SIZE);
+    for (int key = 0; key < PIANO_KEYS; key++) {
+        ASSERT_EQ(templates.firstBin(key) % 4, 0u);
+        ASSERT_EQ(templates.lastBin(key) % 4, 0u);
+        ASSERT_LT(templates.firstBin(key), templates.lastBin(key));
+        double norm = 0.0;
+        for (size_t bin = templates.firstBin(key); bin < templates.lastBin(key); bin++) {
+            norm += templates.row(key)[bin] * templates.row(key)[bin];
+        }
+        EXPECT_NEAR(norm, 1.0, 1e-5) << "key " << key;
+    }
+}
+
+TEST(PolyphonicDetectorTest, FindsEveryKeyOfAChord) {
+    // A key lying exactly on a low partial of another (E4 over A2) is absorbed
+    // by the lower key's template, so the voicings avoid that case.
+    const std::vector<std::vector<int>> chords = {
+        {60},             // C4
+        {60, 64, 67},     // C major
+        {48, 55, 60, 64}, // C3 G3 C4 E4
+        {41, 57, 60, 65}, // F2 A3 C4 F4
+        {43, 50, 59, 67}  // G2 D3 B3 G4
+    };
+    for (const std::vector<int>& chord : chords) {
+        std::vector<Sample> signal = synthesizeChord(chord, 1.0);
+        PolyphonicAnalysis analysis = analyzePolyphonicFrames(signal.data(), signal.size(), TEST_SAMPLE_RATE);
+        ASSERT_FALSE(analysis.frameKeys.empty());
+        EXPECT_EQ(analysis.frameKeys[analysis.frameKeys.size() / 2], keysOf(chord))
+            << "chord starting at MIDI " << chord[0];
+    }
+}
+
+TEST(PolyphonicDetectorTest, StreamingMatchesWholeSignal) {
+    std::vector<Sample> signal = synthesizeChord({48, 55, 64}, 0.5);
+    std::vector<Sample> second = synthesizeChord({53, 57, 60}, 0.5);
+    signal.insert(signal.end(), TEST_SAMPLE_RATE / 4, 0.0f);
+    signal.insert(signal.end(), second.begin(), second.end());
+    PolyphonicAnalysis whole = analyzePolyphonicFrames(signal.data(), signal.size(), TEST_SAMPLE_RATE);
+
+    StreamingChordAnalyzer analyzer(TEST_SAMPLE_RATE);
+    for (size_t i = 0; i < signal.size(); i += 3000) {
+        analyzer.push(signal.data() + i, std::min<size_t>(3000, signal.size() - i));
+    }
+    ASSERT_FALSE(whole.onsetTimes.empty());
+    EXPECT_EQ(analyzer.analysis().frameKeys, whole.frameKeys);
+    EXPECT_EQ(analyzer.analysis().onsetTimes, whole.onsetTimes);
+}
+
+TEST(PolyphonicDetectorTest, SilenceHasNoKeys) {
+    std::vector<float> magnitudes(POLY_FRAME_SIZE / 2 + 1, 0.0f);
+    PolyphonicDetector detector(TEST_SAMPLE_RATE);
+    EXPECT_TRUE(detector.detect(magnitudes.data()).none());
+}
+
+TEST(SegmentChordsTest, EmitsChordTonesWithSharedTimes) {
+    PolyphonicAnalysis analysis;
+    analysis.sampleRate = TEST_SAMPLE_RATE;
+    KeySet cMajor = keysOf({60, 64, 67});
+    KeySet fMajor = keysOf({53, 57, 60});
+    analysis.frameKeys.assign(40, cMajor);
+    analysis.frameKeys.insert(analysis.frameKeys.end(), 40, fMajor);
+    analysis.frameKeys.insert(analysis.frameKeys.end(), 40, KeySet());
+
+    std::vector<Note> notes = segmentChords(analysis, 120);
+    ASSERT_EQ(notes.size(), 7u);
+    EXPECT_EQ(notes[0].midi, 60); // C4
+    EXPECT_FALSE(notes[0].chord);
+    EXPECT_EQ(notes[1].midi, 64); // E4
+    EXPECT_TRUE(notes[1].chord);
+    EXPECT_EQ(notes[2].midi, 67); // G4
+    EXPECT_TRUE(notes[2].chord);
+    EXPECT_FLOAT_EQ(notes[2].startTime, notes[0].startTime);
+    EXPECT_FLOAT_EQ(notes[2].endTime, notes[0].endTime);
+
+    EXPECT_EQ(notes[3].midi, 53); // F3
+    EXPECT_FALSE(notes[3].chord);
+    EXPECT_FLOAT_EQ(notes[3].startTime, notes[0].endTime);
+    EXPECT_EQ(notes[6].midi, REST_MIDI);
+    EXPECT_FALSE(notes[6].chord);
+}
+
+TEST(SegmentChordsTest, DecayAndOvertonesDoNotStartNewChords) {
+    PolyphonicAnalysis analysis;
+    analysis.sampleRate = TEST_SAMPLE_RATE;
+    KeySet chord = keysOf({48, 55, 64});
+    KeySet decayed = keysOf({48, 64});
+    KeySet withOctave = keysOf({48, 60, 64});  // C4 is C3's second partial
+    analysis.frameKeys.assign(40, chord);
+    analysis.frameKeys.insert(analysis.frameKeys.end(), 10, decayed);
+    analysis.frameKeys.insert(analysis.frameKeys.end(), 10, withOctave);
+    analysis.frameKeys.insert(analysis.frameKeys.end(), 2, keysOf({70}));  // a blip
+    analysis.frameKeys.insert(analysis.frameKeys.end(), 10, decayed);
+
+    std::vector<Note> notes = segmentChords(analysis, 120);
+    ASSERT_EQ(notes.size(), 3u);
+    EXPECT_EQ(notes[0].midi, 48); // C3
+    EXPECT_EQ(notes[1].midi, 55); // G3
+    EXPECT_EQ(notes[2].midi, 64); // E4
+}
+
+TEST(SegmentChordsTest, OnsetsSplitARepeatedChord) {
+    PolyphonicAnalysis analysis;
+    analysis.sampleRate = TEST_SAMPLE_RATE;
+    analysis.frameKeys.assign(80, keysOf({60, 64}));
+    analysis.onsetTimes.push_back((40 * POLY_HOP_SIZE + (POLY_FRAME_SIZE - POLY_HOP_SIZE) / 2.0) / TEST_SAMPLE_RATE);
+
+    std::vector<Note> notes = segmentChords(analysis, 120);
+    ASSERT_EQ(notes.size(), 4u);
+    EXPECT_FALSE(notes[2].chord);
+    EXPECT_EQ(notes[2].midi, 60); // C4
+    EXPECT_FLOAT_EQ(notes[2].startTime, notes[1].endTime);
+}
+
+TEST(PolyphonicDetectorTest, TranscribesTheChordProgression) {
+    AudioBuffer audio;
+    ASSERT_TRUE(audio.load("piano-samples/sample-chords/piano-chord-progression1.wav"));
+    std::vector<Note> notes = extract_chord_durations(audio.data(), audio.size(), audio.sampleRate(), 94);
+
+    // Group the notes back into chords.
+    std::vector<std::vector<std::string>> chords;
+    for (const Note& note : notes) {
+        if (note.midi == REST_MIDI) {
+            continue;
+        }
+        if (!note.chord) {
+            chords.emplace_back();
+        }
+        ASSERT_FALSE(chords.empty());
+        chords.back().push_back(midiToNoteString(note.midi));
+    }
+
+    // The score's four chords; the detector may miss inner voices.
+    const std::vector<std::vector<std::string>> expected = {
+        {"C3", "G3", "C4", "E4"},
+        {"G2", "D3", "B3", "G4"},
+        {"A2", "E3", "C4", "E4", "G4"},
+        {"F2", "A3", "C4", "F4"}
+    };
+    ASSERT_EQ(chords.size(), expected.size());
+    for (size_t c = 0; c < expected.size(); c++) {
+        EXPECT_EQ(chords[c][0], expected[c][0]) << "bass of chord " << c;
+        for (const std::string& pitch : chords[c]) {
+            EXPECT_NE(std::find(expected[c].begin(), expected[c].end(), pitch), expected[c].end())
+                << pitch << " is not in chord " << c;
+        }
+        EXPECT_GE(chords[c].size(), 3u) << "chord " << c;
+    }
+}
@@ -0,0 +1,111 @@
+#define _USE_MATH_DEFINES
+#include <gtest/gtest.h>
+#include <cmath>
+#include <stdexcept>
+#include <vector>
+#include "resampler.h"
+#include "audioBuffer.h"
+#include "note_duration_extractor.h"
+
+static std::vector<float> sine(double frequency, int sampleRate, size_t size) {
+    std::vector<float> signal(size);
+    for (size_t i = 0; i < size; i++) {
+        signal[i] = static_cast<float>(0.5 * std::sin(2.0 * M_PI * frequency * i / sampleRate));
+    }
+    return signal;
+}
+
+struct RateCase {
+    int inputRate;
+    int outputRate;
+};
+
+class ResamplerTest : public ::testing::TestWithParam<RateCase> {};
+
+TEST_P(ResamplerTest, TonesKeepTheirPitchAndLevel) {
+    const RateCase rates = GetParam();
+    const size_t size = rates.inputRate / 2;
+    std::vector<float> in = sine(440.0, rates.inputRate, size);
+    Resampler<float> resampler(rates.inputRate, rates.outputRate);
+
+    std::vector<float> out(resampler.outputSize(size));
+    ASSERT_EQ(resampler.process(in, out), out.size());
+    EXPECT_EQ(out.size(), (size * rates.outputRate + rates.inputRate - 1) / rates.inputRate);
+
+    // Away from the zero-padded ends the output is the same tone at the new rate.
+    std::vector<float> expected = sine(440.0, rates.outputRate, out.size());
+    const size_t margin = resampler.tapsPerPhase();
+    for (size_t n = margin; n + margin < out.size(); n++) {
+        ASSERT_NEAR(out[n], expected[n], 2e-3) << n;
+    }
+}
+
+TEST_P(ResamplerTest, BlocksMatchWholeSignal) {
+    const RateCase rates = GetParam();
+    std::vector<float> in = sine(523.25, rates.inputRate, 20000);
+    Resampler<float> resampler(rates.inputRate, rates.outputRate);
+    std::vector<float> whole(resampler.outputSize(in.size()));
+    resampler.process(in, whole);
+
+    for (size_t blockSize : {1, 37, 4096}) {
+        std::vector<float> streamed;
+        for (size_t i = 0; i < in.size(); i += blockSize) {
+            resampler.push(in.data() + i, std::min(blockSize, in.size() - i), streamed);
+        }
+        resampler.finish(streamed);
+        EXPECT_EQ(streamed, whole) << "block size " << blockSize;
+    }
+}
+
+INSTANTIATE_TEST_SUITE_P(Rates, ResamplerTest, ::testing::Values(
+    RateCase{44100, 11025},
+    RateCase{44100, 16000},
+    RateCase{48000, 16000},
+    RateCase{96000, 11025},
+    RateCase{22050, 44100}
+));
+
+TEST(ResamplerTest, RejectsInvalidRates) {
+    EXPECT_THROW(Resampler<float>(0, 16000), std::invalid_argument);
+    EXPECT_THROW(Resampler<double>(44100, -1), std::invalid_argument);
+}
+
+TEST(FrameGeometryTest, ScalesWithTheAnalysisRate) {
+    FrameGeometry native;
+    EXPECT_EQ(native.pitchFrameSize, static_cast<size_t>(PITCH_FRAME_SIZE));
+
+    FrameGeometry quarter = FrameGeometry::scaled(44100, 11025);
+    EXPECT_EQ(quarter.energyResolution, 64u);
+    EXPECT_EQ(quarter.pitchFrameSize, 512u);
+    EXPECT_EQ(quarter.pitchHopSize, 128u);
+    EXPECT_EQ(quarter.onsetFrameSize, 128u);
+    EXPECT_EQ(quarter.onsetHopSize, 64u);
+
+    FrameGeometry third = FrameGeometry::scaled(48000, 16000);
+    EXPECT_EQ(third.energyResolution, 85u);
+    EXPECT_EQ(third.pitchFrameSize, 8 * 85u);
+}
+
+TEST(FrameGeometryTest, DownsampledFramesTrackTheSamePitches) {
+    AudioBuffer audio;
+    ASSERT_TRUE(audio.load("Computer-Generated-Samples/D4_to_E5_1_second_per_note.wav"));
+    FrameAnalysis native = analyzeFrames(audio.data(), audio.size(), audio.sampleRate());
+
+    // A quarter of 44.1 kHz, so frames line up one to one with the native ones.
+    const int analysisRate = 11025;
+    Resampler<Sample> resampler(audio.sampleRate(), analysisRate);
+    std::vector<Sample> resampled(resampler.outputSize(audio.size()));
+    resampler.process(Span<const Sample>(audio.data(), audio.size()), resampled);
+    FrameAnalysis downsampled = analyzeFrames(resampled.data(), resampled.size(), analysisRate, PitchOptions(),
+                                              FrameGeometry::scaled(audio.sampleRate(), analysisRate));
+
+    ASSERT_EQ(downsampled.pitchEstimates.size(), native.pitchEstimates.size());
+    size_t agree = 0;
+    for (size_t i = 0; i < native.pitchEstimates.size(); i++) {
+        agree += frequencyToMidi(downsampled.pitchEstimates[i]) == frequencyToMidi(native.pitchEstimates[i]);
+    }
+    EXPECT_GT(agree, native.pitchEstimates.size() * 95 / 100);
+    ASSERT_FALSE(native.onsetTimes.empty());
+    EXPECT_NEAR(static_cast<double>(downsampled.onsetTimes.size()), native.onsetTimes.size(),
+                native.onsetTimes.size() * 0.2 + 1);
+}
@@ -0,0 +1,57 @@
+#include <gtest/gtest.h>
+#include <cstdint>
+#include "scratchArena.h"
+
+TEST(ScratchArenaTest, AllocationsAreAligned) {
+    ScratchArena arena(4096);
+    const size_t alignment = AlignedBuffer<unsigned char>::ALIGNMENT;
+    for (size_t count : {1u, 3u, 17u, 100u}) {
+        float* p = arena.allocate<float>(count);
+        EXPECT_EQ(reinterpret_cast<uintptr_t>(p) % alignment, 0u);
+    }
+}
+
+TEST(ScratchArenaTest, ScopeHandsMemoryBack) {
+    ScratchArena arena(4096);
+    double* first;
+    {
+        ScratchArena::Scope scope(arena);
+        first = arena.allocate<double>(64);
+    }
+    ScratchArena::Scope scope(arena);
+    EXPECT_EQ(arena.allocate<double>(64), first);
+}
+
+TEST(ScratchArenaTest, NestedScopesUnwindInOrder) {
+    ScratchArena arena(4096);
+    ScratchArena::Scope outer(arena);
+    double* a = arena.allocate<double>(8);
+    double* inner;
+    {
+        ScratchArena::Scope scope(arena);
+        inner = arena.allocate<double>(8);
+        EXPECT_NE(inner, a);
+    }
+    EXPECT_EQ(arena.allocate<double>(8), inner);
+}
+
+TEST(ScratchArenaTest, GrowsToHighWaterMarkWhenIdle) {
+    ScratchArena arena(256);
+    size_t before = arena.heapAllocations();
+    {
+        ScratchArena::Scope scope(arena);
+        arena.allocate<double>(16);
+        arena.allocate<double>(1000); // spills into an overflow block
+    }
+    EXPECT_GE(arena.capacity(), (16 + 1000) * sizeof(double));
+
+    // The same pattern now fits the main block.
+    size_t grown = arena.heapAllocations();
+    EXPECT_GT(grown, before);
+    for (int i = 0; i < 10; i++) {
+        ScratchArena::Scope scope(arena);
+        arena.allocate<double>(16);
+        arena.allocate<double>(1000);
+    }
+    EXPECT_EQ(arena.heapAllocations(), grown);
+}
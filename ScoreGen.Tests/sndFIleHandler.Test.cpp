@@ -37,6 +37,71 @@ TEST(SndFileHandlerTest, ReadValidFile) {
     std::filesystem::remove_all("test-data");
 }
 
+TEST(SndFileHandlerTest, ReadKeepsAllChannels) {
+    std::filesystem::create_directory("test-data");
+
+    SF_INFO sfinfo;
+    memset(&sfinfo, 0, sizeof(sfinfo));
+    sfinfo.channels = 2;
+    sfinfo.samplerate = 44100;
+    sfinfo.format = SF_FORMAT_WAV | SF_FORMAT_PCM_16;
+    SNDFILE* file = sf_open("test-data/stereo.wav", SFM_WRITE, &sfinfo);
+
+    // Left channel carries the sine, right channel a constant
+    std::vector<double> sineWave = generateSineWave(440.0, sfinfo.samplerate, 1.0);
+    std::vector<double> interleaved;
+    for (double sample : sineWave) {
+        interleaved.push_back(sample);
+        interleaved.push_back(0.25);
+    }
+    sf_write_double(file, interleaved.data(), interleaved.size());
+    sf_close(file);
+
+    SndFileHandler handler("test-data/stereo.wav", "");
+    SF_INFO info;
+    std::vector<double> data;
+    ASSERT_TRUE(handler.readSndFile(info, data));
+
+    EXPECT_EQ(info.channels, 2);
+    EXPECT_EQ(info.frames, 44100);
+    ASSERT_EQ(data.size(), interleaved.size());
+    EXPECT_NEAR(data[2 * 100], sineWave[100], FP_TOL);
+    EXPECT_NEAR(data[2 * 100 + 1], 0.25, FP_TOL);
+    EXPECT_NEAR(data[2 * 44099], sineWave[44099], FP_TOL);
+    EXPECT_NEAR(data[2 * 44099 + 1], 0.25, FP_TOL);
+
+    std::filesystem::remove_all("test-data");
+}
+
+TEST(SndFileHandlerTest, ReadIntoReusedBuffer) {
+    SndFileHandler handler("piano-samples/sample-scales/c-major-scale-on-treble-clef.wav", "");
+    auto [expectedInfo, expected] = handler.readSndFile();
+    ASSERT_FALSE(expected.empty());
+
+    SF_INFO info;
+    std::vector<double> data;
+    ASSERT_TRUE(handler.readSndFile(info, data));
+    EXPECT_EQ(data, expected);
+    EXPECT_EQ(info.frames * info.channels, static_cast<sf_count_t>(expected.size()));
+
+    // A second read of the same size lands in the same allocation.
+    const double* storage = data.data();
+    const size_t capacity = data.capacity();
+    ASSERT_TRUE(handler.readSndFile(info, data));
+    EXPECT_EQ(data, expected);
+    EXPECT_EQ(data.data(), storage);
+    EXPECT_EQ(data.capacity(), capacity);
+}
+
+TEST(SndFileHandlerTest, ReadMissingFileIntoBuffer) {
+    SndFileHandler handler("fakefile.wav", "");
+    SF_INFO info;
+    std::vector<double> data(16, 1.0);
+
+    EXPECT_FALSE(handler.readSndFile(info, data));
+    EXPECT_TRUE(data.empty());
+}
+
 TEST(SndFileHandlerTest, ReadNonExistentFile) {
     SndFileHandler handler("fakefile.wav", "");
     auto [sfInfo, data] = handler.readSndFile();
@@ -0,0 +1,136 @@
+#include <gtest/gtest.h>
+#include <vector>
+#include "note_duration_extractor.h"
+#include "determineBPM.h"
+#include "test-helpers/test-helpers.h"
+
+#define SAMPLE_RATE 44100
+
+// Two tones separated by silence, so both the pitch and the onset passes have
+// something to report.
+static std::vector<Sample> toneSequence() {
+    std::vector<double> first = generateSineWave(440.0, SAMPLE_RATE, 0.5);
+    std::vector<double> second = generateSineWave(660.0, SAMPLE_RATE, 0.5);
+    std::vector<Sample> signal(first.begin(), first.end());
+    signal.insert(signal.end(), SAMPLE_RATE / 4, 0.0f);
+    signal.insert(signal.end(), second.begin(), second.end());
+    return signal;
+}
+
+static FrameAnalysis analyzeInBlocks(const std::vector<Sample>& signal, size_t blockSize) {
+    StreamingFrameAnalyzer analyzer(SAMPLE_RATE);
+    for (size_t i = 0; i < signal.size(); i += blockSize) {
+        analyzer.push(signal.data() + i, std::min(blockSize, signal.size() - i));
+    }
+    return analyzer.analysis();
+}
+
+class StreamingFrameAnalyzerTest : public ::testing::TestWithParam<size_t> {};
+
+TEST_P(StreamingFrameAnalyzerTest, MatchesWholeSignalAnalysis) {
+    std::vector<Sample> signal = toneSequence();
+    FrameAnalysis whole = analyzeFrames(signal.data(), signal.size(), SAMPLE_RATE);
+    FrameAnalysis streamed = analyzeInBlocks(signal, GetParam());
+
+    ASSERT_FALSE(whole.pitchEstimates.empty());
+    ASSERT_FALSE(whole.onsetTimes.empty());
+    EXPECT_EQ(streamed.pitchEstimates, whole.pitchEstimates);
+    EXPECT_EQ(streamed.onsetTimes, whole.onsetTimes);
+}
+
+INSTANTIATE_TEST_SUITE_P(BlockSizes, StreamingFrameAnalyzerTest,
+    ::testing::Values(7, 256, 511, 2047, 2048, 4096, 65536));
+
+TEST(StreamingFrameAnalyzerTest, ParallelMatchesStreamed) {
+    std::vector<Sample> signal = toneSequence();
+    ThreadPool pool(4);
+    for (PitchMethod method : {PitchMethod::Autocorrelation, PitchMethod::YIN, PitchMethod::MPM}) {
+        PitchOptions options = defaultPitchOptions(method);
+        StreamingFrameAnalyzer analyzer(SAMPLE_RATE, options);
+        analyzer.push(signal.data(), signal.size());
+        FrameAnalysis parallel = analyzeFrames(signal.data(), signal.size(), SAMPLE_RATE, pool, options);
+
+        EXPECT_EQ(parallel.pitchEstimates, analyzer.analysis().pitchEstimates);
+        EXPECT_EQ(parallel.onsetTimes, analyzer.analysis().onsetTimes);
+    }
+}
+
+TEST(StreamingFrameAnalyzerTest, FrameCountMatchesSignalLength) {
+    std::vector<Sample> signal(10000, 0.0f);
+    FrameAnalysis analysis = analyzeInBlocks(signal, 1000);
+    EXPECT_EQ(analysis.pitchEstimates.size(),
+              static_cast<size_t>((10000 - PITCH_FRAME_SIZE) / PITCH_HOP_SIZE + 1));
+}
+
+TEST(StreamingFrameAnalyzerTest, ShortSignalHasNoFrames) {
+    std::vector<Sample> signal(PITCH_FRAME_SIZE - 1, 0.5f);
+    FrameAnalysis analysis = analyzeInBlocks(signal, 100);
+    EXPECT_TRUE(analysis.pitchEstimates.empty());
+}
+
+TEST(TempoTrackerTest, BlocksMatchWholeBuffer) {
+    std::vector<Sample> signal = toneSequence();
+    float whole = getBufferBPM(signal.data(), signal.size(), SAMPLE_RATE);
+
+    TempoTracker tracker(SAMPLE_RATE);
+    for (size_t i = 0; i < signal.size(); i += 1000) {
+        tracker.push(signal.data() + i, std::min<size_t>(1000, signal.size() - i));
+    }
+    EXPECT_EQ(tracker.finish(), whole);
+}
+
+TEST(TempoTrackerTest, SharesADriverPassWithFrameAnalysis) {
+    std::vector<Sample> signal = toneSequence();
+    float wholeBPM = getBufferBPM(signal.data(), signal.size(), SAMPLE_RATE);
+    FrameAnalysis whole = analyzeFrames(signal.data(), signal.size(), SAMPLE_RATE);
+
+    FrameDriver driver;
+    TempoTracker tracker(SAMPLE_RATE);
+    driver.add(tracker);
+    FrameAnalysis shared = analyzeFrames(signal.data(), signal.size(), SAMPLE_RATE, driver, ThreadPool::shared());
+    EXPECT_EQ(tracker.finish(), wholeBPM);
+    EXPECT_EQ(shared.pitchEstimates, whole.pitchEstimates);
+    EXPECT_EQ(shared.onsetTimes, whole.onsetTimes);
+
+    FrameDriver streamDriver;
+    TempoTracker streamTracker(SAMPLE_RATE);
+    StreamingFrameAnalyzer analyzer(SAMPLE_RATE);
+    streamDriver.add(streamTracker);
+    analyzer.attach(streamDriver);
+    for (size_t i = 0; i < signal.size(); i += 1000) {
+        streamDriver.push(signal.data() + i, std::min<size_t>(1000, signal.size() - i));
+    }
+    streamDriver.finish();
+    EXPECT_EQ(streamTracker.finish(), wholeBPM);
+    EXPECT_EQ(analyzer.analysis().pitchEstimates, whole.pitchEstimates);
+    EXPECT_EQ(analyzer.analysis().onsetTimes, whole.onsetTimes);
+}
+
+TEST(TempoTrackerTest, DoubleInputMatchesSamples) {
+    std::vector<Sample> samples = clickTrack(120.0, 8.0, SAMPLE_RATE);
+    std::vector<double> clicks(samples.begin(), samples.end());
+    float bpm = getBufferBPM(samples.data(), samples.size(), SAMPLE_RATE);
+    EXPECT_GT(bpm, 0.0f);
+    EXPECT_EQ(getBufferBPM(clicks.data(), clicks.size(), SAMPLE_RATE), bpm);
+}
+
+TEST(TempoTrackerTest, FinalPartialHopIsZeroPadded) {
+    // Whole hops ending in a burst, then one more sample: the last frame
+    // must hold that sample and zeros, not what is left of the burst.
+    std::vector<Sample> signal = clickTrack(120.0, 8.0, SAMPLE_RATE);
+    signal.resize((signal.size() / HOP_S) * HOP_S);
+    for (size_t i = signal.size() - HOP_S; i < signal.size(); i++) {
+        signal[i] = 0.5f;
+    }
+    signal.push_back(0.25f);
+    std::vector<Sample> padded = signal;
+    padded.resize(signal.size() + HOP_S - 1, 0.0f);
+
+    EXPECT_EQ(getBufferBPM(signal.data(), signal.size(), SAMPLE_RATE),
+              getBufferBPM(padded.data(), padded.size(), SAMPLE_RATE));
+}
+
+TEST(TempoTrackerTest, InvalidMode) {
+    std::map<std::string, std::string> params{ {"mode", "invalid"} };
+    EXPECT_THROW(TempoTracker(SAMPLE_RATE, params), std::invalid_argument);
+}
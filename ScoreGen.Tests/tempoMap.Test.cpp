@@ -0,0 +1,70 @@
+#include <gtest/gtest.h>
+#include <vector>
+#include "tempoMap.h"
+#include "tempogram.h"
+#include "dsp.h"
+#include "test-helpers/test-helpers.h"
+
+#define CLICK_RATE 22050
+
+TEST(TempoMapTest, InterpolatesBetweenPoints) {
+    TempoMap map;
+    map.times = {10.0, 20.0};
+    map.bpms = {60.0, 120.0};
+    EXPECT_DOUBLE_EQ(map.bpmAt(0.0), 60.0);
+    EXPECT_DOUBLE_EQ(map.bpmAt(15.0), 90.0);
+    EXPECT_DOUBLE_EQ(map.bpmAt(30.0), 120.0);
+    // 10 s at 60, a ramp averaging 90 for 10 s, then 10 s at 120.
+    EXPECT_NEAR(map.beatsBetween(0.0, 30.0), 10.0 + 15.0 + 20.0, 1e-9);
+    EXPECT_NEAR(map.averageBPM(12.0, 18.0), 90.0, 1e-9);
+    EXPECT_DOUBLE_EQ(map.averageBPM(5.0, 5.0), 60.0);
+    EXPECT_DOUBLE_EQ(TempoMap::constant(97.0).averageBPM(1.0, 2.0), 97.0);
+}
+
+TEST(TempoMapTest, DurationsFollowTheMap) {
+    TempoMap map;
+    map.times = {10.0, 20.0};
+    map.bpms = {60.0, 120.0};
+    Note early = {2.0f, 3.0f, 60, "quarter"};
+    Note late = {25.0f, 26.0f, 60, "half"};
+    EXPECT_EQ(convertToXMLNote(early, map).duration, convertToXMLNote(early, 60).duration);
+    EXPECT_EQ(convertToXMLNote(late, map).duration, 2 * convertToXMLNote(early, map).duration);
+    EXPECT_EQ(determineNoteType(2.0, 3.0, map), determineNoteType(1.0f, 60));
+    EXPECT_EQ(determineNoteType(25.0, 26.0, map), determineNoteType(1.0f, 120));
+}
+
+TEST(TempoMapTest, FollowsATempoRamp) {
+    std::vector<Sample> signal = rampClickTrack(100.0, 130.0, 120.0, CLICK_RATE);
+    TempoMap map = estimateTempoMap(signal.data(), signal.size(), CLICK_RATE);
+    ASSERT_GT(map.bpms.size(), 20u);
+    for (size_t i = 0; i < map.bpms.size(); i++) {
+        double expected = 100.0 + 30.0 * map.times[i] / 120.0;
+        EXPECT_NEAR(map.bpms[i], expected, 3.0) << "at " << map.times[i] << " s";
+    }
+}
+
+TEST(TempoMapTest, PoolSizeDoesNotChangeTheMap) {
+    std::vector<Sample> signal = rampClickTrack(90.0, 110.0, 60.0, CLICK_RATE);
+    ThreadPool serialPool(1);
+    ThreadPool pool(4);
+    TempoMap serial = estimateTempoMap(signal.data(), signal.size(), CLICK_RATE, serialPool);
+    TempoMap parallel = estimateTempoMap(signal.data(), signal.size(), CLICK_RATE, pool);
+    EXPECT_EQ(parallel.times, serial.times);
+    EXPECT_EQ(parallel.bpms, serial.bpms);
+
+    // The flux frames split across tasks give the streaming tracker's envelope.
+    TempogramTracker tracker(CLICK_RATE);
+    tracker.push(signal.data(), signal.size());
+    tracker.finish();
+    TempoMap streamed = estimateTempoMap(tracker.envelope(), tracker.framesPerSecond(), serialPool);
+    EXPECT_EQ(streamed.bpms, serial.bpms);
+}
+
+TEST(TempoMapTest, ShortSignalsGetOnePoint) {
+    std::vector<Sample> signal = rampClickTrack(120.0, 120.0, 8.0, CLICK_RATE);
+    TempoMap map = estimateTempoMap(signal.data(), signal.size(), CLICK_RATE);
+    ASSERT_EQ(map.bpms.size(), 1u);
+    EXPECT_NEAR(map.bpms[0], 120.0, 1.0);
+    std::vector<Sample> silence(CLICK_RATE, 0.0f);
+    EXPECT_TRUE(estimateTempoMap(silence.data(), silence.size(), CLICK_RATE).empty());
+}
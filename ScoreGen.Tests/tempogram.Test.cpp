@@ -0,0 +1,73 @@
+#include <gtest/gtest.h>
+#include <vector>
+#include "tempogram.h"
+#include "STFT.h"
+#include "audioBuffer.h"
+#include "determineBPM.h"
+#include "test-helpers/test-helpers.h"
+
+#define CLICK_RATE 44100
+
+class TempogramClickTest : public ::testing::TestWithParam<double> {};
+
+TEST_P(TempogramClickTest, FindsTheClickTempo) {
+    const double bpm = GetParam();
+    std::vector<Sample> signal = clickTrack(bpm, 30.0, CLICK_RATE);
+    EXPECT_NEAR(getTempogramBPM(signal.data(), signal.size(), CLICK_RATE), bpm, 1.0);
+}
+
+INSTANTIATE_TEST_SUITE_P(Tempi, TempogramClickTest, ::testing::Values(80.0, 96.0, 120.0, 137.0, 160.0));
+
+class TempogramDatasetTest : public ::testing::TestWithParam<const char*> {};
+
+// The files the aubio tracker is checked against in DetermineBPM.Test.cpp:
+// half notes at 120 BPM, played a little slow (onsets 1.01 s apart).
+TEST_P(TempogramDatasetTest, MatchesTheScaleTempo) {
+    AudioBuffer audio;
+    ASSERT_TRUE(audio.load(GetParam()));
+    EXPECT_NEAR(getTempogramBPM(audio.data(), audio.size(), audio.sampleRate()), 2 * 60.0 / 1.01, 1.0);
+}
+
+// dsp() takes its tempo from the tempogram instead of the aubio tracker, so
+// the two must agree on the datasets.
+TEST_P(TempogramDatasetTest, MatchesGetBufferBPM) {
+    AudioBuffer audio;
+    ASSERT_TRUE(audio.load(GetParam()));
+    std::map<std::string, std::string> params{ {"mode", "default"} };
+    EXPECT_NEAR(getTempogramBPM(audio.data(), audio.size(), audio.sampleRate()),
+                getBufferBPM(audio.data(), audio.size(), audio.sampleRate(), params), 1.0);
+}
+
+INSTANTIATE_TEST_SUITE_P(Scales, TempogramDatasetTest, ::testing::Values(
+    "piano-samples/sample-scales/c-major-scale-descending-on-bass-clef.wav",
+    "piano-samples/sample-scales/c-major-scale-on-bass-clef.wav",
+    "piano-samples/sample-scales/c-major-scale-descending-on-treble-clef.wav",
+    "piano-samples/sample-scales/c-major-scale-on-treble-clef.wav"
+));
+
+TEST(TempogramTest, TrackerEnvelopeMatchesSTFT) {
+    std::vector<Sample> signal = clickTrack(100.0, 5.0, CLICK_RATE);
+    signal.resize(signal.size() + 300); // end on a partial hop
+
+    TempogramTracker tracker(CLICK_RATE);
+    for (size_t i = 0; i < signal.size(); i += 7001) {
+        tracker.push(signal.data() + i, std::min<size_t>(7001, signal.size() - i));
+    }
+    float streamed = tracker.finish();
+
+    SpectrogramF spectrogram = STFT<float>(signal, TEMPOGRAM_WINDOW, TEMPOGRAM_HOP);
+    std::vector<double> flux = spectralFlux(spectrogram);
+    ASSERT_EQ(tracker.envelope().size(), flux.size());
+    for (size_t i = 0; i < flux.size(); i++) {
+        ASSERT_NEAR(tracker.envelope()[i], flux[i], 1e-3 * (1.0 + flux[i])) << i;
+    }
+    EXPECT_NEAR(tempogramBPM(spectrogram, CLICK_RATE, TEMPOGRAM_HOP), streamed, 0.01);
+}
+
+TEST(TempogramTest, TooShortOrSilentGivesZero) {
+    std::vector<Sample> silence(10 * CLICK_RATE, 0.0f);
+    EXPECT_EQ(getTempogramBPM(silence.data(), silence.size(), CLICK_RATE), 0.0f);
+    std::vector<Sample> brief = clickTrack(120.0, 2.0, CLICK_RATE);
+    EXPECT_EQ(getTempogramBPM(brief.data(), brief.size(), CLICK_RATE), 0.0f);
+    EXPECT_EQ(getTempogramBPM(nullptr, 0, CLICK_RATE), 0.0f);
+}
@@ -0,0 +1,48 @@
+#ifndef ANALYSISCONTEXT_HELPERS_H
+#define ANALYSISCONTEXT_HELPERS_H
+
+#define _USE_MATH_DEFINES
+#include <cmath>
+#include <vector>
+#include "analysisContext.h"
+
+// Shared by the AnalysisContext tests and the allocation-counting tests,
+// which build into separate executables.
+
+#define SAMPLE_RATE 44100
+
+// A rising glide with a quiet gap, so frames hit the RMS gate, short and long
+// lags, and both estimator paths.
+inline std::vector<Sample> testSignal() {
+    std::vector<Sample> signal(SAMPLE_RATE);
+    double phase = 0.0;
+    for (size_t i = 0; i < signal.size(); i++) {
+        double frequency = 40.0 + 1500.0 * i / signal.size();
+        phase += 2.0 * M_PI * frequency / SAMPLE_RATE;
+        bool gap = i > signal.size() / 2 && i < signal.size() / 2 + 4096;
+        signal[i] = gap ? 0.0f : static_cast<Sample>(0.5 * std::sin(phase) + 0.2 * std::sin(2 * phase));
+    }
+    return signal;
+}
+
+struct ContextCase {
+    PitchMethod method;
+    bool earlyTermination;
+
+    PitchOptions options() const {
+        PitchOptions options = defaultPitchOptions(method);
+        options.earlyTermination = earlyTermination;
+        return options;
+    }
+};
+
+// Every estimator, on both of its paths where it has two.
+static const ContextCase contextCases[] = {
+    {PitchMethod::Autocorrelation, true},
+    {PitchMethod::YIN, true},
+    {PitchMethod::YIN, false},
+    {PitchMethod::MPM, true},
+    {PitchMethod::MPM, false}
+};
+
+#endif // ANALYSISCONTEXT_HELPERS_H
@@ -15,24 +15,56 @@ std::vector<double> generateConstantSignal(double value, double sampleRate, doub
     return std::vector<double>(numSamples, value);
 }
 
-float extractFundamentalFrequency(const std::vector<std::vector<double>>& spectrogram, double sampleRate) {
-    if (spectrogram.empty() || spectrogram[0].empty()) {
+float extractFundamentalFrequency(const Spectrogram& spectrogram, double sampleRate) {
+    if (spectrogram.empty() || spectrogram.numBins() == 0) {
         return 0;
     }
-    int numBins = spectrogram[0].size();
+    int numBins = spectrogram.numBins();
     float resolution = sampleRate / (numBins * 2 - 1);
 
+    // The storage is one contiguous frame-major run, so scan it linearly.
+    const double* values = spectrogram.data();
+    const size_t count = spectrogram.numFrames() * spectrogram.numBins();
     int fundamentalBin = -1;
     float maxMagnitude = 0.0f;
 
-    for (const auto& frame : spectrogram) {
-        for (int bin = 0; bin < numBins; ++bin) {
-            if (frame[bin] > maxMagnitude) {
-                maxMagnitude = frame[bin];
-                fundamentalBin = bin;
-            }
+    for (size_t i = 0; i < count; ++i) {
+        if (values[i] > maxMagnitude) {
+            maxMagnitude = values[i];
+            fundamentalBin = i % numBins;
         }
     }
 
     return resolution * fundamentalBin;
-}
\ No newline at end of file
+}
+
+// Adds one click at `start`, cut off at the end of the signal.
+static void addClick(std::vector<Sample>& signal, size_t start, size_t beat, int sampleRate) {
+    const float level = beat % 4 == 0 ? 0.6f : 0.3f;
+    for (size_t i = 0; i < static_cast<size_t>(sampleRate / 40) && start + i < signal.size(); i++) {
+        signal[start + i] = static_cast<Sample>(level * sin(2.0 * M_PI * 880.0 * i / sampleRate));
+    }
+}
+
+std::vector<Sample> clickTrack(double bpm, double seconds, int sampleRate) {
+    std::vector<Sample> signal(static_cast<size_t>(seconds * sampleRate), 0.0f);
+    const double beat = 60.0 * sampleRate / bpm;
+    for (size_t n = 0; n * beat < signal.size(); n++) {
+        addClick(signal, static_cast<size_t>(n * beat), n, sampleRate);
+    }
+    return signal;
+}
+
+std::vector<Sample> rampClickTrack(double startBPM, double endBPM, double seconds, int sampleRate) {
+    std::vector<Sample> signal(static_cast<size_t>(seconds * sampleRate), 0.0f);
+    double beats = 0.0;
+    for (size_t n = 0; n < signal.size(); n++) {
+        double bpm = startBPM + (endBPM - startBPM) * n / signal.size();
+        double next = beats + bpm / (60.0 * sampleRate);
+        if (n == 0 || std::floor(next) > std::floor(beats)) {
+            addClick(signal, n, static_cast<size_t>(std::floor(next)), sampleRate);
+        }
+        beats = next;
+    }
+    return signal;
+}
@@ -4,10 +4,17 @@
 #include <cmath>
 #include <string>
 
+#include "common.h"
 #include "STFT.h"
 #include "hammingFunction.h"
 
 // STFT helpers
 std::vector<double> generateSineWave(double frequency, double sampleRate, double duration);
 std::vector<double> generateConstantSignal(double value, double sampleRate, double duration);
-float extractFundamentalFrequency(const std::vector<std::vector<double>>& spectrogram, double sampleRate);
\ No newline at end of file
+float extractFundamentalFrequency(const Spectrogram& spectrogram, double sampleRate);
+
+// Tempo helpers: 25 ms 880 Hz bursts on every beat, with every fourth beat
+// accented.
+std::vector<Sample> clickTrack(double bpm, double seconds, int sampleRate);
+// Same, with the tempo moving linearly from startBPM to endBPM.
+std::vector<Sample> rampClickTrack(double startBPM, double endBPM, double seconds, int sampleRate);
\ No newline at end of file
@@ -0,0 +1,92 @@
+#include <gtest/gtest.h>
+#include <atomic>
+#include <chrono>
+#include <stdexcept>
+#include <vector>
+#include "threadPool.h"
+
+TEST(ThreadPoolTest, CoversEveryIndexOnce) {
+    ThreadPool pool(4);
+    std::vector<int> hits(1000, 0);
+    pool.parallelFor(hits.size(), 7, [&](size_t begin, size_t end, size_t worker) {
+        ASSERT_LT(worker, pool.size());
+        for (size_t i = begin; i < end; i++) {
+            hits[i]++;
+        }
+    });
+    for (int count : hits) {
+        EXPECT_EQ(count, 1);
+    }
+}
+
+TEST(ThreadPoolTest, ReusableAcrossJobs) {
+    ThreadPool pool(3);
+    for (int job = 0; job < 50; job++) {
+        std::atomic<size_t> total(0);
+        pool.parallelFor(100, 1, [&](size_t begin, size_t end, size_t) {
+            total += end - begin;
+        });
+        EXPECT_EQ(total.load(), 100u);
+    }
+}
+
+TEST(ThreadPoolTest, SingleThreadRunsOnCaller) {
+    ThreadPool pool(1);
+    EXPECT_EQ(pool.size(), 1u);
+    size_t calls = 0;
+    pool.parallelFor(10, 2, [&](size_t begin, size_t end, size_t worker) {
+        EXPECT_EQ(worker, 0u);
+        EXPECT_EQ(begin, 0u);
+        EXPECT_EQ(end, 10u);
+        calls++;
+    });
+    EXPECT_EQ(calls, 1u);
+}
+
+TEST(ThreadPoolTest, NestedCallRunsSerially) {
+    ThreadPool pool(4);
+    std::atomic<size_t> total(0);
+    pool.parallelFor(8, 1, [&](size_t, size_t, size_t) {
+        pool.parallelFor(10, 1, [&](size_t begin, size_t end, size_t) {
+            total += end - begin;
+        });
+    });
+    EXPECT_EQ(total.load(), 80u);
+}
+
+TEST(ThreadPoolTest, RethrowsException) {
+    ThreadPool pool(4);
+    EXPECT_THROW(pool.parallelFor(100, 1, [](size_t begin, size_t, size_t) {
+        if (begin == 42) throw std::runtime_error("chunk failed");
+    }), std::runtime_error);
+
+    // The pool is still usable afterwards.
+    std::atomic<size_t> total(0);
+    pool.parallelFor(10, 1, [&](size_t begin, size_t end, size_t) { total += end - begin; });
+    EXPECT_EQ(total.load(), 10u);
+}
+
+TEST(ThreadPoolTest, IdleWorkersStealFromABusyOne) {
+    // Worker 0 starts on chunk 0 of its share [0, 25) and stalls there until
+    // another worker has run one of its later chunks, which it can only have
+    // stolen.
+    ThreadPool pool(4);
+    std::vector<size_t> ranBy(100, pool.size());
+    std::atomic<bool> stolen(false);
+    pool.parallelFor(ranBy.size(), 1, [&](size_t begin, size_t, size_t worker) {
+        ranBy[begin] = worker;
+        if (begin == 0) {
+            auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+            while (!stolen && std::chrono::steady_clock::now() < deadline) {
+                std::this_thread::yield();
+            }
+        } else if (begin < 25 && worker != 0) {
+            stolen = true;
+        }
+    });
+    EXPECT_TRUE(stolen.load());
+    EXPECT_EQ(ranBy[0], 0u);
+    for (size_t worker : ranBy) {
+        EXPECT_LT(worker, pool.size());
+    }
+}
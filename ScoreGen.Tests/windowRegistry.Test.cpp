@@ -0,0 +1,66 @@
+#define FP_TOL 1e-6
+#define _USE_MATH_DEFINES
+
+#include <gtest/gtest.h>
+#include <cmath>
+#include <stdexcept>
+#include "windowRegistry.h"
+#include "windowTables.h"
+
+static_assert(windowtables::hanning(0, 2048) == 0.0, "window tables are evaluated at compile time");
+
+class PrecompiledWindowTest : public ::testing::TestWithParam<int> {};
+
+// The compile-time tables must agree with the runtime formulas.
+TEST_P(PrecompiledWindowTest, MatchesRuntimeFormula) {
+    const int size = GetParam();
+    Span<const double> hamming = WindowRegistry::instance().get<double>(WindowType::Hamming, size);
+    Span<const double> hanning = WindowRegistry::instance().get<double>(WindowType::Hanning, size);
+    Span<const float> hanningF = WindowRegistry::instance().get<float>(WindowType::Hanning, size);
+    ASSERT_EQ(hamming.size(), static_cast<size_t>(size));
+
+    for (int i = 0; i < size; i++) {
+        double phase = (2 * M_PI * i) / (size - 1);
+        EXPECT_NEAR(hamming[i], 0.54 - 0.46 * cos(phase), 1e-15);
+        EXPECT_NEAR(hanning[i], 0.5 * (1 - cos(phase)), 1e-15);
+        EXPECT_EQ(hanningF[i], static_cast<float>(hanning[i]));
+    }
+}
+
+INSTANTIATE_TEST_SUITE_P(Sizes, PrecompiledWindowTest, ::testing::Values(512, 1024, 2048, 4096));
+
+TEST(WindowRegistryTest, SharesTables) {
+    WindowRegistry& registry = WindowRegistry::instance();
+    EXPECT_EQ(registry.get<double>(WindowType::Hanning, 2048).data(),
+              registry.get<double>(WindowType::Hanning, 2048).data());
+    EXPECT_EQ(registry.get<double>(WindowType::BlackmanHarris, 300).data(),
+              registry.get<double>(WindowType::BlackmanHarris, 300).data());
+    EXPECT_NE(registry.get<double>(WindowType::Kaiser, 300, 5.0).data(),
+              registry.get<double>(WindowType::Kaiser, 300, 8.0).data());
+}
+
+TEST(WindowRegistryTest, TablesAreAligned) {
+    const size_t alignment = AlignedBuffer<double>::ALIGNMENT;
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(WindowRegistry::instance().get<double>(WindowType::Hamming, 2048).data()) % alignment, 0u);
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(WindowRegistry::instance().get<float>(WindowType::Kaiser, 777).data()) % alignment, 0u);
+}
+
+TEST(WindowRegistryTest, BlackmanHarrisValues) {
+    Span<const double> window = WindowRegistry::instance().get<double>(WindowType::BlackmanHarris, 101);
+    EXPECT_NEAR(window[0], 0.35875 - 0.48829 + 0.14128 - 0.01168, FP_TOL);
+    EXPECT_NEAR(window[50], 1.0, FP_TOL);
+    EXPECT_DOUBLE_EQ(window[10], window[90]);
+}
+
+TEST(WindowRegistryTest, KaiserValues) {
+    const double beta = 6.0;
+    Span<const double> window = WindowRegistry::instance().get<double>(WindowType::Kaiser, 101, beta);
+    // Endpoints are 1 / I0(beta); I0(6) = 67.2344070132...
+    EXPECT_NEAR(window[0], 1.0 / 67.23440701317, 1e-9);
+    EXPECT_NEAR(window[100], window[0], 1e-15);
+    EXPECT_NEAR(window[50], 1.0, FP_TOL);
+}
+
+TEST(WindowRegistryTest, InvalidSize) {
+    EXPECT_THROW(WindowRegistry::instance().get<double>(WindowType::Kaiser, 1), std::invalid_argument);
+}
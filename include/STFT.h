@@ -5,7 +5,18 @@
 
 #include <fftw3.h>
 #include <vector>
+#include "spectrogram.h"
+#include "threadPool.h"
 
-std::vector<std::vector<double>> STFT(const std::vector<double>& data, int windowLength, int hopSize);
+// Magnitude STFT with a Hamming window. The last frame is zero-padded.
+// S is the spectrogram storage type (STFT<float>(...) for float storage);
+// T is the input sample type. Instantiated for float and double of each.
+// The FFT itself always runs in double precision.
+template <typename S = double, typename T>
+BasicSpectrogram<S> STFT(const std::vector<T>& data, int windowLength, int hopSize);
 
-#endif // STFT_H
\ No newline at end of file
+// Same result, with frames partitioned across the pool's workers.
+template <typename S = double, typename T>
+BasicSpectrogram<S> STFT(const std::vector<T>& data, int windowLength, int hopSize, ThreadPool& pool);
+
+#endif // STFT_H
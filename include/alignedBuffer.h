@@ -0,0 +1,102 @@
+#ifndef ALIGNEDBUFFER_H
+#define ALIGNEDBUFFER_H
+
+#include <cstddef>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include <type_traits>
+#include <utility>
+#ifdef _WIN32
+#include <malloc.h>
+#endif
+
+// Fixed-size, zero-initialized array of trivially copyable elements whose
+// storage starts on a cache-line boundary, so SIMD loops and FFTW can use
+// aligned loads. Unlike std::vector it never over-allocates.
+template <typename T>
+class AlignedBuffer {
+    static_assert(std::is_trivially_copyable<T>::value, "AlignedBuffer holds plain sample types");
+
+public:
+    static const size_t ALIGNMENT = 64;
+
+    AlignedBuffer() : data_(nullptr), size_(0){}
+    explicit AlignedBuffer(size_t size) : data_(nullptr), size_(0){ resize(size); }
+    ~AlignedBuffer(){ release(); }
+
+    AlignedBuffer(const AlignedBuffer& other) : data_(nullptr), size_(0){
+        resize(other.size_);
+        if (size_ > 0){
+            std::memcpy(data_, other.data_, size_ * sizeof(T));
+        }
+    }
+    AlignedBuffer& operator=(const AlignedBuffer& other){
+        if (this != &other){
+            AlignedBuffer copy(other);
+            swap(copy);
+        }
+        return *this;
+    }
+    AlignedBuffer(AlignedBuffer&& other) noexcept : data_(other.data_), size_(other.size_){
+        other.data_ = nullptr;
+        other.size_ = 0;
+    }
+    AlignedBuffer& operator=(AlignedBuffer&& other) noexcept{
+        swap(other);
+        return *this;
+    }
+
+    // Discards the contents and reallocates `size` zeroed elements.
+    void resize(size_t size){
+        release();
+        if (size == 0){
+            return;
+        }
+        size_t bytes = size * sizeof(T);
+#ifdef _WIN32
+        data_ = static_cast<T*>(_aligned_malloc(bytes, ALIGNMENT));
+#else
+        void* p = nullptr;
+        data_ = posix_memalign(&p, ALIGNMENT, bytes) == 0 ? static_cast<T*>(p) : nullptr;
+#endif
+        if (!data_){
+            throw std::bad_alloc();
+        }
+        std::memset(data_, 0, bytes);
+        size_ = size;
+    }
+
+    void swap(AlignedBuffer& other) noexcept{
+        std::swap(data_, other.data_);
+        std::swap(size_, other.size_);
+    }
+
+    T* data(){ return data_; }
+    const T* data() const{ return data_; }
+    size_t size() const{ return size_; }
+    bool empty() const{ return size_ == 0; }
+
+    T& operator[](size_t i){ return data_[i]; }
+    const T& operator[](size_t i) const{ return data_[i]; }
+    T* begin(){ return data_; }
+    T* end(){ return data_ + size_; }
+    const T* begin() const{ return data_; }
+    const T* end() const{ return data_ + size_; }
+
+private:
+    void release(){
+#ifdef _WIN32
+        _aligned_free(data_);
+#else
+        free(data_);
+#endif
+        data_ = nullptr;
+        size_ = 0;
+    }
+
+    T* data_;
+    size_t size_;
+};
+
+#endif // ALIGNEDBUFFER_H
@@ -0,0 +1,65 @@
+#ifndef ANALYSISCONTEXT_H
+#define ANALYSISCONTEXT_H
+
+#include <memory>
+#include "common.h"
+#include "pitchEstimator.h"
+#include "scratchArena.h"
+#include "span.h"
+#include "energyEnvelope.h"
+
+// Analysis parameters for pitch and onset detection.
+#define PITCH_FRAME_SIZE 2048  // larger window for robust pitch detection
+#define PITCH_HOP_SIZE 512     // hop size in samples
+#define ONSET_FRAME_SIZE 512   // smaller window for onset detection
+#define ONSET_HOP_SIZE 256     // higher time resolution
+
+// Frame and hop sizes of the pitch and onset passes. The defaults are the
+// constants above, for audio analysed at its recorded rate (44.1 or 48 kHz).
+// When the signal is resampled to a lower analysis rate first, scaled() keeps
+// every frame's length in seconds: all sizes are multiples of the energy
+// resolution, which is scaled with the rate.
+struct FrameGeometry {
+    size_t energyResolution = ENERGY_ENVELOPE_RESOLUTION;
+    size_t pitchFrameSize = PITCH_FRAME_SIZE;
+    size_t pitchHopSize = PITCH_HOP_SIZE;
+    size_t onsetFrameSize = ONSET_FRAME_SIZE;
+    size_t onsetHopSize = ONSET_HOP_SIZE;
+
+    // Sizes for a signal resampled from nativeRate to analysisRate.
+    static FrameGeometry scaled(int nativeRate, int analysisRate);
+};
+
+// Initial scratch: the windowed frame plus the largest estimator's lag and
+// FFT buffers for PITCH_FRAME_SIZE frames, with room to spare.
+#define ANALYSIS_SCRATCH_BYTES (256 * 1024)
+
+// Per-thread state for frame analysis: the pitch estimator, the shared
+// Hanning window and a scratch arena that every per-frame kernel borrows its
+// frame, lag and FFT buffers from. Frame energies come from an EnergyEnvelope.
+// Once the arena has grown to fit, analysing a frame does no heap allocation.
+// One context per thread.
+class AnalysisContext {
+public:
+    AnalysisContext(int sampleRate, const PitchOptions& pitchOptions, size_t frameSize = PITCH_FRAME_SIZE);
+
+    // Pitch in Hz of the frameSize samples at `frame`, or 0 when the
+    // frame has no clear pitch. windowedRMS is the frame's Hann-windowed RMS
+    // (EnergyEnvelope::hannRMS); quiet frames are gated without windowing.
+    double pitchFrame(const Sample* frame, double windowedRMS);
+
+    // True when the onset-frame RMS rose enough since the previous frame.
+    static bool isOnset(double rms, double prevRMS);
+
+    int sampleRate() const;
+    ScratchArena& scratch();
+
+private:
+    int sampleRate_;
+    size_t frameSize_;
+    Span<const Sample> window_;   // shared table from WindowRegistry
+    std::unique_ptr<PitchEstimator> estimator_;
+    ScratchArena scratch_;
+};
+
+#endif // ANALYSISCONTEXT_H
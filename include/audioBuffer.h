@@ -0,0 +1,43 @@
+#ifndef AUDIOBUFFER_H
+#define AUDIOBUFFER_H
+
+#include <string>
+#include <vector>
+#include <cstddef>
+#include "audioStream.h"
+
+// Holds a decoded, mono-mixed signal so every dsp() stage can share it by
+// reference instead of re-opening and re-decoding the input file.
+// Optional leading silence is reserved in the same allocation so stages that
+// want a padded signal (e.g. tempo detection) can read it without a copy.
+class AudioBuffer {
+public:
+    AudioBuffer();
+    ~AudioBuffer();
+
+    // Decodes the whole file at path, mixing multi-channel audio down to mono.
+    // Returns false if the file cannot be opened.
+    bool load(const std::string& path, size_t leadingSilence = 0);
+
+    // Decodes the remainder of an already opened stream.
+    bool load(AudioStream& stream, size_t leadingSilence = 0);
+
+    // Decoded samples, excluding any leading silence.
+    const Sample* data() const;
+    size_t size() const;
+
+    // Decoded samples including the leading silence.
+    const Sample* padded() const;
+    size_t paddedSize() const;
+
+    int sampleRate() const;
+    int channels() const;
+
+private:
+    std::vector<Sample> samples_;
+    size_t leadingSilence_;
+    int sampleRate_;
+    int channels_;
+};
+
+#endif // AUDIOBUFFER_H
@@ -0,0 +1,32 @@
+#include <memory>
+#include "audioProcessor.h"
+
+#ifndef AUDIOPIPELINE_H
+#define AUDIOPIPELINE_H
+
+// Runs a chain of AudioProcessors without allocating per stage. Stages that
+// support it run in place in the caller's output buffer; otherwise the chain
+// ping-pongs between that buffer and scratch buffers that are kept and
+// reused across run() calls.
+// Instantiated for float and double samples.
+template <typename T>
+class AudioPipeline{
+    public:
+        AudioPipeline();
+        ~AudioPipeline();
+
+        void add(std::unique_ptr<AudioProcessor<T>> processor);
+
+        // Output size of the whole chain for a given input size.
+        size_t outputSize(size_t inputSize) const;
+
+        // `out` must hold at least outputSize(in.size()) samples and may alias
+        // `in`. Returns the number of samples written to out.
+        size_t run(Span<const T> in, Span<T> out);
+
+    private:
+        std::vector<std::unique_ptr<AudioProcessor<T>>> stages_;
+        std::vector<T> scratch_[2];
+};
+
+#endif // AUDIOPIPELINE_H
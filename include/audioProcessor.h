@@ -1,14 +1,26 @@
 #include <string>
 #include <vector>
+#include "span.h"
 
 #ifndef AUDIOPROCESSOR_H
 #define AUDIOPROCESSOR_H
 
+// T is the sample type; float for the analysis chain, double where the
+// extra precision is wanted.
+//
+// Processors read from `in` and write into the caller's `out`, which must
+// hold at least outputSize(in.size()) samples. Processors that report
+// inPlace() accept `out` aliasing `in`, so a chain can run in one buffer.
+template <typename T>
 class AudioProcessor{
 public:
     virtual ~AudioProcessor() = default;
 
-    virtual std::vector<double> process() = 0;
+    virtual size_t outputSize(size_t inputSize) const { return inputSize; }
+    virtual bool inPlace() const { return true; }
+
+    // Returns the number of samples written to out.
+    virtual size_t process(Span<const T> in, Span<T> out) = 0;
 };
 
-#endif // AUDIOPROCESSOR_H
\ No newline at end of file
+#endif // AUDIOPROCESSOR_H
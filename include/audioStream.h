@@ -0,0 +1,37 @@
+#ifndef AUDIOSTREAM_H
+#define AUDIOSTREAM_H
+
+#include <string>
+#include <vector>
+#include <cstddef>
+#include <sndfile.h>
+#include "common.h"
+
+// Block-wise decoder that mixes each block down to mono as it is read.
+// Memory use is bounded by the block size, independent of file length.
+class AudioStream {
+public:
+    AudioStream();
+    ~AudioStream();
+
+    AudioStream(const AudioStream&) = delete;
+    AudioStream& operator=(const AudioStream&) = delete;
+
+    bool open(const std::string& path);
+    void close();
+
+    // Decodes up to `frames` frames into `mono`. Returns the number of frames
+    // written; 0 once the end of the file is reached.
+    size_t read(Sample* mono, size_t frames);
+
+    int sampleRate() const;
+    int channels() const;
+    sf_count_t frames() const;
+
+private:
+    SNDFILE* file_;
+    SF_INFO info_;
+    std::vector<Sample> interleaved_;
+};
+
+#endif // AUDIOSTREAM_H
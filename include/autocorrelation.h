@@ -0,0 +1,44 @@
+#ifndef AUTOCORRELATION_H
+#define AUTOCORRELATION_H
+
+#include <cstddef>
+#include <fftw3.h>
+#include "scratchArena.h"
+
+// Frames up to this many samples always use the direct lag loop.
+#define AUTOCORRELATION_DIRECT_MAX_SIZE 64
+
+// Computes the raw autocorrelation r[lag] = sum_i x[i] * x[i + lag] for
+// lag = 0..maxLag. Large frames go through a zero-padded real FFT
+// (Wiener-Khinchin: r = IFFT(|FFT(x)|^2)), which is O(M log M) instead of
+// O(size * maxLag). Plans come from FFTPlanCache. The padded FFT buffers are
+// borrowed from a ScratchArena: the caller's (e.g. an AnalysisContext's), or
+// the instance's own when none is passed, so reuse an instance across frames.
+// One instance per thread.
+// compute() is instantiated for float and double input.
+class Autocorrelator {
+public:
+    // `out` receives maxLag + 1 values; maxLag must be below size.
+    template <typename T>
+    void compute(const T* frame, size_t size, size_t maxLag, double* out);
+    template <typename T>
+    void compute(const T* frame, size_t size, size_t maxLag, double* out, ScratchArena& scratch);
+
+    // The O(size * maxLag) reference loop.
+    template <typename T>
+    static void computeDirect(const T* frame, size_t size, size_t maxLag, double* out);
+
+    // Fixed-window variant: out[lag] = sum_{i < window} x[i] * x[i + lag], so
+    // every lag sums the same number of terms (YIN's difference function needs
+    // this). window + maxLag must not exceed size.
+    template <typename T>
+    void computeWindowed(const T* frame, size_t size, size_t window, size_t maxLag, double* out);
+    template <typename T>
+    void computeWindowed(const T* frame, size_t size, size_t window, size_t maxLag, double* out,
+                         ScratchArena& scratch);
+
+private:
+    ScratchArena scratch_;
+};
+
+#endif // AUTOCORRELATION_H
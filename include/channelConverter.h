@@ -3,16 +3,20 @@
 #ifndef CHANNELCONVERTER_H
 #define CHANNELCONVERTER_H
 
-class ChannelConverter : public AudioProcessor{
+// Averages interleaved multi-channel samples down to mono. Safe in place:
+// each output sample is written at or before the frame it was read from.
+// Instantiated for float and double samples.
+template <typename T>
+class ChannelConverter : public AudioProcessor<T>{
     public:
-        ChannelConverter(const int& channels, const std::vector<double>& data);
+        explicit ChannelConverter(int channels);
         ~ChannelConverter();
 
-        std::vector<double> process() override;
+        size_t outputSize(size_t inputSize) const override;
+        size_t process(Span<const T> in, Span<T> out) override;
 
     private:
         const int channels_;
-        const std::vector<double> data_;
 };
 
-#endif // CHANNELCONVERTER_H
\ No newline at end of file
+#endif // CHANNELCONVERTER_H
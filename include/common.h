@@ -2,14 +2,24 @@
 #define COMMON_H
 
 #include <string>
+#include <vector>
+
+// Sample type of the analysis chain. Single precision halves memory traffic,
+// doubles SIMD lane width and matches aubio's smpl_t, so buffers can be handed
+// to aubio without conversion. Accumulations still use double.
+typedef float Sample;
+
+// MIDI note number standing for a rest; pitched notes are 0 to 127.
+#define REST_MIDI -1
 
 struct XMLNote {
-    std::string pitch; // Note pitch (e.g., "C")
-    int alter = 0; // Chromatic alteration 
-    int octave; // Octave
+    int midi = REST_MIDI; // MIDI note number (e.g., 60 for C4)
+    int alter = 0; // Chromatic alteration the pitch is spelled with
     int duration; // Duration in divisions
     std::string type; // Note type (i.e. quarter, half, etc.)
-    bool isRest = false; // Rest note flag
+    bool chord = false; // Sounds with the previous note (MusicXML <chord/>)
+
+    bool isRest() const { return midi == REST_MIDI; }
 };
 
 struct DSPResult {
@@ -23,8 +33,9 @@ struct DSPResult {
 struct Note {
     float startTime;
     float endTime;
-    std::string pitch;
+    int midi;           // MIDI note number, REST_MIDI for a rest
     std::string type;   // Note type (e.g., "quarter", "eighth")
+    bool chord = false; // Starts with the previous note as part of a chord
 };
 
 #endif
\ No newline at end of file
@@ -8,14 +8,83 @@
 #define SF_WIN_S 128
 #define SF_HOP_S 64
 
+// Relative difference within which two tempo estimates agree.
+#define TEMPO_CONSENSUS_TOLERANCE 0.04
+
 #include <iostream>
 #include <vector>
 #include <string>
 #include <map>
 #include <cmath>
 #include <algorithm>
+#include <future>
+#include <memory>
 #include <aubio/aubio.h>
+#include "common.h"
+#include "frameDriver.h"
+
+// Incremental front end to the aubio tempo detector. Samples can be pushed in
+// blocks of any size; they are fed to aubio one hop at a time, so the result
+// is the same as running getBufferBPM() over the concatenated blocks.
+// As a FrameConsumer it takes one hop per frame from a FrameDriver shared
+// with the other analyses.
+class TempoTracker : public FrameConsumer {
+public:
+    TempoTracker(int sample_rate, const std::map<std::string, std::string>& params = {});
+    ~TempoTracker();
+
+    TempoTracker(const TempoTracker&) = delete;
+    TempoTracker& operator=(const TempoTracker&) = delete;
+
+    // Sample matches aubio's smpl_t, so whole hops of a Sample block are
+    // read by aubio in place; double blocks are narrowed into the hop buffer.
+    void push(const Sample* buf, size_t size);
+    void push(const double* buf, size_t size);
+    void pushSilence(size_t size);
+
+    size_t frameSize() const override;
+    size_t hopSize() const override;
+    void consume(const Sample* frame, size_t start) override;
+    void flush(const Sample* rest, size_t size) override;
+
+    // Flushes the last partial hop and returns the median BPM of all beats.
+    float finish();
+
+private:
+    void processHop(const smpl_t* hop);
+
+    int win_s_;
+    int hop_s_;
+    size_t filled_; // samples in the hop buffer (input_)
+    aubio_tempo_t* tempo_;
+    fvec_t* input_;
+    fvec_t* tempo_out_;
+    std::vector<float> beats_;
+};
+
+// Tempo the window configurations agree on. confidence is the share of
+// configurations behind it: each counts fully when it found the same tempo
+// and half when it found half or twice of it.
+struct TempoConsensus {
+    float bpm = 0.0f;        // 0 when no configuration found beats
+    float confidence = 0.0f; // 0 to 1
+};
 
 float calculateMedian(const std::vector<float>& values);
+
+// Votes over tempo estimates (0 for none). Every estimate is a candidate; the
+// one with the most support wins, the earliest on a tie, and the agreed tempo
+// is the mean of its supporters brought into its octave.
+TempoConsensus reconcileTempi(const std::vector<float>& estimates);
+
+// "mode" selects the window configuration: "default", "fast", "super-fast",
+// or "consensus" for the bpm of getConsensusBPM.
 float getBufferBPM(const std::vector<double>& buf, int sample_rate, const std::map<std::string, std::string>& params = {});
+float getBufferBPM(const Sample* buf, size_t size, int sample_rate, const std::map<std::string, std::string>& params = {});
+float getBufferBPM(const double* buf, size_t size, int sample_rate, const std::map<std::string, std::string>& params = {});
+
+// Runs the "default", "fast" and "super-fast" trackers over the same buffer,
+// each on a thread of its own, and reconciles their tempos.
+TempoConsensus getConsensusBPM(const Sample* buf, size_t size, int sample_rate);
+TempoConsensus getConsensusBPM(const double* buf, size_t size, int sample_rate);
 #endif // DETERMINE_BPM_H
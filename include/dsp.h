@@ -1,16 +1,50 @@
 #ifndef DSP_H
 #define DSP_H
 
+#include <future>
 #include <iostream>
+#include <stdexcept>
+#include <string>
 #include <vector>
 #include <sndfile.h>
+#include "audioBuffer.h"
+#include "audioStream.h"
 #include "note_duration_extractor.h"
+#include "polyphonicDetector.h"
 #include "determineBPM.h"
 #include "common.h"
 #include "findKey.h"
+#include "pitchSpelling.h"
+#include "resampler.h"
+#include "tempogram.h"
+#include "tempoMap.h"
+
+#define MIN_ANALYSIS_RATE 8000 // lowest nonzero analysisRate; frames get too short below it
 
 using namespace std;
 
-DSPResult dsp(char const* input_file);
+// Runs tempo, pitch and onset analysis on input_file from a single decode of
+// the samples, with tempo detection running alongside the other analysis.
+// Long files (or any file when streaming is true) are decoded and analysed
+// block by block so memory use does not grow with the length of the
+// recording. With polyphonic set, chords are detected instead of a single
+// melody line. A nonzero analysisRate (e.g. 11025 or 16000) resamples the
+// signal to that rate before melody analysis, which cuts its cost roughly in
+// proportion; tempo and chord detection keep the file's rate. A nonzero
+// analysisRate below MIN_ANALYSIS_RATE throws std::invalid_argument. With
+// tempoMap set, the tempo is estimated window by window (see
+// estimateTempoMap) and notes are segmented and typed at the tempo where they
+// fall, so rubato and drift over a long performance do not skew the later
+// durations.
+DSPResult dsp(char const* input_file, bool streaming = false, bool polyphonic = false, int analysisRate = 0,
+              bool tempoMap = false);
+
+// Converts a note's duration to divisions at the given tempo, or at the tempo
+// map's average over the note; black keys are spelled with sharps.
+XMLNote convertToXMLNote(const Note& note, int bpm);
+XMLNote convertToXMLNote(const Note& note, const TempoMap& tempo);
+
+// Total duration of each pitch class (C = 0 ... B = 11) over the notes.
+std::vector<int> calculatePitchDurations(const std::vector<XMLNote>& xmlNotes);
 
 #endif
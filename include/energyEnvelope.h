@@ -0,0 +1,81 @@
+#ifndef ENERGYENVELOPE_H
+#define ENERGYENVELOPE_H
+
+#include <cstddef>
+#include <vector>
+#include "common.h"
+
+// Granularity of the envelope; divides every analysis frame size and hop.
+#define ENERGY_ENVELOPE_RESOLUTION 256
+
+// Running prefix sums of x^2, kept every `resolution` samples, so the energy
+// or RMS of any window whose start and length are multiples of the resolution
+// costs O(1) however long the window is. Each block's sum is added to the
+// running totals with Neumaier compensated summation, which keeps the
+// differences of large totals accurate on long recordings.
+//
+// Given a Hann length N it also keeps prefix sums of x^2 cos(k theta i) and
+// x^2 sin(k theta i) for k = 1, 2 and theta = 2 pi / (N - 1). Since
+// w(i)^2 = 3/8 - cos(theta i) / 2 + cos(2 theta i) / 8 for the symmetric Hann
+// window, these give the energy of a Hann-windowed frame exactly, in O(1).
+//
+// Samples are appended block by block, and totals no longer needed can be
+// discarded, so a streaming caller keeps the envelope bounded.
+class EnergyEnvelope {
+public:
+    explicit EnergyEnvelope(size_t resolution = ENERGY_ENVELOPE_RESOLUTION, size_t hannLength = 0);
+
+    // Extends the envelope with the next `count` samples of the signal.
+    void append(const Sample* samples, size_t count);
+    // Drops the totals before absolute sample `index`; later queries must
+    // start at or after it.
+    void discardBefore(size_t index);
+
+    // Number of samples appended so far.
+    size_t size() const;
+    size_t resolution() const;
+
+    // Sum of x^2 over [start, start + length). Both must be multiples of the
+    // resolution and the window must have been appended; throws
+    // std::out_of_range otherwise.
+    double energy(size_t start, size_t length) const;
+    double rms(size_t start, size_t length) const;
+
+    // Energy and RMS of the Hann-windowed frame of hannLength samples at
+    // `start` (a multiple of the resolution).
+    double hannEnergy(size_t start) const;
+    double hannRMS(size_t start) const;
+
+private:
+    // Totals over [0, k * resolution) for one k.
+    struct Totals {
+        double energy;
+        double cos1, sin1; // x^2 cos / sin(theta i)
+        double cos2, sin2; // x^2 cos / sin(2 theta i)
+    };
+
+    // Neumaier sum; value() folds the compensation back in.
+    struct CompensatedSum {
+        double sum = 0.0;
+        double compensation = 0.0;
+        void add(double value);
+        double value() const { return sum + compensation; }
+    };
+
+    const Totals& totalsAt(size_t index) const;
+    void closeBlock();
+
+    size_t resolution_;
+    size_t hannLength_;
+    size_t period_;                  // hannLength - 1: the phase table length
+    std::vector<double> phaseTable_; // cos, sin, cos 2x, sin 2x of theta * j, j < period
+
+    std::vector<Totals> totals_;     // totals_[k] covers [0, (firstPoint_ + k) * resolution)
+    size_t firstPoint_;
+    size_t size_;
+    size_t phase_;                   // size_ % period_
+    Totals block_;                   // sums over the unfinished block
+    CompensatedSum running_[5];
+};
+
+#endif // ENERGYENVELOPE_H
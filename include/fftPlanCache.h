@@ -0,0 +1,51 @@
+#ifndef FFTPLANCACHE_H
+#define FFTPLANCACHE_H
+
+#include <fftw3.h>
+#include <map>
+#include <mutex>
+#include <string>
+
+// Planner effort for cached plans. FFTW_MEASURE times candidate algorithms
+// once per size; FFTW_PATIENT searches harder for a faster plan at a higher
+// one-off cost. Either way the cost is paid once per process, and not at all
+// once the plan is in the saved wisdom.
+#define FFT_PLAN_FLAGS FFTW_MEASURE
+
+// Process-wide cache of real-input FFT plans keyed by transform size.
+// Plans are created on scratch arrays and run with the new-array execute
+// functions (fftw_execute_dft_r2c / fftw_execute_dft_c2r), so callers pass
+// their own buffers; those must come from fftw_malloc/fftw_alloc_* to match
+// the alignment the plan was made for.
+// FFTW planning is not thread-safe, so plan creation is serialized here;
+// executing a cached plan is safe from any thread.
+class FFTPlanCache {
+public:
+    static FFTPlanCache& instance();
+
+    FFTPlanCache(const FFTPlanCache&) = delete;
+    FFTPlanCache& operator=(const FFTPlanCache&) = delete;
+
+    // Real to complex, size real inputs to size / 2 + 1 complex outputs.
+    fftw_plan forward(int size);
+    // Complex to real, the inverse of forward() (unnormalized).
+    fftw_plan inverse(int size);
+
+    // FFTW wisdom lets later runs skip measurement for sizes already planned.
+    bool loadWisdom(const std::string& path);
+    // Writes wisdom only if new plans were created since the last load/save.
+    bool saveWisdom(const std::string& path);
+
+private:
+    FFTPlanCache();
+    ~FFTPlanCache();
+
+    fftw_plan plan(std::map<int, fftw_plan>& plans, int size, bool isForward);
+
+    std::mutex mutex_;
+    std::map<int, fftw_plan> forward_;
+    std::map<int, fftw_plan> inverse_;
+    bool dirty_;
+};
+
+#endif // FFTPLANCACHE_H
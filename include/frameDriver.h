@@ -0,0 +1,75 @@
+#ifndef FRAMEDRIVER_H
+#define FRAMEDRIVER_H
+
+#include <cstddef>
+#include <vector>
+#include "common.h"
+#include "alignedBuffer.h"
+
+// The ring holds this many of the largest consumer frame, so each run of a
+// push moves several frames' worth of samples between dispatches.
+#define FRAME_DRIVER_RING_FRAMES 4
+
+// One analysis that reads the signal in frames of its own size and hop
+// (pitch, onset, tempo, spectrum, ...). A FrameDriver calls consume() for
+// every frame in order, then flush() once with whatever is left at the end.
+class FrameConsumer {
+public:
+    virtual ~FrameConsumer() {}
+
+    virtual size_t frameSize() const = 0;
+    virtual size_t hopSize() const = 0;
+
+    // `frame` holds frameSize() samples starting at absolute sample `start`.
+    virtual void consume(const Sample* frame, size_t start) = 0;
+    // The samples from the first unconsumed frame start to the end of the
+    // signal, fewer than frameSize() (possibly none).
+    virtual void flush(const Sample* rest, size_t size) {}
+};
+
+// Single pass over a signal that arrives in blocks of any size, serving every
+// registered consumer its own frame size and hop. Each sample is copied once
+// from the caller's block into a ring a few frames long; consumers read their
+// frames from the ring, which stays in cache, so adding a consumer adds no
+// pass over the signal. A guard region mirrors the start of the ring past its
+// end, so every frame is contiguous however it wraps.
+// Consumers run in the order they were added; one may read state that an
+// earlier one built from the same samples (e.g. an energy envelope).
+class FrameDriver {
+public:
+    FrameDriver();
+
+    FrameDriver(const FrameDriver&) = delete;
+    FrameDriver& operator=(const FrameDriver&) = delete;
+
+    // Consumers are not owned. All must be added before the first push();
+    // throws std::logic_error otherwise.
+    void add(FrameConsumer& consumer);
+
+    void push(const Sample* block, size_t size);
+    // Flushes every consumer; no push() may follow.
+    void finish();
+
+    // Samples pushed so far.
+    size_t size() const;
+
+private:
+    struct Registration {
+        FrameConsumer* consumer;
+        size_t frameSize;
+        size_t hopSize;
+        size_t next; // absolute start of the consumer's next frame
+    };
+
+    void allocate();
+    void dispatch();
+
+    std::vector<Registration> consumers_;
+    AlignedBuffer<Sample> ring_; // capacity_ samples plus the guard
+    size_t capacity_;            // a power of two
+    size_t guard_;               // largest frame size - 1
+    size_t written_;
+    bool finished_;
+};
+
+#endif // FRAMEDRIVER_H
@@ -74,7 +74,14 @@ private:
         int keySignature,
         int divisions);
 
-    // Creates a note element. If note.isRest is true, uses factoryRest; otherwise, factoryNote.
+    // Creates the elements of a note and its chord tones with the given duration,
+    // joined with factoryChord.
+    std::vector<TElement> createChordElements(
+        const std::vector<XMLNote>& chord,
+        int duration,
+        int divisions);
+
+    // Creates a note element. If note.isRest() is true, uses factoryRest; otherwise, factoryNote.
     // The durationOverride parameter allows specifying a partial duration.
     TElement createNoteElement(
         const XMLNote& note,
@@ -0,0 +1,36 @@
+#ifndef MAPPEDFILE_H
+#define MAPPEDFILE_H
+
+#include <string>
+#include <cstddef>
+#include <cstdint>
+
+// Read-only memory mapping of a whole file. The mapping is released when the
+// object is destroyed, so pointers from data() must not outlive it.
+class MappedFile {
+public:
+    MappedFile();
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    bool open(const std::string& path);
+    void close();
+
+    const uint8_t* data() const;
+    size_t size() const;
+    bool isOpen() const;
+
+private:
+    const uint8_t* data_;
+    size_t size_;
+#ifdef _WIN32
+    void* fileHandle_;
+    void* mappingHandle_;
+#else
+    int fd_;
+#endif
+};
+
+#endif // MAPPEDFILE_H
@@ -0,0 +1,21 @@
+#include "audioProcessor.h"
+
+#ifndef NORMALIZER_H
+#define NORMALIZER_H
+
+// Scales the input so its largest absolute sample equals `peak`. Silent
+// input is passed through unchanged.
+// Instantiated for float and double samples.
+template <typename T>
+class Normalizer : public AudioProcessor<T>{
+    public:
+        explicit Normalizer(T peak = 1);
+        ~Normalizer();
+
+        size_t process(Span<const T> in, Span<T> out) override;
+
+    private:
+        const T peak_;
+};
+
+#endif // NORMALIZER_H
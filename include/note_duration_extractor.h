@@ -11,12 +11,139 @@
 #include <string>
 #include <algorithm>
 #include <map>
+#include <memory>
 #include "common.h"
 #include "readWav.h"
-#include "hanningFunction.h"
+#include "analysisContext.h"
+#include "energyEnvelope.h"
+#include "threadPool.h"
+#include "frameDriver.h"
+#include "pitchSpelling.h"
+#include "tempoMap.h"
+
+// Per-frame features from the pitch and onset passes. Segmentation only needs
+// these, so they can be produced from a whole signal or block by block.
+struct FrameAnalysis {
+    int sampleRate = 0;
+    int frameSize = PITCH_FRAME_SIZE;
+    int hopSize = PITCH_HOP_SIZE;
+    std::vector<double> pitchEstimates; // Hz per pitch frame, 0 when unvoiced
+    std::vector<double> onsetTimes;     // seconds
+};
+
+// Onset pass fed from a FrameDriver. One consumer extends an EnergyEnvelope
+// one energy resolution at a time and a second applies the RMS rise test to
+// every onset frame (sizes from the FrameGeometry), appending times (seconds)
+// to onsetTimes. Consumers added to the driver after attach() may read frame
+// energies from envelope().
+class OnsetStream {
+public:
+    OnsetStream(int sampleRate, std::vector<double>& onsetTimes, size_t hannLength = 0,
+                const FrameGeometry& geometry = FrameGeometry());
+
+    OnsetStream(const OnsetStream&) = delete;
+    OnsetStream& operator=(const OnsetStream&) = delete;
+
+    void attach(FrameDriver& driver);
+    const EnergyEnvelope& envelope() const;
+    // Drops envelope totals before `index` that the onset pass has used.
+    void discardBefore(size_t index);
+
+private:
+    struct EnergyFeed : public FrameConsumer {
+        explicit EnergyFeed(OnsetStream& owner) : owner(owner) {}
+        size_t frameSize() const override { return owner.geometry_.energyResolution; }
+        size_t hopSize() const override { return owner.geometry_.energyResolution; }
+        void consume(const Sample* frame, size_t start) override;
+        void flush(const Sample* rest, size_t size) override;
+        OnsetStream& owner;
+    };
+    struct OnsetFrames : public FrameConsumer {
+        explicit OnsetFrames(OnsetStream& owner) : owner(owner) {}
+        size_t frameSize() const override { return owner.geometry_.onsetFrameSize; }
+        size_t hopSize() const override { return owner.geometry_.onsetHopSize; }
+        void consume(const Sample* frame, size_t start) override;
+        OnsetStream& owner;
+    };
+
+    int sampleRate_;
+    FrameGeometry geometry_;
+    std::vector<double>& onsetTimes_;
+    EnergyEnvelope envelope_;
+    EnergyFeed energyFeed_;
+    OnsetFrames onsetFrames_;
+    size_t nextOnsetFrame_;       // absolute start of the next onset frame
+    double prevOnsetRMS_;
+};
+
+// Runs the pitch and onset passes over a signal that arrives in blocks of any
+// size. Only the frames the passes still need are kept (in the driver's ring)
+// and the energy envelope is trimmed to match, so memory is bounded by the
+// frame size while the features match whole-signal analysis.
+// The analyzer is itself the pitch-frame consumer.
+class StreamingFrameAnalyzer : public FrameConsumer {
+public:
+    explicit StreamingFrameAnalyzer(int sampleRate, const PitchOptions& pitchOptions = PitchOptions(),
+                                    const FrameGeometry& geometry = FrameGeometry());
+
+    // Registers the energy, onset and pitch consumers with a driver that may
+    // feed other analyses too (e.g. a TempoTracker); the signal is then
+    // pushed through that driver.
+    void attach(FrameDriver& driver);
+    // Alternatively, push blocks in directly through a driver of its own.
+    void push(const Sample* block, size_t size);
+    const FrameAnalysis& analysis() const;
+
+    size_t frameSize() const override;
+    size_t hopSize() const override;
+    void consume(const Sample* frame, size_t start) override;
+
+private:
+    FrameAnalysis analysis_;
+    AnalysisContext context_;
+    OnsetStream onsets_;
+    std::unique_ptr<FrameDriver> driver_; // only used by push()
+};
+
+// Runs the pitch and onset passes over a whole decoded signal. The energy and
+// onset consumers read the signal in one pass of `driver`, together with any
+// consumers the caller already added to it (such as a TempoTracker); the
+// driver is finished afterwards. Pitch frames are then spread across the pool
+// (the shared pool when none is given). The result is identical to pushing
+// the signal through a StreamingFrameAnalyzer. For a signal resampled to a
+// lower analysis rate, pass FrameGeometry::scaled frame sizes.
+FrameAnalysis analyzeFrames(const Sample* samples, size_t numSamples, int sampleRate, FrameDriver& driver,
+                            ThreadPool& pool, const PitchOptions& pitchOptions = PitchOptions(),
+                            const FrameGeometry& geometry = FrameGeometry());
+FrameAnalysis analyzeFrames(const Sample* samples, size_t numSamples, int sampleRate,
+                            ThreadPool& pool, const PitchOptions& pitchOptions = PitchOptions(),
+                            const FrameGeometry& geometry = FrameGeometry());
+FrameAnalysis analyzeFrames(const Sample* samples, size_t numSamples, int sampleRate,
+                            const PitchOptions& pitchOptions = PitchOptions(),
+                            const FrameGeometry& geometry = FrameGeometry());
+
+// Closest note type ("quarter", "half", ...) for a duration in seconds. The
+// tempo map version counts the beats the map puts between start and end.
+std::string determineNoteType(float noteDuration, int bpm);
+std::string determineNoteType(double startTime, double endTime, const TempoMap& tempo);
+
+// Turns frame features into notes; only this stage depends on the tempo.
+// With a tempo map, the shortest note kept (a sixteenth) and each note's type
+// follow the local tempo.
+std::vector<Note> segmentNotes(const FrameAnalysis& analysis, int bpm);
+std::vector<Note> segmentNotes(const FrameAnalysis& analysis, const TempoMap& tempo);
 
 // Processes the input WAV file and extracts note durations.
 // Returns a vector of Note objects with start time, end time, pitch, and note type.
-std::vector<Note> extract_note_durations(const char* infilename, int bpm);
+// pitchOptions selects the pitch estimator (autocorrelation by default).
+std::vector<Note> extract_note_durations(const char* infilename, int bpm,
+                                         const PitchOptions& pitchOptions = PitchOptions());
+
+// Same as above, but works on an already decoded mono signal so callers that
+// hold the samples (e.g. dsp() via AudioBuffer) do not decode the file again.
+std::vector<Note> extract_note_durations(const std::vector<Sample>& samples, int sampleRate, int bpm,
+                                         const PitchOptions& pitchOptions = PitchOptions());
+std::vector<Note> extract_note_durations(const Sample* samples, size_t numSamples, int sampleRate, int bpm,
+                                         const PitchOptions& pitchOptions = PitchOptions());
 
 #endif // NOTE_DURATION_EXTRACTOR_H
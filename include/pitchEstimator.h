@@ -0,0 +1,119 @@
+#ifndef PITCH_ESTIMATOR_H
+#define PITCH_ESTIMATOR_H
+
+#include <memory>
+#include <vector>
+#include "common.h"
+#include "autocorrelation.h"
+#include "scratchArena.h"
+
+// MPM frames whose best clarity stays below this are reported as unvoiced.
+#define MPM_MIN_CLARITY 0.5
+
+// Coarse-to-fine autocorrelation: the best coarse lags refined at full rate,
+// the shortest period (in decimated samples) searched coarsely, and the
+// anti-aliasing filter length per unit of decimation.
+#define PITCH_COARSE_CANDIDATES 3
+#define PITCH_COARSE_MIN_PERIOD 8
+#define PITCH_DECIMATION_TAPS_PER_FACTOR 8
+
+enum class PitchMethod {
+    Autocorrelation, // normalized autocorrelation peak (the original detector)
+    YIN,             // cumulative-mean-normalized difference function
+    MPM              // McLeod pitch method (normalized square difference)
+};
+
+// Search range and decision threshold for a pitch estimator. The threshold's
+// meaning depends on the method: the minimum normalized correlation for
+// Autocorrelation, the dip level of the normalized difference for YIN, and
+// the fraction of the best clarity a peak must reach for MPM.
+struct PitchOptions {
+    PitchMethod method = PitchMethod::Autocorrelation;
+    double minFrequency = 100.0;
+    double maxFrequency = 2000.0;
+    double threshold = 0.5;
+    // YIN and MPM: evaluate lags one at a time and stop as soon as the answer
+    // is known, instead of computing every lag up front via FFT. The result is
+    // the same either way.
+    bool earlyTermination = true;
+    // Autocorrelation: search the lags on a low-passed copy of the frame
+    // decimated by this factor, then refine the best few candidates at full
+    // rate with parabolic interpolation. 1 searches every lag at full rate.
+    int decimation = 1;
+};
+
+// Recommended options for each method. YIN and MPM search down to the lowest
+// piano octave (C1/C2 scales), which the autocorrelation detector cannot reach.
+PitchOptions defaultPitchOptions(PitchMethod method);
+
+// Estimates the fundamental frequency of one analysis frame. Lag and FFT
+// buffers are borrowed from a ScratchArena for the duration of the call, so
+// estimation does no heap allocation once the arena has grown to fit. Use one
+// instance per thread.
+class PitchEstimator {
+public:
+    virtual ~PitchEstimator() {}
+
+    // Returns the pitch in Hz, or 0 when the frame has no clear pitch.
+    virtual double estimate(const Sample* frame, size_t size, int sampleRate, ScratchArena& scratch) = 0;
+
+    // Same, borrowing from the estimator's own arena.
+    double estimate(const Sample* frame, size_t size, int sampleRate) {
+        return estimate(frame, size, sampleRate, scratch_);
+    }
+
+    // True when the estimator expects a Hanning-windowed frame; false when it
+    // wants the raw samples (tapering biases difference-based methods).
+    virtual bool windowed() const = 0;
+
+private:
+    ScratchArena scratch_;
+};
+
+class AutocorrelationPitchEstimator : public PitchEstimator {
+public:
+    explicit AutocorrelationPitchEstimator(const PitchOptions& options = PitchOptions());
+
+    using PitchEstimator::estimate;
+    double estimate(const Sample* frame, size_t size, int sampleRate, ScratchArena& scratch) override;
+    bool windowed() const override { return true; }
+
+private:
+    double estimateCoarseToFine(const Sample* frame, size_t size, int sampleRate, double r0,
+                                int minLag, int maxLag, ScratchArena& scratch);
+
+    PitchOptions options_;
+    Autocorrelator autocorrelator_;
+    std::vector<double> decimationTaps_; // anti-aliasing low-pass, odd length
+};
+
+class YinPitchEstimator : public PitchEstimator {
+public:
+    explicit YinPitchEstimator(const PitchOptions& options = defaultPitchOptions(PitchMethod::YIN));
+
+    using PitchEstimator::estimate;
+    double estimate(const Sample* frame, size_t size, int sampleRate, ScratchArena& scratch) override;
+    bool windowed() const override { return false; }
+
+private:
+    PitchOptions options_;
+    Autocorrelator autocorrelator_;
+};
+
+class McLeodPitchEstimator : public PitchEstimator {
+public:
+    explicit McLeodPitchEstimator(const PitchOptions& options = defaultPitchOptions(PitchMethod::MPM));
+
+    using PitchEstimator::estimate;
+    double estimate(const Sample* frame, size_t size, int sampleRate, ScratchArena& scratch) override;
+    bool windowed() const override { return false; }
+
+private:
+    PitchOptions options_;
+    Autocorrelator autocorrelator_;
+};
+
+// Builds the estimator selected by options.method.
+std::unique_ptr<PitchEstimator> makePitchEstimator(const PitchOptions& options);
+
+#endif // PITCH_ESTIMATOR_H
@@ -0,0 +1,29 @@
+#ifndef PITCHSPELLING_H
+#define PITCHSPELLING_H
+
+#include <string>
+#include "common.h"
+
+// Pitches travel through the pipeline as MIDI note numbers (REST_MIDI for a
+// rest). A note's spelling is its alteration: the letter and octave follow
+// from the MIDI number with the alteration taken off, so E-flat 4 is
+// (63, -1) and D-sharp 4 is (63, +1). Names are only built for MusicXML
+// emission and log lines.
+
+// Nearest MIDI note to a frequency (A4 = 440 Hz), or REST_MIDI for <= 0 Hz.
+int frequencyToMidi(double frequency);
+
+// Note name with octave, sharps for black keys (e.g. "C#4"), or "Rest".
+std::string midiToNoteString(int midi);
+
+// Alteration for spelling a MIDI note in a key with the given signature
+// (sharps > 0, flats < 0): 0 for white keys, otherwise +1 in sharp keys and
+// C major, -1 in flat keys.
+int spellingAlter(int midi, int keySignature);
+
+// Letter ("C" to "B") and octave of a MIDI note spelled with `alter`.
+// spelledStep throws std::invalid_argument when midi - alter is a black key.
+const char* spelledStep(int midi, int alter);
+int spelledOctave(int midi, int alter);
+
+#endif // PITCHSPELLING_H
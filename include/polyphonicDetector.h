@@ -0,0 +1,143 @@
+#ifndef POLYPHONIC_DETECTOR_H
+#define POLYPHONIC_DETECTOR_H
+
+#include <bitset>
+#include <memory>
+#include <vector>
+#include "common.h"
+#include "alignedBuffer.h"
+#include "threadPool.h"
+#include "frameDriver.h"
+#include "note_duration_extractor.h"
+
+// Piano keys covered by the template dictionary: A0 (MIDI 21) to C8 (MIDI 108).
+#define PIANO_LOWEST_MIDI 21
+#define PIANO_KEYS 88
+
+// Analysis parameters for chord detection. The longer frame resolves
+// neighbouring semitones from the second octave up.
+#define POLY_FRAME_SIZE 4096
+#define POLY_HOP_SIZE 1024
+#define POLY_MAX_PARTIALS 16        // partials per template
+#define POLY_MAX_FREQUENCY 5000.0   // Hz; bins above are ignored
+#define PIANO_INHARMONICITY 4e-4    // stiffness coefficient B of a mid-range string
+
+typedef std::bitset<PIANO_KEYS> KeySet; // bit k is MIDI note PIANO_LOWEST_MIDI + k
+
+struct PolyphonicOptions {
+    int maxPolyphony = 6;           // notes per frame
+    double relativeThreshold = 0.3; // weakest note's amplitude relative to the strongest
+    double minMatch = 0.3;          // cosine of template and residual for a note to count
+    double gateRMS = 0.001;         // windowed RMS below which a frame is silent
+};
+
+// Dictionary of unit-norm magnitude-spectrum templates, one per piano key,
+// for frames of `frameSize` samples under a Hamming window. Partial h of a
+// key with fundamental f0 sits at h f0 sqrt(1 + B h^2) with weight 1 / h and
+// is spread over the bins of the window's main lobe. Templates are stored
+// row by row in aligned memory with each row's nonzero bins recorded, so
+// matching only walks the bins a key can excite.
+class PianoTemplates {
+public:
+    PianoTemplates(int sampleRate, int frameSize);
+
+    size_t numBins() const { return numBins_; }
+    const float* row(int key) const { return values_.data() + key * stride_; }
+    // Nonzero bins of a key's template: [firstBin(key), lastBin(key)),
+    // rounded out to multiples of four.
+    size_t firstBin(int key) const { return range_[2 * key]; }
+    size_t lastBin(int key) const { return range_[2 * key + 1]; }
+
+private:
+    size_t numBins_;                // bins up to POLY_MAX_FREQUENCY
+    size_t stride_;                 // numBins_ rounded up to a multiple of four
+    AlignedBuffer<float> values_;
+    std::vector<size_t> range_;
+};
+
+// Finds the piano keys sounding in one magnitude spectrum by harmonic
+// template matching with iterative cancellation: the key whose template best
+// matches the residual spectrum is taken, its template (scaled to the match)
+// is subtracted, and the search repeats until the next match is too weak.
+// Holds its own residual and score buffers; use one instance per thread.
+class PolyphonicDetector {
+public:
+    PolyphonicDetector(int sampleRate, int frameSize = POLY_FRAME_SIZE,
+                       const PolyphonicOptions& options = PolyphonicOptions());
+
+    // magnitudes holds frameSize / 2 + 1 bins of a Hamming-windowed frame.
+    KeySet detect(const float* magnitudes);
+
+    const PianoTemplates& templates() const { return templates_; }
+
+private:
+    PianoTemplates templates_;
+    PolyphonicOptions options_;
+    int frameSize_;
+    AlignedBuffer<float> residual_;
+    std::vector<float> scores_;
+};
+
+// Per-frame key sets from the chord pass, plus the onsets that split repeated
+// chords.
+struct PolyphonicAnalysis {
+    int sampleRate = 0;
+    int frameSize = POLY_FRAME_SIZE;
+    int hopSize = POLY_HOP_SIZE;
+    std::vector<KeySet> frameKeys;
+    std::vector<double> onsetTimes; // seconds
+};
+
+struct ChordWorker;
+
+// Chord pass over a signal that arrives in blocks of any size: the onset
+// stream plus a spectrum consumer that transforms and matches every
+// POLY_FRAME_SIZE / POLY_HOP_SIZE frame. The result matches
+// analyzePolyphonicFrames over the whole signal.
+class StreamingChordAnalyzer : public FrameConsumer {
+public:
+    explicit StreamingChordAnalyzer(int sampleRate, const PolyphonicOptions& options = PolyphonicOptions());
+    ~StreamingChordAnalyzer();
+
+    // Registers the onset and chord consumers with a driver shared with
+    // other analyses; the signal is then pushed through that driver.
+    void attach(FrameDriver& driver);
+    // Alternatively, push blocks in directly through a driver of its own.
+    void push(const Sample* block, size_t size);
+    const PolyphonicAnalysis& analysis() const;
+
+    size_t frameSize() const override;
+    size_t hopSize() const override;
+    void consume(const Sample* frame, size_t start) override;
+
+private:
+    PolyphonicAnalysis analysis_;
+    OnsetStream onsets_;
+    std::unique_ptr<ChordWorker> worker_;
+    std::unique_ptr<FrameDriver> driver_; // only used by push()
+};
+
+// Runs the chord pass over a whole decoded signal. Onsets are found in one
+// pass of `driver`, together with any consumers the caller already added to
+// it, and the driver is finished; chord frames are then spread across the
+// pool (the shared pool when none is given).
+PolyphonicAnalysis analyzePolyphonicFrames(const Sample* samples, size_t numSamples, int sampleRate,
+                                           FrameDriver& driver, ThreadPool& pool,
+                                           const PolyphonicOptions& options = PolyphonicOptions());
+PolyphonicAnalysis analyzePolyphonicFrames(const Sample* samples, size_t numSamples, int sampleRate,
+                                           ThreadPool& pool, const PolyphonicOptions& options = PolyphonicOptions());
+PolyphonicAnalysis analyzePolyphonicFrames(const Sample* samples, size_t numSamples, int sampleRate,
+                                           const PolyphonicOptions& options = PolyphonicOptions());
+
+// Turns per-frame key sets into notes. Keys that sound together share a
+// start and end time; every key after the lowest of a chord has chord set.
+// With a tempo map, the shortest segment and the note types follow the local
+// tempo.
+std::vector<Note> segmentChords(const PolyphonicAnalysis& analysis, int bpm);
+std::vector<Note> segmentChords(const PolyphonicAnalysis& analysis, const TempoMap& tempo);
+
+// Chord-aware counterpart of extract_note_durations.
+std::vector<Note> extract_chord_durations(const Sample* samples, size_t numSamples, int sampleRate, int bpm,
+                                          const PolyphonicOptions& options = PolyphonicOptions());
+
+#endif // POLYPHONIC_DETECTOR_H
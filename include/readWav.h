@@ -4,7 +4,9 @@
 #include <vector>
 #include <fstream>
 #include <iostream>
+#include <string>
+#include "common.h"
 
-bool readWav(const std::string& filename, std::vector<double>& samples, int& sampleRate);
+bool readWav(const std::string& filename, std::vector<Sample>& samples, int& sampleRate);
 
 #endif // READWAV_H
\ No newline at end of file
@@ -0,0 +1,68 @@
+#include <vector>
+#include "audioProcessor.h"
+
+#ifndef RESAMPLER_H
+#define RESAMPLER_H
+
+// Zero crossings of the windowed-sinc kernel kept either side of its centre,
+// counted at the lower of the two rates.
+#define RESAMPLER_ZERO_CROSSINGS 8
+// Passband edge as a fraction of the lower rate's Nyquist frequency.
+#define RESAMPLER_ROLLOFF 0.9
+
+// Converts a mono signal from one sample rate to another by the rational
+// factor L / M = outputRate / inputRate (reduced by their gcd) with a
+// polyphase FIR filter: each output sample is one dot product of
+// taps-per-phase input samples with the coefficient row of its phase, so the
+// cost is independent of L and no upsampled signal is ever formed. The
+// prototype is a Blackman-windowed sinc cutting off just below the lower
+// rate's Nyquist, which is also the anti-aliasing filter when downsampling.
+// Every phase's row is normalized to unit DC gain.
+//
+// Output sample n sits at input time n * M / L; samples outside the signal
+// count as zeros, and a signal of N samples yields ceil(N * L / M) outputs.
+// process() converts a whole signal; push() and finish() convert one that
+// arrives in blocks and produce the same samples, keeping only the kernel's
+// span of input between calls.
+// Instantiated for float and double samples.
+template <typename T>
+class Resampler : public AudioProcessor<T>{
+    public:
+        // Throws std::invalid_argument unless both rates are positive.
+        Resampler(int inputRate, int outputRate);
+        ~Resampler();
+
+        size_t outputSize(size_t inputSize) const override;
+        bool inPlace() const override { return false; }
+        size_t process(Span<const T> in, Span<T> out) override;
+
+        // Appends the outputs that the samples so far fully determine.
+        void push(const T* block, size_t size, std::vector<T>& out);
+        // Appends the remaining outputs, reading zeros past the end, and
+        // resets the stream.
+        void finish(std::vector<T>& out);
+
+        int inputRate() const { return inputRate_; }
+        int outputRate() const { return outputRate_; }
+        size_t tapsPerPhase() const { return taps_; }
+
+    private:
+        // Output sample n from the input held in data[0, end - base), which
+        // starts at absolute sample base.
+        T outputAt(size_t n, const T* data, size_t base, size_t end) const;
+        size_t totalOutputs(size_t inputSize) const;
+
+        int inputRate_;
+        int outputRate_;
+        size_t up_;                   // L
+        size_t down_;                 // M
+        size_t taps_;                 // coefficients per phase (even)
+        std::vector<T> coefficients_; // phase-major: row p is coefficients_[p * taps_, (p + 1) * taps_)
+
+        std::vector<T> history_;      // streamed input from absolute sample historyBase_
+        size_t historyBase_;
+        size_t received_;             // input samples pushed since the last finish()
+        size_t emitted_;              // outputs produced since the last finish()
+};
+
+#endif // RESAMPLER_H
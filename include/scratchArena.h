@@ -0,0 +1,74 @@
+#ifndef SCRATCHARENA_H
+#define SCRATCHARENA_H
+
+#include <cstddef>
+#include <type_traits>
+#include <vector>
+#include "alignedBuffer.h"
+#include "span.h"
+
+// Bump allocator for per-frame scratch. Kernels borrow aligned, uninitialized
+// arrays inside a Scope and everything is handed back when the scope ends, so
+// the steady state reuses one block with no heap traffic. A request that does
+// not fit spills into an extra block; once the arena is idle again the main
+// block is regrown to the high-water mark, so later frames fit. One arena per
+// thread.
+class ScratchArena {
+public:
+    // Position to roll back to; see mark() / release().
+    struct Marker {
+        size_t used;
+        size_t overflowBlocks;
+    };
+
+    // Releases everything allocated since it was opened.
+    class Scope {
+    public:
+        explicit Scope(ScratchArena& arena) : arena_(arena), marker_(arena.mark()){}
+        ~Scope(){ arena_.release(marker_); }
+
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+
+    private:
+        ScratchArena& arena_;
+        Marker marker_;
+    };
+
+    explicit ScratchArena(size_t initialBytes = 0);
+
+    ScratchArena(const ScratchArena&) = delete;
+    ScratchArena& operator=(const ScratchArena&) = delete;
+
+    // `count` uninitialized elements starting on a cache-line boundary.
+    template <typename T>
+    T* allocate(size_t count){
+        static_assert(std::is_trivially_copyable<T>::value, "ScratchArena holds plain data");
+        return static_cast<T*>(allocateBytes(count * sizeof(T)));
+    }
+
+    template <typename T>
+    Span<T> allocateSpan(size_t count){
+        return Span<T>(allocate<T>(count), count);
+    }
+
+    Marker mark() const;
+    void release(Marker marker);
+
+    // Bytes in the main block.
+    size_t capacity() const;
+    // Number of heap allocations the arena has made, for tests and tuning.
+    size_t heapAllocations() const;
+
+private:
+    void* allocateBytes(size_t bytes);
+
+    AlignedBuffer<unsigned char> block_;
+    size_t used_;
+    std::vector<AlignedBuffer<unsigned char>> overflow_;
+    size_t overflowBytes_;  // bytes live in overflow_
+    size_t highWater_;      // most bytes live at once
+    size_t heapAllocations_;
+};
+
+#endif // SCRATCHARENA_H
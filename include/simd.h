@@ -0,0 +1,11 @@
+#ifndef SIMD_H
+#define SIMD_H
+
+// SSE2 is part of the x86-64 baseline, so MSVC x64 and any x86-64 GCC/Clang
+// build can use it unconditionally. Everything else takes the scalar paths.
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define SCOREGEN_SSE2 1
+#include <emmintrin.h>
+#endif
+
+#endif // SIMD_H
@@ -12,7 +12,13 @@ public:
     ~SndFileHandler();
 
     std::tuple<SF_INFO, std::vector<double>> readSndFile();
-    void writeSndFile(SF_INFO info, std::vector<double> processedData);
+
+    // Reads the whole file into a caller-owned buffer, reusing its capacity.
+    // Samples stay interleaved (frames * channels) and can be handed to
+    // ChannelConverter as-is. Returns false if the file cannot be opened.
+    bool readSndFile(SF_INFO& info, std::vector<double>& interleaved);
+
+    void writeSndFile(SF_INFO info, const std::vector<double>& processedData);
 
 private: 
     const std::string sndInputPath_;
@@ -0,0 +1,33 @@
+#ifndef SPAN_H
+#define SPAN_H
+
+#include <cstddef>
+
+// Non-owning view of a contiguous run of samples (std::span is C++20).
+// Use Span<const T> for read-only input.
+template <typename T>
+class Span {
+public:
+    Span() : data_(nullptr), size_(0){}
+    Span(T* data, size_t size) : data_(data), size_(size){}
+
+    // Any contiguous container with data() and size(), e.g. std::vector.
+    template <typename Container>
+    Span(Container& container) : data_(container.data()), size_(container.size()){}
+
+    T* data() const { return data_; }
+    size_t size() const { return size_; }
+    bool empty() const { return size_ == 0; }
+
+    T& operator[](size_t i) const { return data_[i]; }
+    T* begin() const { return data_; }
+    T* end() const { return data_ + size_; }
+
+    Span subspan(size_t offset, size_t count) const { return Span(data_ + offset, count); }
+
+private:
+    T* data_;
+    size_t size_;
+};
+
+#endif // SPAN_H
@@ -0,0 +1,65 @@
+#ifndef SPECTROGRAM_H
+#define SPECTROGRAM_H
+
+#include <cstddef>
+#include "alignedBuffer.h"
+#include "span.h"
+
+// Every `stride`-th element starting at data; used for bin-major access.
+template <typename T>
+class StridedView {
+public:
+    StridedView(T* data, size_t size, size_t stride) : data_(data), size_(size), stride_(stride){}
+
+    T& operator[](size_t i) const { return data_[i * stride_]; }
+    size_t size() const { return size_; }
+    size_t stride() const { return stride_; }
+    T* data() const { return data_; }
+
+private:
+    T* data_;
+    size_t size_;
+    size_t stride_;
+};
+
+// Magnitude spectrogram held in one aligned, contiguous frame-major buffer:
+// element (frame, bin) lives at frame * numBins() + bin. frame() returns a
+// contiguous row; bin() walks one frequency across all frames by stride.
+// T is the storage type; Spectrogram (double) and SpectrogramF (float) are
+// instantiated.
+template <typename T>
+class BasicSpectrogram {
+public:
+    BasicSpectrogram();
+    BasicSpectrogram(size_t numFrames, size_t numBins);
+
+    size_t numFrames() const { return numFrames_; }
+    size_t numBins() const { return numBins_; }
+    bool empty() const { return numFrames_ == 0; }
+
+    T& operator()(size_t frame, size_t bin) { return values_[frame * numBins_ + bin]; }
+    const T& operator()(size_t frame, size_t bin) const { return values_[frame * numBins_ + bin]; }
+
+    Span<T> frame(size_t frame) { return Span<T>(values_.data() + frame * numBins_, numBins_); }
+    Span<const T> frame(size_t frame) const { return Span<const T>(values_.data() + frame * numBins_, numBins_); }
+
+    StridedView<T> bin(size_t bin) { return StridedView<T>(values_.data() + bin, numFrames_, numBins_); }
+    StridedView<const T> bin(size_t bin) const { return StridedView<const T>(values_.data() + bin, numFrames_, numBins_); }
+
+    // Element distance between consecutive frames / consecutive bins.
+    size_t frameStride() const { return numBins_; }
+    size_t binStride() const { return 1; }
+
+    T* data() { return values_.data(); }
+    const T* data() const { return values_.data(); }
+
+private:
+    size_t numFrames_;
+    size_t numBins_;
+    AlignedBuffer<T> values_;
+};
+
+typedef BasicSpectrogram<double> Spectrogram;
+typedef BasicSpectrogram<float> SpectrogramF;
+
+#endif // SPECTROGRAM_H
@@ -0,0 +1,49 @@
+#ifndef TEMPOMAP_H
+#define TEMPOMAP_H
+
+#include <cstddef>
+#include <vector>
+#include "common.h"
+#include "threadPool.h"
+
+// Windows of the onset envelope whose tempo is estimated on their own. A
+// window spans several bars so its tempogram has enough beats to go on.
+#define TEMPO_MAP_WINDOW_SECONDS 12.0
+#define TEMPO_MAP_HOP_SECONDS 3.0
+#define TEMPO_MAP_SMOOTHING 5          // windows in the running median
+#define TEMPO_MAP_FRAMES_PER_TASK 256 // flux frames per pool task
+
+// Tempo as a function of time: BPM at a series of times (window centres),
+// linear in between and constant before the first and after the last. A map
+// with one point is a constant tempo.
+struct TempoMap {
+    std::vector<double> times; // seconds, increasing
+    std::vector<double> bpms;
+
+    static TempoMap constant(double bpm);
+
+    bool empty() const { return bpms.empty(); }
+    double bpmAt(double seconds) const;
+    // Beats between two times, the integral of bpmAt / 60.
+    double beatsBetween(double start, double end) const;
+    // Tempo that spans the same number of beats over [start, end]; bpmAt(start)
+    // for an empty interval. Exactly the tempo of a constant map.
+    double averageBPM(double start, double end) const;
+    // Median of the points, for reporting one tempo.
+    double medianBPM() const;
+};
+
+// Tempo map of a spectral-flux envelope (see tempogram.h) sampled at
+// framesPerSecond. Overlapping windows are estimated across the pool; each
+// estimate is folded by octaves to the whole envelope's tempo, windows
+// without one take their neighbours' values, and a running median smooths
+// the curve. Envelopes shorter than one window get a single point.
+TempoMap estimateTempoMap(const std::vector<double>& envelope, double framesPerSecond, ThreadPool& pool);
+TempoMap estimateTempoMap(const std::vector<double>& envelope, double framesPerSecond);
+
+// Same from the samples: the flux frames are also spread across the pool (the
+// shared pool when none is given).
+TempoMap estimateTempoMap(const Sample* samples, size_t size, int sampleRate, ThreadPool& pool);
+TempoMap estimateTempoMap(const Sample* samples, size_t size, int sampleRate);
+
+#endif // TEMPOMAP_H
@@ -0,0 +1,103 @@
+#ifndef TEMPOGRAM_H
+#define TEMPOGRAM_H
+
+#include <cstddef>
+#include <fftw3.h>
+#include <memory>
+#include <vector>
+#include "common.h"
+#include "frameDriver.h"
+#include "spectrogram.h"
+#include "span.h"
+
+// Spectral-flux frames: the same window and hop as the aubio tracker's
+// default mode.
+#define TEMPOGRAM_WINDOW 1024
+#define TEMPOGRAM_HOP 512
+#define TEMPOGRAM_COMPRESSION 1.0   // gamma in log(1 + gamma |X|)
+#define TEMPOGRAM_MIN_BPM 40.0
+#define TEMPOGRAM_MAX_BPM 240.0
+#define TEMPOGRAM_PRIOR_BPM 120.0   // centre of the log-normal tempo prior
+#define TEMPOGRAM_PRIOR_OCTAVES 0.5 // its standard deviation
+#define TEMPOGRAM_HARMONICS 4       // multiples of the beat period used to refine it
+
+// Onset strength envelope of a run of magnitude spectra: for every frame, the
+// summed rise of each bin's log-compressed magnitude over the previous frame.
+// The first frame has no predecessor and scores 0. push() is instantiated for
+// float and double magnitudes.
+class SpectralFlux {
+public:
+    explicit SpectralFlux(size_t numBins);
+
+    template <typename T>
+    void push(const T* magnitudes);
+
+    const std::vector<double>& envelope() const { return envelope_; }
+
+private:
+    std::vector<double> previous_;
+    std::vector<double> envelope_;
+};
+
+// Spectral flux of every frame of a spectrogram (e.g. one from STFT()).
+template <typename S>
+std::vector<double> spectralFlux(const BasicSpectrogram<S>& spectrogram);
+
+// Tempo of an onset envelope sampled at framesPerSecond. The envelope's
+// autocorrelation (its tempogram) is weighted by a prior around
+// TEMPOGRAM_PRIOR_BPM to pick the beat period between TEMPOGRAM_MIN_BPM and
+// TEMPOGRAM_MAX_BPM, then the peaks near its first TEMPOGRAM_HARMONICS
+// multiples refine it below one frame. Returns 0 when the envelope spans
+// fewer than two of the slowest beats or has no periodicity.
+float tempogramBPM(const double* envelope, size_t size, double framesPerSecond);
+float tempogramBPM(const std::vector<double>& envelope, double framesPerSecond);
+
+// Tempo from a spectrogram the caller already computed, with frames every
+// hopSize samples.
+template <typename S>
+float tempogramBPM(const BasicSpectrogram<S>& spectrogram, int sampleRate, int hopSize);
+
+// Native tempo estimator: builds the spectral-flux envelope of
+// TEMPOGRAM_WINDOW / TEMPOGRAM_HOP Hamming-windowed frames as they arrive
+// and reads the tempo from its tempogram at the end. The envelope is one
+// value per hop, so no audio is held. The last partial frame is zero-padded,
+// which makes the envelope that of STFT() over the whole signal.
+// As a FrameConsumer it shares a FrameDriver with the other analyses.
+class TempogramTracker : public FrameConsumer {
+public:
+    explicit TempogramTracker(int sampleRate);
+    ~TempogramTracker();
+
+    TempogramTracker(const TempogramTracker&) = delete;
+    TempogramTracker& operator=(const TempogramTracker&) = delete;
+
+    // Pushes blocks of any size through a driver of its own.
+    void push(const Sample* block, size_t size);
+
+    size_t frameSize() const override;
+    size_t hopSize() const override;
+    void consume(const Sample* frame, size_t start) override;
+    void flush(const Sample* rest, size_t size) override;
+
+    // Ends the signal and returns its tempo.
+    float finish();
+
+    const std::vector<double>& envelope() const { return flux_.envelope(); }
+    double framesPerSecond() const;
+
+private:
+    void transform(const Sample* frame, size_t size);
+
+    int sampleRate_;
+    fftw_plan plan_;
+    Span<const double> window_;
+    double* in_;
+    fftw_complex* out_;
+    std::vector<double> magnitudes_;
+    SpectralFlux flux_;
+    std::unique_ptr<FrameDriver> driver_; // only used by push()
+};
+
+float getTempogramBPM(const Sample* buf, size_t size, int sampleRate);
+
+#endif // TEMPOGRAM_H
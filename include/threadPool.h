@@ -0,0 +1,75 @@
+#ifndef THREADPOOL_H
+#define THREADPOOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "alignedBuffer.h"
+
+// Fixed set of worker threads for data-parallel loops. parallelFor() splits
+// [0, count) into chunks of `grain` indices and gives each worker a
+// contiguous share. A worker runs its share front to back; once it runs dry
+// it steals the back half of another worker's remaining chunks, so faster
+// threads take more work while each still walks neighbouring indices. The
+// calling thread works too, as worker 0; pool threads are workers 1..size()-1.
+class ThreadPool {
+public:
+    // numThreads counts the calling thread; 0 means one per hardware thread.
+    explicit ThreadPool(size_t numThreads = 0);
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    // Number of workers, including the calling thread.
+    size_t size() const;
+
+    // Runs body(begin, end, worker) over chunks covering [0, count) and
+    // returns once all have finished. `worker` is in [0, size()) and is unique
+    // among concurrently running chunks, so it can index per-thread scratch.
+    // The first exception thrown by body is rethrown here. Calls made from
+    // inside a body run serially on that worker.
+    void parallelFor(size_t count, size_t grain,
+                     const std::function<void(size_t, size_t, size_t)>& body);
+
+    // Process-wide pool sized to the hardware.
+    static ThreadPool& shared();
+
+private:
+    // Chunk indices [begin, end) still queued for one worker, packed as
+    // begin << 32 | end so a pop or a steal is a single compare-exchange.
+    struct WorkQueue {
+        std::atomic<uint64_t> range;
+        char padding[AlignedBuffer<char>::ALIGNMENT - sizeof(std::atomic<uint64_t>)];
+    };
+
+    void workerLoop(size_t worker);
+    void runChunks(size_t worker);
+    bool popChunk(size_t worker, size_t& chunk);
+    bool stealChunk(size_t worker, size_t& chunk);
+
+    std::vector<std::thread> threads_;
+    std::mutex jobMutex_;   // one parallelFor at a time
+    std::mutex mutex_;
+    std::condition_variable wake_;
+    std::condition_variable done_;
+    const std::function<void(size_t, size_t, size_t)>* body_;
+    size_t count_;
+    size_t grain_;
+    AlignedBuffer<char> queueStorage_; // starts on a cache line, so each queue has one to itself
+    WorkQueue* queues_;                // constructed in queueStorage_
+    std::atomic<bool> cancelled_;
+    size_t active_;         // pool threads still working on the current job
+    uint64_t generation_;   // bumped for every job
+    std::exception_ptr error_;
+    bool stop_;
+};
+
+#endif // THREADPOOL_H
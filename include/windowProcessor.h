@@ -0,0 +1,21 @@
+#include "audioProcessor.h"
+
+#ifndef WINDOWPROCESSOR_H
+#define WINDOWPROCESSOR_H
+
+// Multiplies the input by a window function (e.g. hanningFunction()). Input
+// longer than the window is treated as consecutive frames of window length.
+// Instantiated for float and double samples.
+template <typename T>
+class WindowProcessor : public AudioProcessor<T>{
+    public:
+        explicit WindowProcessor(const std::vector<double>& window);
+        ~WindowProcessor();
+
+        size_t process(Span<const T> in, Span<T> out) override;
+
+    private:
+        std::vector<T> window_;
+};
+
+#endif // WINDOWPROCESSOR_H
@@ -0,0 +1,52 @@
+#ifndef WINDOWREGISTRY_H
+#define WINDOWREGISTRY_H
+
+#include <map>
+#include <memory>
+#include <mutex>
+#include <tuple>
+#include "alignedBuffer.h"
+#include "span.h"
+
+#define KAISER_DEFAULT_BETA 8.6
+
+enum class WindowType {
+    Hamming,
+    Hanning,
+    BlackmanHarris, // 4-term, -92 dB side lobes
+    Kaiser          // shape set by beta
+};
+
+// Process-wide store of immutable window tables keyed by type, length and
+// (for Kaiser) beta. Each table is built once, on first request, in aligned
+// storage and is never freed, so the returned spans stay valid for the life
+// of the process and can be shared freely between threads.
+// Hamming and Hanning tables of 512, 1024, 2048 and 4096 points are
+// generated at compile time (see windowTables.h) and cost nothing to fetch.
+// get() is instantiated for float and double.
+class WindowRegistry {
+public:
+    static WindowRegistry& instance();
+
+    WindowRegistry(const WindowRegistry&) = delete;
+    WindowRegistry& operator=(const WindowRegistry&) = delete;
+
+    // Throws std::invalid_argument if size < 2.
+    template <typename T>
+    Span<const T> get(WindowType type, int size, double beta = KAISER_DEFAULT_BETA);
+
+private:
+    WindowRegistry();
+
+    typedef std::tuple<int, int, double> Key; // type, size, beta
+
+    // Table storage for each sample type; the argument only selects the overload.
+    std::map<Key, std::unique_ptr<AlignedBuffer<double>>>& tables(double*) { return doubleTables_; }
+    std::map<Key, std::unique_ptr<AlignedBuffer<float>>>& tables(float*) { return floatTables_; }
+
+    std::mutex mutex_;
+    std::map<Key, std::unique_ptr<AlignedBuffer<double>>> doubleTables_;
+    std::map<Key, std::unique_ptr<AlignedBuffer<float>>> floatTables_;
+};
+
+#endif // WINDOWREGISTRY_H
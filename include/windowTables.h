@@ -0,0 +1,75 @@
+#ifndef WINDOWTABLES_H
+#define WINDOWTABLES_H
+
+// Compile-time window tables for the common analysis sizes. C++14 has no
+// constexpr std::cos, so a reduced-range Taylor series is used; it agrees
+// with std::cos to within a couple of ulps on [0, 2*pi].
+
+namespace windowtables {
+
+constexpr double PI = 3.14159265358979323846;
+
+// Series for |x| <= pi/4, where 12 terms are well past double precision.
+constexpr double cosSeries(double x) {
+    double x2 = x * x;
+    double term = 1.0;
+    double sum = 1.0;
+    for (int k = 1; k <= 12; k++) {
+        term *= -x2 / ((2 * k - 1) * (2 * k));
+        sum += term;
+    }
+    return sum;
+}
+
+constexpr double sinSeries(double x) {
+    double x2 = x * x;
+    double term = x;
+    double sum = x;
+    for (int k = 1; k <= 12; k++) {
+        term *= -x2 / ((2 * k) * (2 * k + 1));
+        sum += term;
+    }
+    return sum;
+}
+
+// cos(x) for x in [0, 2*pi], folded onto [0, pi/4].
+constexpr double cos(double x) {
+    if (x > PI) {
+        x = 2 * PI - x;
+    }
+    double sign = 1.0;
+    if (x > PI / 2) {
+        x = PI - x;
+        sign = -1.0;
+    }
+    return x > PI / 4 ? sign * sinSeries(PI / 2 - x) : sign * cosSeries(x);
+}
+
+constexpr double hamming(int i, int size) {
+    return 0.54 - 0.46 * windowtables::cos((2 * PI * i) / (size - 1));
+}
+
+constexpr double hanning(int i, int size) {
+    return 0.5 * (1 - windowtables::cos((2 * PI * i) / (size - 1)));
+}
+
+template <typename T, int N>
+struct Table {
+    alignas(64) T values[N];
+};
+
+// Both windows are symmetric, so only the first half is evaluated.
+template <typename T, int N>
+constexpr Table<T, N> makeTable(double (*fn)(int, int)) {
+    Table<T, N> table{};
+    for (int i = 0; i < (N + 1) / 2; i++) {
+        T value = static_cast<T>(fn(i, N));
+        table.values[i] = value;
+        table.values[N - 1 - i] = value;
+    }
+    return table;
+}
+
+} // namespace windowtables
+
+#endif // WINDOWTABLES_H
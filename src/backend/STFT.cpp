@@ -1,65 +1,119 @@
 #include "STFT.h"
-#include "hammingFunction.h"
+#include "windowRegistry.h"
+#include "fftPlanCache.h"
 #include <iostream>
+#include <algorithm>
+#include <cmath>
 
-std::vector<std::vector<double>> STFT(const std::vector<double>& data, int windowSize, int hopSize){
+#define STFT_FRAMES_PER_TASK 16
 
-    fftw_complex* in;
-    fftw_complex* out;
-    fftw_plan planForward;
-
-    // Prepare spectrogram data structure
-    std::vector<std::vector<double>> spectrogram;
-    spectrogram.reserve(data.size() / hopSize);
-
-    // Prepare FFT
-    in = (fftw_complex*)fftw_malloc(sizeof(fftw_complex) * windowSize);
-    out = (fftw_complex*)fftw_malloc(sizeof(fftw_complex) * windowSize);
-    planForward = fftw_plan_dft_1d(windowSize, in, out, FFTW_FORWARD, FFTW_ESTIMATE);
-
-    // Create a hamming window
-    std::vector<double> hammingWindow = hammingFunction(windowSize);
+// Frames start every hopSize samples while the start is inside the signal;
+// the first frame that runs past the end is zero-padded and is the last.
+static size_t countFrames(size_t numSamples, int windowSize, int hopSize){
+    if (numSamples == 0){
+        return 0;
+    }
+    size_t lastFrame = numSamples >= static_cast<size_t>(windowSize)
+        ? (numSamples - windowSize) / hopSize + 1
+        : 0;
+    size_t framesInSignal = (numSamples + hopSize - 1) / hopSize;
+    return std::min(lastFrame + 1, framesInSignal);
+}
 
-    // Perform STFT
-    int chunkPosition = 0;
-    int bStop = 0;
-    int readIndex;
+// Fills frames [first, last) of the spectrogram using the caller's FFT
+// buffers; frames are independent, so disjoint ranges can run concurrently.
+template <typename S, typename T>
+static void computeFrames(const std::vector<T>& data, Span<const double> hammingWindow,
+                          int windowSize, int hopSize, fftw_plan planForward,
+                          double* in, fftw_complex* out,
+                          BasicSpectrogram<S>& spectrogram, size_t first, size_t last){
+    const int numBins = windowSize / 2 + 1;
+    size_t readIndex;
 
-    while(chunkPosition < data.size() && !bStop){
+    for(size_t frame = first; frame < last; frame++){
+        size_t chunkPosition = frame * hopSize;
         for(int i = 0; i < windowSize; i++){
             readIndex = chunkPosition + i;
             if (readIndex < data.size()){
-                in[i][0] = data[readIndex] * hammingWindow[i];
-                in[i][1] = 0.0;
+                in[i] = data[readIndex] * hammingWindow[i];
             }
             else{
-                in[i][0] = 0.0;
-                in[i][1] = 0.0;
-                bStop = 1;
+                in[i] = 0.0;
             }
         }
         // Perform FFT on frame
-        fftw_execute(planForward);
-
-        // Add to spectrogram data structure
-        // A 2D vector where each row is a time frame and each column is a frequency bin
-        // Frequency information at a specific time frame : std::vector<double> spectrogram[timeIndex]
-        // To analyze a single frequency over a time : double magnitude = spectrogram[frameIndex][freqIndex];
-        std::vector<double> freqMagnitudes;
-        freqMagnitudes.reserve(windowSize / 2 + 1);
+        fftw_execute_dft_r2c(planForward, in, out);
 
-        for(int i = 0; i < windowSize / 2 + 1; i++){
-            freqMagnitudes.push_back(sqrt(out[i][0] * out[i][0] + out[i][1] * out[i][1]));
+        // Frequency information at a specific time frame : spectrogram.frame(timeIndex)
+        // To analyze a single frequency over time : spectrogram.bin(freqIndex)
+        S* freqMagnitudes = spectrogram.frame(frame).data();
+        for(int i = 0; i < numBins; i++){
+            freqMagnitudes[i] = static_cast<S>(sqrt(out[i][0] * out[i][0] + out[i][1] * out[i][1]));
         }
-
-        spectrogram.push_back(freqMagnitudes);
-        chunkPosition += hopSize;
     }
+}
+
+template <typename S, typename T>
+BasicSpectrogram<S> STFT(const std::vector<T>& data, int windowSize, int hopSize){
+
+    // Prepare spectrogram data structure: one contiguous frame-major buffer
+    // sized up front instead of a heap allocation per frame.
+    const size_t numFrames = countFrames(data.size(), windowSize, hopSize);
+    BasicSpectrogram<S> spectrogram(numFrames, windowSize / 2 + 1);
+
+    // Prepare FFT. The input is real, so an r2c transform yields only the
+    // windowSize / 2 + 1 non-redundant bins for about half the work. The plan
+    // comes from the process-wide cache, so repeated calls skip planning.
+    double* in = fftw_alloc_real(windowSize);
+    fftw_complex* out = fftw_alloc_complex(windowSize / 2 + 1);
+    fftw_plan planForward = FFTPlanCache::instance().forward(windowSize);
+
+    // Shared hamming window table
+    Span<const double> hammingWindow = WindowRegistry::instance().get<double>(WindowType::Hamming, windowSize);
 
-    // clean up
-    fftw_destroy_plan(planForward);
+    // Perform STFT
+    computeFrames(data, hammingWindow, windowSize, hopSize, planForward, in, out, spectrogram, 0, numFrames);
+
+    // clean up; the plan stays in the cache
     fftw_free(in);
     fftw_free(out);
 
     return spectrogram;
-}
\ No newline at end of file
+}
+
+template <typename S, typename T>
+BasicSpectrogram<S> STFT(const std::vector<T>& data, int windowSize, int hopSize, ThreadPool& pool){
+    const size_t numFrames = countFrames(data.size(), windowSize, hopSize);
+    BasicSpectrogram<S> spectrogram(numFrames, windowSize / 2 + 1);
+
+    // One plan shared by all workers (new-array execute is thread-safe), one
+    // pair of FFT buffers per worker.
+    fftw_plan planForward = FFTPlanCache::instance().forward(windowSize);
+    Span<const double> hammingWindow = WindowRegistry::instance().get<double>(WindowType::Hamming, windowSize);
+    std::vector<double*> in(pool.size());
+    std::vector<fftw_complex*> out(pool.size());
+    for (size_t worker = 0; worker < pool.size(); worker++){
+        in[worker] = fftw_alloc_real(windowSize);
+        out[worker] = fftw_alloc_complex(windowSize / 2 + 1);
+    }
+
+    pool.parallelFor(numFrames, STFT_FRAMES_PER_TASK, [&](size_t first, size_t last, size_t worker){
+        computeFrames(data, hammingWindow, windowSize, hopSize, planForward,
+                      in[worker], out[worker], spectrogram, first, last);
+    });
+
+    for (size_t worker = 0; worker < pool.size(); worker++){
+        fftw_free(in[worker]);
+        fftw_free(out[worker]);
+    }
+    return spectrogram;
+}
+
+template BasicSpectrogram<double> STFT<double, float>(const std::vector<float>& data, int windowSize, int hopSize);
+template BasicSpectrogram<double> STFT<double, double>(const std::vector<double>& data, int windowSize, int hopSize);
+template BasicSpectrogram<float> STFT<float, float>(const std::vector<float>& data, int windowSize, int hopSize);
+template BasicSpectrogram<float> STFT<float, double>(const std::vector<double>& data, int windowSize, int hopSize);
+template BasicSpectrogram<double> STFT<double, float>(const std::vector<float>& data, int windowSize, int hopSize, ThreadPool& pool);
+template BasicSpectrogram<double> STFT<double, double>(const std::vector<double>& data, int windowSize, int hopSize, ThreadPool& pool);
+template BasicSpectrogram<float> STFT<float, float>(const std::vector<float>& data, int windowSize, int hopSize, ThreadPool& pool);
+template BasicSpectrogram<float> STFT<float, double>(const std::vector<double>& data, int windowSize, int hopSize, ThreadPool& pool);
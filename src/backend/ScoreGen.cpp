@@ -1,4 +1,5 @@
 #include <iostream>
+#include <cstdlib>
 #include <string>
 #include <sstream>
 #include <map>
@@ -13,6 +14,7 @@
 #include "postprocess.h"
 #include "common.h"
 #include "xmlToPDF.h"
+#include "fftPlanCache.h"
 
 #define DEFAULT_OUT "output.xml"
 #define DEFAULT_TEST "test/TestingDatasets/Computer-Generated-Samples/D4_to_E5_1_second_per_note.wav"
@@ -21,6 +23,14 @@
 #define DEFAULT_TIME_SIG "4/4"
 #define DEFAULT_DIVISIONS 480
 
+// FFTW wisdom is kept next to the recorded audio so plans measured in one
+// session are reused by the next.
+std::string wisdomPath() {
+    TCHAR appdata[MAX_PATH] = {0};
+    SHGetFolderPath(NULL, CSIDL_APPDATA, NULL, 0, appdata);
+    return std::string(appdata) + "\\ScoreGen\\fftw.wisdom";
+}
+
 bool has_valid_value(const std::unordered_map<std::string, std::string>& map, const std::string& key) {
     auto it = map.find(key);
     return it != map.end() && !it->second.empty();
@@ -87,7 +97,11 @@ void processAudio(const std::map<std::string, std::string>& payload) {
         SHGetFolderPath(NULL, CSIDL_APPDATA, NULL, 0, appdata);
         std::string fileName = std::string(appdata) + "\\ScoreGen\\temp.wav";
 
-        DSPResult res = dsp(fileName.c_str());
+        bool polyphonic = payload.find("polyphonic") != payload.end() && payload.at("polyphonic") == "true";
+        bool tempoMap = payload.find("tempoMap") != payload.end() && payload.at("tempoMap") == "true";
+        // 0 (or anything unparsable) analyses the melody at the recorded rate
+        int analysisRate = payload.find("analysisRate") != payload.end() ? std::atoi(payload.at("analysisRate").c_str()) : 0;
+        DSPResult res = dsp(fileName.c_str(), false, polyphonic, analysisRate, tempoMap);
 
         std::string workNumber = (payload.find("workNumber") != payload.end() && !payload.at("workNumber").empty()) ? payload.at("workNumber") : "Unnumbered Work";
         std::string workTitle = (payload.find("workTitle") != payload.end() && !payload.at("workTitle").empty()) ? payload.at("workTitle") : "Untitled Work";
@@ -136,6 +150,8 @@ void generatePDF(const std::map<std::string, std::string>& payload) {
 }
 
 int main() {
+    FFTPlanCache::instance().loadWisdom(wisdomPath());
+
     std::string line;
     while (std::getline(std::cin, line)) {
         std::istringstream iss(line);
@@ -155,6 +171,7 @@ int main() {
         else {
             std::cerr << "Unknown command: " << command << std::endl;
         }
+        FFTPlanCache::instance().saveWisdom(wisdomPath());
     }
     return 0;
 }
\ No newline at end of file
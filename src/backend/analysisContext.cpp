@@ -0,0 +1,59 @@
+#include <algorithm>
+#include <cmath>
+#include "analysisContext.h"
+#include "windowRegistry.h"
+
+#define PITCH_GATE_RMS 0.001      // quieter windowed pitch frames are unvoiced
+#define ONSET_RISE_THRESHOLD 0.02 // RMS rise between onset frames that marks an onset
+
+FrameGeometry FrameGeometry::scaled(int nativeRate, int analysisRate) {
+    const double ratio = static_cast<double>(analysisRate) / nativeRate;
+    const size_t resolution = std::max<size_t>(1, static_cast<size_t>(std::lround(ENERGY_ENVELOPE_RESOLUTION * ratio)));
+    FrameGeometry geometry;
+    geometry.energyResolution = resolution;
+    geometry.pitchFrameSize = PITCH_FRAME_SIZE / ENERGY_ENVELOPE_RESOLUTION * resolution;
+    geometry.pitchHopSize = PITCH_HOP_SIZE / ENERGY_ENVELOPE_RESOLUTION * resolution;
+    geometry.onsetFrameSize = ONSET_FRAME_SIZE / ENERGY_ENVELOPE_RESOLUTION * resolution;
+    geometry.onsetHopSize = ONSET_HOP_SIZE / ENERGY_ENVELOPE_RESOLUTION * resolution;
+    return geometry;
+}
+
+AnalysisContext::AnalysisContext(int sampleRate, const PitchOptions& pitchOptions, size_t frameSize)
+    : sampleRate_(sampleRate),
+      frameSize_(frameSize),
+      window_(WindowRegistry::instance().get<Sample>(WindowType::Hanning, frameSize)),
+      estimator_(makePitchEstimator(pitchOptions)),
+      scratch_(ANALYSIS_SCRATCH_BYTES) {}
+
+//
+// Function: pitchFrame
+// --------------------
+// Gates the frame on its windowed RMS and runs the estimator on the raw
+// samples, or on a Hanning-windowed copy in scratch if the estimator asks.
+//
+double AnalysisContext::pitchFrame(const Sample* frame, double windowedRMS) {
+    if (windowedRMS < PITCH_GATE_RMS) {
+        return 0.0;
+    }
+    if (!estimator_->windowed()) {
+        return estimator_->estimate(frame, frameSize_, sampleRate_, scratch_);
+    }
+    ScratchArena::Scope scope(scratch_);
+    Sample* windowed = scratch_.allocate<Sample>(frameSize_);
+    for (size_t n = 0; n < frameSize_; n++) {
+        windowed[n] = frame[n] * window_[n];
+    }
+    return estimator_->estimate(windowed, frameSize_, sampleRate_, scratch_);
+}
+
+bool AnalysisContext::isOnset(double rms, double prevRMS) {
+    return (rms - prevRMS) > ONSET_RISE_THRESHOLD;
+}
+
+int AnalysisContext::sampleRate() const {
+    return sampleRate_;
+}
+
+ScratchArena& AnalysisContext::scratch() {
+    return scratch_;
+}
@@ -0,0 +1,72 @@
+#include "audioBuffer.h"
+#include <algorithm>
+
+#define READ_BLOCK_FRAMES 4096
+
+AudioBuffer::AudioBuffer()
+    : leadingSilence_(0), sampleRate_(0), channels_(0){}
+
+AudioBuffer::~AudioBuffer(){}
+
+bool AudioBuffer::load(const std::string& path, size_t leadingSilence){
+    AudioStream stream;
+    if (!stream.open(path)){
+        return false;
+    }
+    return load(stream, leadingSilence);
+}
+
+bool AudioBuffer::load(AudioStream& stream, size_t leadingSilence){
+    sampleRate_ = stream.sampleRate();
+    channels_ = stream.channels();
+    leadingSilence_ = leadingSilence;
+
+    // Size the destination once; silence first, then the mono mixdown. The
+    // stream mixes block by block, so no full-length interleaved copy is
+    // ever held alongside the mono signal.
+    size_t capacity = leadingSilence_ + static_cast<size_t>(stream.frames());
+    samples_.assign(capacity, 0.0f);
+
+    size_t written = leadingSilence_;
+    size_t readCount;
+    while (written < capacity){
+        size_t request = std::min<size_t>(READ_BLOCK_FRAMES, capacity - written);
+        readCount = stream.read(samples_.data() + written, request);
+        if (readCount == 0){
+            break;
+        }
+        written += readCount;
+    }
+    samples_.resize(written);
+
+    // The reported frame count can be short for some formats; pick up any remainder.
+    std::vector<Sample> block(READ_BLOCK_FRAMES);
+    while ((readCount = stream.read(block.data(), READ_BLOCK_FRAMES)) > 0){
+        samples_.insert(samples_.end(), block.begin(), block.begin() + readCount);
+    }
+    return true;
+}
+
+const Sample* AudioBuffer::data() const{
+    return samples_.data() + leadingSilence_;
+}
+
+size_t AudioBuffer::size() const{
+    return samples_.size() - leadingSilence_;
+}
+
+const Sample* AudioBuffer::padded() const{
+    return samples_.data();
+}
+
+size_t AudioBuffer::paddedSize() const{
+    return samples_.size();
+}
+
+int AudioBuffer::sampleRate() const{
+    return sampleRate_;
+}
+
+int AudioBuffer::channels() const{
+    return channels_;
+}
@@ -0,0 +1,57 @@
+#include <algorithm>
+#include "audioPipeline.h"
+
+template <typename T>
+AudioPipeline<T>::AudioPipeline(){}
+
+template <typename T>
+AudioPipeline<T>::~AudioPipeline(){}
+
+template <typename T>
+void AudioPipeline<T>::add(std::unique_ptr<AudioProcessor<T>> processor){
+    stages_.push_back(std::move(processor));
+}
+
+template <typename T>
+size_t AudioPipeline<T>::outputSize(size_t inputSize) const{
+    for (const auto& stage : stages_){
+        inputSize = stage->outputSize(inputSize);
+    }
+    return inputSize;
+}
+
+template <typename T>
+size_t AudioPipeline<T>::run(Span<const T> in, Span<T> out){
+    // The current signal lives in one of three places: the caller's input
+    // (read-only unless it aliases out), out, or one of the scratch buffers.
+    const T* src = in.data();
+    size_t size = in.size();
+    T* writable = (in.data() == out.data()) ? out.data() : nullptr;
+
+    for (auto& stage : stages_){
+        const size_t nextSize = stage->outputSize(size);
+        T* dst;
+        if (writable && stage->inPlace() && nextSize <= size){
+            dst = writable;
+        } else if (src != out.data() && nextSize <= out.size()){
+            dst = out.data();
+        } else {
+            std::vector<T>& spare = (src == scratch_[0].data()) ? scratch_[1] : scratch_[0];
+            if (spare.size() < nextSize){
+                spare.resize(nextSize);
+            }
+            dst = spare.data();
+        }
+        size = stage->process(Span<const T>(src, size), Span<T>(dst, nextSize));
+        src = dst;
+        writable = dst;
+    }
+
+    if (src != out.data()){
+        std::copy(src, src + size, out.data());
+    }
+    return size;
+}
+
+template class AudioPipeline<float>;
+template class AudioPipeline<double>;
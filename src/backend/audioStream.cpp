@@ -0,0 +1,68 @@
+#include "audioStream.h"
+#include "channelConverter.h"
+#include <cstring>
+#include <cstdio>
+
+AudioStream::AudioStream()
+    : file_(nullptr){
+    memset(&info_, 0, sizeof(info_));
+}
+
+AudioStream::~AudioStream(){
+    close();
+}
+
+bool AudioStream::open(const std::string& path){
+    close();
+
+    memset(&info_, 0, sizeof(info_));
+    file_ = sf_open(path.c_str(), SFM_READ, &info_);
+    if (!file_){
+        printf("Error: Cannot open input file -- %s\n", sf_strerror(file_));
+        return false;
+    }
+    return true;
+}
+
+void AudioStream::close(){
+    if (file_){
+        sf_close(file_);
+        file_ = nullptr;
+    }
+}
+
+size_t AudioStream::read(Sample* mono, size_t frames){
+    if (!file_ || frames == 0){
+        return 0;
+    }
+
+    const int channels = info_.channels;
+    if (channels == 1){
+        sf_count_t readCount = sf_readf_float(file_, mono, frames);
+        return readCount > 0 ? static_cast<size_t>(readCount) : 0;
+    }
+
+    if (interleaved_.size() < frames * channels){
+        interleaved_.resize(frames * channels);
+    }
+    sf_count_t readCount = sf_readf_float(file_, interleaved_.data(), frames);
+    if (readCount <= 0){
+        return 0;
+    }
+
+    ChannelConverter<Sample> converter(channels);
+    return converter.process(Span<const Sample>(interleaved_.data(), readCount * channels),
+                             Span<Sample>(mono, readCount));
+}
+
+int AudioStream::sampleRate() const{
+    return info_.samplerate;
+}
+
+int AudioStream::channels() const{
+    return info_.channels;
+}
+
+sf_count_t AudioStream::frames() const{
+    return info_.frames;
+}
@@ -0,0 +1,128 @@
+#include "autocorrelation.h"
+#include "fftPlanCache.h"
+#include <algorithm>
+#include <cmath>
+
+template <typename T>
+void Autocorrelator::computeDirect(const T* frame, size_t size, size_t maxLag, double* out) {
+    for (size_t lag = 0; lag <= maxLag; lag++) {
+        double sum = 0.0;
+        for (size_t i = 0; i + lag < size; i++) {
+            sum += static_cast<double>(frame[i]) * frame[i + lag];
+        }
+        out[lag] = sum;
+    }
+}
+
+template <typename T>
+void Autocorrelator::compute(const T* frame, size_t size, size_t maxLag, double* out) {
+    compute(frame, size, maxLag, out, scratch_);
+}
+
+template <typename T>
+void Autocorrelator::compute(const T* frame, size_t size, size_t maxLag, double* out, ScratchArena& scratch) {
+    // Padding to at least size + maxLag keeps the circular correlation from
+    // wrapping into the lags we read.
+    size_t fftSize = 1;
+    while (fftSize < size + maxLag) {
+        fftSize <<= 1;
+    }
+
+    // The direct loop wins for tiny frames or when only a few lags are needed.
+    const double directCost = static_cast<double>(size) * (maxLag + 1);
+    const double fftCost = 6.0 * fftSize * std::log2(static_cast<double>(fftSize));
+    if (size <= AUTOCORRELATION_DIRECT_MAX_SIZE || directCost <= fftCost) {
+        computeDirect(frame, size, maxLag, out);
+        return;
+    }
+
+    ScratchArena::Scope scope(scratch);
+    double* real = scratch.allocate<double>(fftSize);
+    fftw_complex* spectrum = scratch.allocate<fftw_complex>(fftSize / 2 + 1);
+    std::copy(frame, frame + size, real);
+    std::fill(real + size, real + fftSize, 0.0);
+
+    FFTPlanCache& plans = FFTPlanCache::instance();
+    fftw_execute_dft_r2c(plans.forward(static_cast<int>(fftSize)), real, spectrum);
+    for (size_t k = 0; k < fftSize / 2 + 1; k++) {
+        spectrum[k][0] = spectrum[k][0] * spectrum[k][0] + spectrum[k][1] * spectrum[k][1];
+        spectrum[k][1] = 0.0;
+    }
+    fftw_execute_dft_c2r(plans.inverse(static_cast<int>(fftSize)), spectrum, real);
+
+    // FFTW's inverse is unnormalized.
+    const double scale = 1.0 / fftSize;
+    for (size_t lag = 0; lag <= maxLag; lag++) {
+        out[lag] = real[lag] * scale;
+    }
+}
+
+template <typename T>
+void Autocorrelator::computeWindowed(const T* frame, size_t size, size_t window, size_t maxLag, double* out) {
+    computeWindowed(frame, size, window, maxLag, out, scratch_);
+}
+
+template <typename T>
+void Autocorrelator::computeWindowed(const T* frame, size_t size, size_t window, size_t maxLag, double* out,
+                                     ScratchArena& scratch) {
+    // Every product reads x[i + lag] with i + lag < size, so a transform of
+    // at least `size` points never wraps.
+    size_t fftSize = 1;
+    while (fftSize < size) {
+        fftSize <<= 1;
+    }
+
+    const double directCost = static_cast<double>(window) * (maxLag + 1);
+    const double fftCost = 9.0 * fftSize * std::log2(static_cast<double>(fftSize));
+    if (size <= AUTOCORRELATION_DIRECT_MAX_SIZE || directCost <= fftCost) {
+        for (size_t lag = 0; lag <= maxLag; lag++) {
+            double sum = 0.0;
+            for (size_t i = 0; i < window; i++) {
+                sum += static_cast<double>(frame[i]) * frame[i + lag];
+            }
+            out[lag] = sum;
+        }
+        return;
+    }
+
+    ScratchArena::Scope scope(scratch);
+    double* real = scratch.allocate<double>(fftSize);
+    fftw_complex* spectrum = scratch.allocate<fftw_complex>(fftSize / 2 + 1);
+    fftw_complex* windowSpectrum = scratch.allocate<fftw_complex>(fftSize / 2 + 1);
+
+    FFTPlanCache& plans = FFTPlanCache::instance();
+    fftw_plan forward = plans.forward(static_cast<int>(fftSize));
+
+    std::copy(frame, frame + window, real);
+    std::fill(real + window, real + fftSize, 0.0);
+    fftw_execute_dft_r2c(forward, real, windowSpectrum);
+
+    std::copy(frame, frame + size, real);
+    std::fill(real + size, real + fftSize, 0.0);
+    fftw_execute_dft_r2c(forward, real, spectrum);
+
+    // X * conj(W) is the spectrum of the cross-correlation of the window with x.
+    for (size_t k = 0; k < fftSize / 2 + 1; k++) {
+        double re = spectrum[k][0] * windowSpectrum[k][0] + spectrum[k][1] * windowSpectrum[k][1];
+        double im = spectrum[k][1] * windowSpectrum[k][0] - spectrum[k][0] * windowSpectrum[k][1];
+        spectrum[k][0] = re;
+        spectrum[k][1] = im;
+    }
+    fftw_execute_dft_c2r(plans.inverse(static_cast<int>(fftSize)), spectrum, real);
+
+    const double scale = 1.0 / fftSize;
+    for (size_t lag = 0; lag <= maxLag; lag++) {
+        out[lag] = real[lag] * scale;
+    }
+}
+
+template void Autocorrelator::compute<float>(const float* frame, size_t size, size_t maxLag, double* out);
+template void Autocorrelator::compute<double>(const double* frame, size_t size, size_t maxLag, double* out);
+template void Autocorrelator::compute<float>(const float* frame, size_t size, size_t maxLag, double* out, ScratchArena& scratch);
+template void Autocorrelator::compute<double>(const double* frame, size_t size, size_t maxLag, double* out, ScratchArena& scratch);
+template void Autocorrelator::computeDirect<float>(const float* frame, size_t size, size_t maxLag, double* out);
+template void Autocorrelator::computeDirect<double>(const double* frame, size_t size, size_t maxLag, double* out);
+template void Autocorrelator::computeWindowed<float>(const float* frame, size_t size, size_t window, size_t maxLag, double* out);
+template void Autocorrelator::computeWindowed<double>(const double* frame, size_t size, size_t window, size_t maxLag, double* out);
+template void Autocorrelator::computeWindowed<float>(const float* frame, size_t size, size_t window, size_t maxLag, double* out, ScratchArena& scratch);
+template void Autocorrelator::computeWindowed<double>(const double* frame, size_t size, size_t window, size_t maxLag, double* out, ScratchArena& scratch);
@@ -1,24 +1,32 @@
-#include <sndfile.h>
 #include "channelConverter.h"
 
-ChannelConverter::ChannelConverter(const int& channels, const std::vector<double>& data)
-    : channels_(channels), data_(data){}
+template <typename T>
+ChannelConverter<T>::ChannelConverter(int channels)
+    : channels_(channels){}
 
-ChannelConverter::~ChannelConverter(){}
+template <typename T>
+ChannelConverter<T>::~ChannelConverter(){}
 
-std::vector<double> ChannelConverter::process(){
+template <typename T>
+size_t ChannelConverter<T>::outputSize(size_t inputSize) const{
+    return inputSize / channels_;
+}
 
-    std::vector<double> convertedData(data_.size() / channels_);
+template <typename T>
+size_t ChannelConverter<T>::process(Span<const T> in, Span<T> out){
+    const size_t frames = in.size() / channels_;
 
     // Sum the signal among interleaved samples, average to mono
-    for (int i = 0; i < data_.size(); i += channels_){
-        double sum = 0;
+    for (size_t i = 0; i < frames; i++){
+        T sum = 0;
         for (int j = 0; j < channels_; j++){
-            sum += data_[i + j];
+            sum += in[i * channels_ + j];
         }
-        convertedData[i / channels_] = sum / channels_;
+        out[i] = sum / channels_;
     }
 
-    return convertedData;
-    // Note: still need to change sfInfo.channels to 1
-}
\ No newline at end of file
+    return frames;
+}
+
+template class ChannelConverter<float>;
+template class ChannelConverter<double>;
@@ -1,4 +1,5 @@
 #include "determineBPM.h"
+#include "simd.h"
 
 
 float calculateMedian(const std::vector<float>& values) {
@@ -34,20 +35,17 @@ float beatsToBPM(const std::vector<float>& beats) {
     }
 }
 
-// Function to calculate beats per minute (BPM) from a loaded buffer
-float getBufferBPM(const std::vector<double>& buf, int sample_rate, const std::map<std::string, std::string>& params) {
-    // Default settings
-    int win_s = WIN_S, hop_s = HOP_S;
-
+TempoTracker::TempoTracker(int sample_rate, const std::map<std::string, std::string>& params)
+    : win_s_(WIN_S), hop_s_(HOP_S), filled_(0), tempo_(nullptr), input_(nullptr), tempo_out_(nullptr) {
     // Handle different modes
     auto modeIt = params.find("mode");
     if (modeIt != params.end()) {
         const std::string& mode = modeIt->second;
         if (mode == "fast") {
-            win_s = F_WIN_S; hop_s = F_HOP_S;
+            win_s_ = F_WIN_S; hop_s_ = F_HOP_S;
         }
         else if (mode == "super-fast") {
-            win_s = SF_WIN_S; hop_s = SF_HOP_S;
+            win_s_ = SF_WIN_S; hop_s_ = SF_HOP_S;
         }
         else if (mode != "default") {
             throw std::invalid_argument("Unknown mode: " + mode);
@@ -56,39 +54,250 @@ float getBufferBPM(const std::vector<double>& buf, int sample_rate, const std::m
 
     // Manual settings
     if (params.find("win_s") != params.end()) {
-        win_s = std::stoi(params.at("win_s"));
+        win_s_ = std::stoi(params.at("win_s"));
     }
     if (params.find("hop_s") != params.end()) {
-        hop_s = std::stoi(params.at("hop_s"));
+        hop_s_ = std::stoi(params.at("hop_s"));
     }
 
     // Initialize Aubio tempo detection
-    aubio_tempo_t* tempo = new_aubio_tempo("specdiff", win_s, hop_s, sample_rate);
-    if (!tempo) {
+    tempo_ = new_aubio_tempo("specdiff", win_s_, hop_s_, sample_rate);
+    if (!tempo_) {
         throw std::runtime_error("Failed to initialize Aubio tempo detector");
     }
+    input_ = new_fvec(hop_s_);
+    tempo_out_ = new_fvec(1); // Output buffer for tempo
+}
+
+TempoTracker::~TempoTracker() {
+    del_aubio_tempo(tempo_);
+    del_fvec(input_);
+    del_fvec(tempo_out_);
+}
+
+//
+// Function: processHop
+// --------------------
+// Runs aubio on one hop of samples. aubio only reads its input vector, so a
+// stack fvec_t is pointed at the hop wherever it lives: in the caller's
+// buffer, in a FrameDriver's ring, or in the tracker's own hop buffer.
+//
+void TempoTracker::processHop(const smpl_t* hop) {
+    fvec_t view;
+    view.length = static_cast<uint_t>(hop_s_);
+    view.data = const_cast<smpl_t*>(hop);
+    aubio_tempo_do(tempo_, &view, tempo_out_);
+    if (fvec_get_sample(tempo_out_, 0) != 0) { // Check for beat
+        float this_beat = aubio_tempo_get_last_s(tempo_);
+        beats_.push_back(this_beat);
+    }
+}
+
+// Narrows a run of doubles into the hop buffer, four samples per step
+// under SSE2.
+static void convertRun(const double* in, size_t n, smpl_t* out) {
+    size_t i = 0;
+#ifdef SCOREGEN_SSE2
+    for (; i + 4 <= n; i += 4) {
+        __m128 low = _mm_cvtpd_ps(_mm_loadu_pd(in + i));
+        __m128 high = _mm_cvtpd_ps(_mm_loadu_pd(in + i + 2));
+        _mm_storeu_ps(out + i, _mm_movelh_ps(low, high));
+    }
+#endif
+    for (; i < n; i++) {
+        out[i] = static_cast<smpl_t>(in[i]);
+    }
+}
+
+// Whole hops are handed to aubio straight from the block; only a partial hop
+// at either end of it is copied into the hop buffer.
+void TempoTracker::push(const Sample* buf, size_t size) {
+    const size_t hop = hop_s_;
+    while (size > 0) {
+        if (filled_ == 0 && size >= hop) {
+            processHop(buf);
+            buf += hop;
+            size -= hop;
+            continue;
+        }
+        size_t run = std::min(size, hop - filled_);
+        std::copy(buf, buf + run, input_->data + filled_);
+        filled_ += run;
+        buf += run;
+        size -= run;
+        if (filled_ == hop) {
+            processHop(input_->data);
+            filled_ = 0;
+        }
+    }
+}
+
+void TempoTracker::push(const double* buf, size_t size) {
+    const size_t hop = hop_s_;
+    while (size > 0) {
+        size_t run = std::min(size, hop - filled_);
+        convertRun(buf, run, input_->data + filled_);
+        filled_ += run;
+        buf += run;
+        size -= run;
+        if (filled_ == hop) {
+            processHop(input_->data);
+            filled_ = 0;
+        }
+    }
+}
+
+void TempoTracker::pushSilence(size_t size) {
+    const size_t hop = hop_s_;
+    while (size > 0) {
+        size_t run = std::min(size, hop - filled_);
+        std::fill(input_->data + filled_, input_->data + filled_ + run, 0.0f);
+        filled_ += run;
+        size -= run;
+        if (filled_ == hop) {
+            processHop(input_->data);
+            filled_ = 0;
+        }
+    }
+}
+
+size_t TempoTracker::frameSize() const {
+    return hop_s_;
+}
+
+size_t TempoTracker::hopSize() const {
+    return hop_s_;
+}
+
+void TempoTracker::consume(const Sample* frame, size_t start) {
+    push(frame, hop_s_);
+}
+
+void TempoTracker::flush(const Sample* rest, size_t size) {
+    push(rest, size);
+}
 
-    std::vector<float> beats;
-    fvec_t* input = new_fvec(hop_s);
-    fvec_t* tempo_out = new_fvec(1); // Output buffer for tempo
+// The last partial hop is zero-padded, so samples left in the hop buffer
+// from the previous hop do not leak into the final frame.
+float TempoTracker::finish() {
+    if (filled_ > 0) {
+        std::fill(input_->data + filled_, input_->data + hop_s_, 0.0f);
+        processHop(input_->data);
+        filled_ = 0;
+    }
+    return beatsToBPM(beats_);
+}
 
-    for (size_t i = 0; i < buf.size(); i += hop_s) {
-        // Fill the input buffer
-        for (size_t j = 0; j < hop_s && (i + j) < buf.size(); ++j) {
-            fvec_set_sample(input, buf[i + j], j);
+// How much `estimate` backs `candidate`: 1 for the same tempo, 1/2 for half
+// or twice it, 0 otherwise. `folded` receives the estimate in the
+// candidate's octave.
+static float support(float candidate, float estimate, float& folded) {
+    if (estimate <= 0.0f) {
+        return 0.0f;
+    }
+    const float ratios[] = {1.0f, 2.0f, 0.5f};
+    for (float ratio : ratios) {
+        folded = estimate * ratio;
+        if (std::abs(folded - candidate) <= TEMPO_CONSENSUS_TOLERANCE * candidate) {
+            return ratio == 1.0f ? 1.0f : 0.5f;
         }
+    }
+    return 0.0f;
+}
 
-        // Process the buffer to detect tempo
-        aubio_tempo_do(tempo, input, tempo_out);
-        if (fvec_get_sample(tempo_out, 0) != 0) { // Check for beat
-            float this_beat = aubio_tempo_get_last_s(tempo);
-            beats.push_back(this_beat);
+TempoConsensus reconcileTempi(const std::vector<float>& estimates) {
+    TempoConsensus consensus;
+    float bestSupport = 0.0f;
+    for (float candidate : estimates) {
+        if (candidate <= 0.0f) {
+            continue;
+        }
+        float total = 0.0f;
+        float sum = 0.0f;
+        int supporters = 0;
+        for (float estimate : estimates) {
+            float folded = 0.0f;
+            float weight = support(candidate, estimate, folded);
+            if (weight > 0.0f) {
+                total += weight;
+                sum += folded;
+                supporters++;
+            }
+        }
+        if (total > bestSupport) {
+            bestSupport = total;
+            consensus.bpm = sum / supporters;
+            consensus.confidence = total / estimates.size();
         }
     }
+    return consensus;
+}
+
+// Function to calculate beats per minute (BPM) from a loaded buffer
+float getBufferBPM(const std::vector<double>& buf, int sample_rate, const std::map<std::string, std::string>& params) {
+    return getBufferBPM(buf.data(), buf.size(), sample_rate, params);
+}
 
-    del_aubio_tempo(tempo);
-    del_fvec(input);
-    del_fvec(tempo_out);
+static bool wantsConsensus(const std::map<std::string, std::string>& params) {
+    auto modeIt = params.find("mode");
+    return modeIt != params.end() && modeIt->second == "consensus";
+}
 
-    return beatsToBPM(beats);
-}
\ No newline at end of file
+// Same as above, but reads directly from a caller-owned buffer (e.g. an AudioBuffer)
+float getBufferBPM(const Sample* buf, size_t size, int sample_rate, const std::map<std::string, std::string>& params) {
+    if (wantsConsensus(params)) {
+        return getConsensusBPM(buf, size, sample_rate).bpm;
+    }
+    TempoTracker tracker(sample_rate, params);
+    tracker.push(buf, size);
+    return tracker.finish();
+}
+
+float getBufferBPM(const double* buf, size_t size, int sample_rate, const std::map<std::string, std::string>& params) {
+    if (wantsConsensus(params)) {
+        return getConsensusBPM(buf, size, sample_rate).bpm;
+    }
+    TempoTracker tracker(sample_rate, params);
+    tracker.push(buf, size);
+    return tracker.finish();
+}
+
+//
+// Function: consensusBPM
+// ----------------------
+// The trackers are created here, one after another, since aubio plans its
+// FFTs when a tracker is made and FFTW planning is not thread-safe. Only the
+// passes over the buffer, which just read it, run concurrently; the trackers
+// are finished back on this thread so their messages do not interleave.
+//
+template <typename T>
+static TempoConsensus consensusBPM(const T* buf, size_t size, int sample_rate) {
+    const char* const modes[] = {"default", "fast", "super-fast"};
+    std::vector<std::unique_ptr<TempoTracker>> trackers;
+    for (const char* mode : modes) {
+        trackers.emplace_back(new TempoTracker(sample_rate, {{"mode", mode}}));
+    }
+
+    std::vector<std::future<void>> passes;
+    for (std::unique_ptr<TempoTracker>& tracker : trackers) {
+        TempoTracker* t = tracker.get();
+        passes.push_back(std::async(std::launch::async, [t, buf, size] { t->push(buf, size); }));
+    }
+    for (std::future<void>& pass : passes) {
+        pass.get();
+    }
+
+    std::vector<float> estimates;
+    for (std::unique_ptr<TempoTracker>& tracker : trackers) {
+        estimates.push_back(tracker->finish());
+    }
+    return reconcileTempi(estimates);
+}
+
+TempoConsensus getConsensusBPM(const Sample* buf, size_t size, int sample_rate) {
+    return consensusBPM(buf, size, sample_rate);
+}
+
+TempoConsensus getConsensusBPM(const double* buf, size_t size, int sample_rate) {
+    return consensusBPM(buf, size, sample_rate);
+}
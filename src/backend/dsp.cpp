@@ -1,75 +1,139 @@
 #include "dsp.h"
+#include <algorithm>
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
 
-#define SILENCE_LENGTH 512
 #define PPQ 480 // Pulses per quarter note, default for MusicXML
+#define STREAM_BLOCK_FRAMES 65536
+#define STREAMING_MIN_SECONDS (30 * 60) // stream anything longer than 30 minutes
+#define DEFAULT_BPM 120                 // when no tempo can be found at all
+#define TEMPO_FALLBACK_SECONDS 10       // opening kept for the fallback tempo
 
-std::vector<double> prependSilence(const std::vector<float>& buf, size_t silenceLength) {
-    std::vector<double> paddedBuffer(silenceLength, 0.0f); // Add silence
-    paddedBuffer.insert(paddedBuffer.end(), buf.begin(), buf.end());
-    return paddedBuffer;
-}
+namespace {
+// One thread that runs the tempo tracker over a stream's blocks for the whole
+// file. The handoff holds a single block: push() waits until the worker is
+// done with the previous one, so the reader can alternate between two
+// buffers and never gets more than a block ahead.
+class TempoWorker {
+public:
+    explicit TempoWorker(std::function<void(const Sample*, size_t)> consume)
+        : consume_(std::move(consume)), block_(nullptr), size_(0), busy_(false), stop_(false),
+          thread_(&TempoWorker::run, this) {}
 
-XMLNote convertToXMLNote(const Note& note, int bpm) {
-    XMLNote xmlNote;
-    int octave = 0;
-    int alter = 0;
-    std::string noteName;
-    xmlNote.isRest = false;
+    ~TempoWorker() {
+        stop();
+    }
 
-    // Convert note duration in s to duration in divisions
-    float noteDurationInSeconds = note.endTime - note.startTime;
-    xmlNote.duration = static_cast<int>(std::round((noteDurationInSeconds * (bpm / 60.0) * PPQ) / PPQ) * PPQ);
-    xmlNote.type = note.type;
+    // The block must stay untouched until the next push() or finish() returns.
+    void push(const Sample* block, size_t size) {
+        std::unique_lock<std::mutex> lock(mutex_);
+        idle_.wait(lock, [this] { return !busy_; });
+        block_ = block;
+        size_ = size;
+        busy_ = true;
+        wake_.notify_one();
+    }
 
-    // Extract note name and octave
-    if (note.pitch == "Rest") {
-        xmlNote.isRest = true;
-        return xmlNote;
+    // Waits for the last block and stops the thread. An exception thrown by
+    // the tracker is rethrown here.
+    void finish() {
+        stop();
+        if (error_) {
+            std::rethrow_exception(error_);
+        }
     }
 
-    for (char c : note.pitch) {
-        if ((std::isalpha(c) == 1) && (c != 'b')) {
-            noteName += c;
-        } 
-        else if (c == '#' || c == 'b') {
-            alter = c == '#' ? 1 : -1;
+private:
+    void stop() {
+        if (!thread_.joinable()) {
+            return;
         }
-        else if (std::isdigit(c)) {
-            octave = octave * 10 + (c - '0');
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stop_ = true;
         }
+        wake_.notify_one();
+        thread_.join();
     }
 
-    xmlNote.pitch = noteName;
-    xmlNote.octave = octave;
-    xmlNote.alter = alter;
+    void run() {
+        std::unique_lock<std::mutex> lock(mutex_);
+        while (true) {
+            wake_.wait(lock, [this] { return busy_ || stop_; });
+            if (!busy_) {
+                return;
+            }
+            lock.unlock();
+            if (!error_) {
+                try {
+                    consume_(block_, size_);
+                } catch (...) {
+                    error_ = std::current_exception();
+                }
+            }
+            lock.lock();
+            busy_ = false;
+            idle_.notify_one();
+        }
+    }
 
+    std::function<void(const Sample*, size_t)> consume_;
+    std::mutex mutex_;
+    std::condition_variable wake_;
+    std::condition_variable idle_;
+    const Sample* block_;
+    size_t size_;
+    bool busy_;                 // a block is waiting or being consumed
+    bool stop_;
+    std::exception_ptr error_;  // only touched by the worker until it is joined
+    std::thread thread_;        // last, so it starts once the rest is set up
+};
+}
+
+// Tempo for a signal the tempogram found none in, typically a clip shorter
+// than two of its slowest beats (about 3 s). aubio's tracker reports beats
+// after its first step, so it runs over the opening TEMPO_FALLBACK_SECONDS;
+// if it finds nothing either, the score is written at DEFAULT_BPM rather
+// than with every note dropped.
+static TempoMap fallbackTempo(const Sample* opening, size_t size, int sampleRate) {
+    float bpm = size > 0 ? getBufferBPM(opening, size, sampleRate) : 0.0f;
+    return TempoMap::constant(bpm > 0.0f ? bpm : DEFAULT_BPM);
+}
+
+XMLNote convertToXMLNote(const Note& note, int bpm) {
+    return convertToXMLNote(note, TempoMap::constant(bpm));
+}
+
+XMLNote convertToXMLNote(const Note& note, const TempoMap& tempo) {
+    XMLNote xmlNote;
+
+    // Convert note duration in s to duration in divisions, at the tempo the
+    // note was played at
+    float noteDurationInSeconds = note.endTime - note.startTime;
+    double bpm = tempo.averageBPM(note.startTime, note.endTime);
+    xmlNote.duration = static_cast<int>(std::round((noteDurationInSeconds * (bpm / 60.0) * PPQ) / PPQ) * PPQ);
+    xmlNote.type = note.type;
+    xmlNote.chord = note.chord;
+
+    // Spelled with sharps until the key is known
+    xmlNote.midi = note.midi;
+    if (!xmlNote.isRest()) {
+        xmlNote.alter = spellingAlter(note.midi, 0);
+    }
     return xmlNote;
 }
 
 std::vector<int> calculatePitchDurations(const std::vector<XMLNote>& xmlNotes) {
     std::vector<int> durations(12, 0);
-    std::map<std::string, int> pitchClasses = 
-    {
-        {"C", 0}, {"C#", 1}, {"D", 2}, {"D#", 3}, 
-        {"E", 4},{"F", 5}, {"F#", 6}, {"G", 7}, 
-        {"G#", 8},{"A", 9}, {"A#", 10}, {"B", 11}
-    };
-    
     for (const auto& xmlNote : xmlNotes) 
     {
-        if (xmlNote.isRest) {
+        if (xmlNote.isRest()) {
             continue;
         }
-
-        std::string pitchFullName = xmlNote.pitch;
-        if (xmlNote.alter == 1) {
-            pitchFullName = pitchFullName + "#";
-        } else if (xmlNote.alter == -1) {
-            pitchFullName = pitchFullName + "b";
-        }
-
-        int pitchClass = pitchClasses[pitchFullName];
-        durations[pitchClass] += xmlNote.duration;
+        durations[xmlNote.midi % 12] += xmlNote.duration;
     }
     
     return durations;
@@ -83,6 +147,7 @@ int convertToKeySignature(const string& key) {
         {"E", 4},  {"B", 5},  {"F#", 6},  {"C#", 7},
         {"F", -1}, {"Bb", -2}, {"Eb", -3}, {"Ab", -4},
         {"Db", -5}, {"Gb", -6}, {"Cb", -7},
+        {"D#", -3}, {"G#", -4}, {"A#", -2}, // findKey's sharp names for Eb, Ab, Bb
         
         // Minor keys
         {"a", 0},  {"e", 1},  {"b", 2},   {"f#", 3},
@@ -94,47 +159,141 @@ int convertToKeySignature(const string& key) {
     return (it != keyToSignature.end()) ? it->second : 0;  // Default to C major
 }
 
-DSPResult dsp(const char* infilename) {
+DSPResult dsp(const char* infilename, bool streaming, bool polyphonic, int analysisRate, bool tempoMap) {
     DSPResult result;
+    if (analysisRate != 0 && analysisRate < MIN_ANALYSIS_RATE) {
+        throw std::invalid_argument("analysisRate must be 0 or at least " + std::to_string(MIN_ANALYSIS_RATE) + " Hz");
+    }
 
-    SNDFILE* infile;
-    SF_INFO sfinfo;
-    vector<float> buf;
-    
-	memset(&sfinfo, 0, sizeof(sfinfo));
-    if (!(infile = sf_open(infilename, SFM_READ, &sfinfo))) {
+    AudioStream stream;
+    if (!stream.open(infilename)) {
 		printf("Not able to open requested file %s.\n", infilename) ;
-		puts(sf_strerror(NULL));
         exit(EXIT_FAILURE);
 	}
 
-    size_t numFrames = sfinfo.frames * sfinfo.channels;
-    vector<float> tempBuffer(numFrames);
-    sf_count_t numRead = sf_read_float(infile, tempBuffer.data(), numFrames);
-    sf_close(infile);
-
-    // Convert interleaved audio to mono if necessary
-    if (sfinfo.channels > 1) {
-        buf.resize(sfinfo.frames);
-        for (size_t i = 0; i < sfinfo.frames; ++i) {
-            float sum = 0.0f;
-            for (int ch = 0; ch < sfinfo.channels; ++ch) {
-                sum += tempBuffer[i * sfinfo.channels + ch];
-            }
+    // Tempo detection and the onset, pitch or chord frames only need the
+    // samples, so they run side by side; only note segmentation and typing
+    // wait for the BPM. The tempo comes from the spectral-flux tempogram; in
+    // tempo map mode its flux envelope is cut into windows instead, so the
+    // tempo can follow the performance.
+    TempoMap tempoCurve;
+
+    // Melody analysis may run on a copy resampled to analysisRate, with frame
+    // sizes scaled to match; tempo and chord detection keep the recorded rate.
+    const bool resample = !polyphonic && analysisRate > 0 && analysisRate != stream.sampleRate();
+    std::unique_ptr<Resampler<Sample>> resampler;
+    FrameGeometry geometry;
+    int frameRate = stream.sampleRate();
+    if (resample) {
+        resampler.reset(new Resampler<Sample>(stream.sampleRate(), analysisRate));
+        geometry = FrameGeometry::scaled(stream.sampleRate(), analysisRate);
+        frameRate = analysisRate;
+    }
 
-            buf[i] = sum / sfinfo.channels;
+    FrameDriver driver;
+    FrameAnalysis analysis;
+    PolyphonicAnalysis chords;
+    if (streaming || stream.frames() > static_cast<sf_count_t>(STREAMING_MIN_SECONDS) * stream.sampleRate()) {
+        // Pull fixed-size blocks; no analysis keeps more than a few frames.
+        // The tempo worker takes each block while the driver frames it and
+        // the next one is read into the other buffer.
+        std::unique_ptr<StreamingFrameAnalyzer> frames;
+        std::unique_ptr<StreamingChordAnalyzer> chordFrames;
+        if (polyphonic) {
+            chordFrames.reset(new StreamingChordAnalyzer(stream.sampleRate()));
+            chordFrames->attach(driver);
+        } else {
+            frames.reset(new StreamingFrameAnalyzer(frameRate, PitchOptions(), geometry));
+            frames->attach(driver);
+        }
+        std::vector<Sample> blocks[2] = {std::vector<Sample>(STREAM_BLOCK_FRAMES),
+                                         std::vector<Sample>(STREAM_BLOCK_FRAMES)};
+        std::vector<Sample> resampled;
+        std::vector<Sample> opening;
+        const size_t openingLimit = static_cast<size_t>(TEMPO_FALLBACK_SECONDS) * stream.sampleRate();
+        TempogramTracker tempogram(stream.sampleRate());
+        TempoWorker tempoWorker([&](const Sample* block, size_t size) {
+            tempogram.push(block, size);
+        });
+        size_t current = 0;
+        size_t readCount;
+        while ((readCount = stream.read(blocks[current].data(), STREAM_BLOCK_FRAMES)) > 0) {
+            const Sample* block = blocks[current].data();
+            tempoWorker.push(block, readCount);
+            if (opening.size() < openingLimit) {
+                opening.insert(opening.end(), block, block + std::min(readCount, openingLimit - opening.size()));
+            }
+            if (resample) {
+                resampled.clear();
+                resampler->push(block, readCount, resampled);
+                driver.push(resampled.data(), resampled.size());
+            } else {
+                driver.push(block, readCount);
+            }
+            current ^= 1;
+        }
+        tempoWorker.finish();
+        if (resample) {
+            resampled.clear();
+            resampler->finish(resampled);
+            driver.push(resampled.data(), resampled.size());
+        }
+        driver.finish();
+        if (tempoMap) {
+            tempogram.finish();
+            tempoCurve = estimateTempoMap(tempogram.envelope(), tempogram.framesPerSecond());
+        } else {
+            int bpm = tempogram.finish();
+            tempoCurve = TempoMap::constant(bpm);
+        }
+        if (tempoCurve.medianBPM() <= 0.0) {
+            tempoCurve = fallbackTempo(opening.data(), opening.size(), stream.sampleRate());
+        }
+        if (polyphonic) {
+            chords = chordFrames->analysis();
+        } else {
+            analysis = frames->analysis();
         }
     } else {
-        buf = move(tempBuffer);
+        // Decode once; tempo detection reads the decoded samples on its own
+        // thread while the frames run on the pool. The tempo map spreads its
+        // own work over the same shared pool, which takes one job at a time,
+        // so in map mode the two take turns on the pool instead of
+        // overlapping; each still keeps every core busy while it runs.
+        AudioBuffer audio;
+        if (!audio.load(stream)) {
+            printf("Not able to read requested file %s.\n", infilename);
+            exit(EXIT_FAILURE);
+        }
+        std::future<void> tempoPass = std::async(std::launch::async, [&] {
+            if (tempoMap) {
+                tempoCurve = estimateTempoMap(audio.data(), audio.size(), audio.sampleRate());
+            } else {
+                int bpm = getTempogramBPM(audio.data(), audio.size(), audio.sampleRate());
+                tempoCurve = TempoMap::constant(bpm);
+            }
+            if (tempoCurve.medianBPM() <= 0.0) {
+                const size_t openingSize = std::min(audio.size(), static_cast<size_t>(TEMPO_FALLBACK_SECONDS) * audio.sampleRate());
+                tempoCurve = fallbackTempo(audio.data(), openingSize, audio.sampleRate());
+            }
+        });
+        if (polyphonic) {
+            chords = analyzePolyphonicFrames(audio.data(), audio.size(), audio.sampleRate(), driver, ThreadPool::shared());
+        } else if (resample) {
+            std::vector<Sample> resampled(resampler->outputSize(audio.size()));
+            resampler->process(Span<const Sample>(audio.data(), audio.size()), resampled);
+            analysis = analyzeFrames(resampled.data(), resampled.size(), frameRate, driver,
+                                     ThreadPool::shared(), PitchOptions(), geometry);
+        } else {
+            analysis = analyzeFrames(audio.data(), audio.size(), audio.sampleRate(), driver, ThreadPool::shared());
+        }
+        tempoPass.get();
     }
-
-    const std::vector<double> paddedBuf = prependSilence(buf, SILENCE_LENGTH);
-    int bpm = getBufferBPM(paddedBuf, sfinfo.samplerate);
-    std::cout << "Detected BPM: " << bpm << std::endl;
-    std::vector<Note> notes = extract_note_durations(infilename, bpm);
+    std::cout << "Detected BPM: " << static_cast<int>(tempoCurve.medianBPM()) << std::endl;
+    std::vector<Note> notes = polyphonic ? segmentChords(chords, tempoCurve) : segmentNotes(analysis, tempoCurve);
 
     for (const Note& note : notes) {
-        result.XMLNotes.push_back(convertToXMLNote(note, bpm));
+        result.XMLNotes.push_back(convertToXMLNote(note, tempoCurve));
     }
 
     // Extract key signature
@@ -143,5 +302,12 @@ DSPResult dsp(const char* infilename) {
     std::cout << "Detected Key: " << detectedKey << std::endl;
     result.keySignature = convertToKeySignature(detectedKey);
 
+    // Spell black keys as flats in flat keys
+    for (XMLNote& xmlNote : result.XMLNotes) {
+        if (!xmlNote.isRest()) {
+            xmlNote.alter = spellingAlter(xmlNote.midi, result.keySignature);
+        }
+    }
+
     return result;
 }
\ No newline at end of file
@@ -0,0 +1,134 @@
+#define _USE_MATH_DEFINES
+#include "energyEnvelope.h"
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+void EnergyEnvelope::CompensatedSum::add(double value) {
+    double t = sum + value;
+    if (std::abs(sum) >= std::abs(value)) {
+        compensation += (sum - t) + value;
+    } else {
+        compensation += (value - t) + sum;
+    }
+    sum = t;
+}
+
+EnergyEnvelope::EnergyEnvelope(size_t resolution, size_t hannLength)
+    : resolution_(resolution), hannLength_(hannLength), period_(hannLength > 1 ? hannLength - 1 : 0),
+      firstPoint_(0), size_(0), phase_(0), block_() {
+    if (resolution_ == 0) {
+        throw std::invalid_argument("EnergyEnvelope resolution must be positive");
+    }
+    if (period_ > 0) {
+        phaseTable_.resize(4 * period_);
+        const double theta = 2.0 * M_PI / period_;
+        for (size_t j = 0; j < period_; j++) {
+            phaseTable_[4 * j] = std::cos(theta * j);
+            phaseTable_[4 * j + 1] = std::sin(theta * j);
+            phaseTable_[4 * j + 2] = std::cos(2.0 * theta * j);
+            phaseTable_[4 * j + 3] = std::sin(2.0 * theta * j);
+        }
+    }
+    totals_.push_back(Totals());
+}
+
+void EnergyEnvelope::append(const Sample* samples, size_t count) {
+    size_t i = 0;
+    while (i < count) {
+        // Fill the current block up to its boundary.
+        size_t run = std::min(count - i, resolution_ - size_ % resolution_);
+        if (period_ == 0) {
+            for (size_t n = 0; n < run; n++) {
+                block_.energy += static_cast<double>(samples[i + n]) * samples[i + n];
+            }
+        } else {
+            for (size_t n = 0; n < run; n++) {
+                double e = static_cast<double>(samples[i + n]) * samples[i + n];
+                const double* phase = &phaseTable_[4 * phase_];
+                block_.energy += e;
+                block_.cos1 += e * phase[0];
+                block_.sin1 += e * phase[1];
+                block_.cos2 += e * phase[2];
+                block_.sin2 += e * phase[3];
+                if (++phase_ == period_) {
+                    phase_ = 0;
+                }
+            }
+        }
+        i += run;
+        size_ += run;
+        if (size_ % resolution_ == 0) {
+            closeBlock();
+        }
+    }
+}
+
+void EnergyEnvelope::closeBlock() {
+    running_[0].add(block_.energy);
+    running_[1].add(block_.cos1);
+    running_[2].add(block_.sin1);
+    running_[3].add(block_.cos2);
+    running_[4].add(block_.sin2);
+    Totals totals;
+    totals.energy = running_[0].value();
+    totals.cos1 = running_[1].value();
+    totals.sin1 = running_[2].value();
+    totals.cos2 = running_[3].value();
+    totals.sin2 = running_[4].value();
+    totals_.push_back(totals);
+    block_ = Totals();
+}
+
+void EnergyEnvelope::discardBefore(size_t index) {
+    size_t point = std::min(index / resolution_, firstPoint_ + totals_.size() - 1);
+    if (point > firstPoint_) {
+        totals_.erase(totals_.begin(), totals_.begin() + (point - firstPoint_));
+        firstPoint_ = point;
+    }
+}
+
+size_t EnergyEnvelope::size() const {
+    return size_;
+}
+
+size_t EnergyEnvelope::resolution() const {
+    return resolution_;
+}
+
+const EnergyEnvelope::Totals& EnergyEnvelope::totalsAt(size_t index) const {
+    if (index % resolution_ != 0) {
+        throw std::out_of_range("EnergyEnvelope query is not on the envelope's resolution");
+    }
+    size_t point = index / resolution_;
+    if (point < firstPoint_ || point - firstPoint_ >= totals_.size()) {
+        throw std::out_of_range("EnergyEnvelope query outside the retained samples");
+    }
+    return totals_[point - firstPoint_];
+}
+
+double EnergyEnvelope::energy(size_t start, size_t length) const {
+    return std::max(0.0, totalsAt(start + length).energy - totalsAt(start).energy);
+}
+
+double EnergyEnvelope::rms(size_t start, size_t length) const {
+    return std::sqrt(energy(start, length) / length);
+}
+
+double EnergyEnvelope::hannEnergy(size_t start) const {
+    if (period_ == 0) {
+        throw std::logic_error("EnergyEnvelope was built without a Hann length");
+    }
+    const Totals& end = totalsAt(start + hannLength_);
+    const Totals& begin = totalsAt(start);
+    // Shift the global phase theta * i back to the frame's own index i - start.
+    const double* phase = &phaseTable_[4 * (start % period_)];
+    double first = phase[0] * (end.cos1 - begin.cos1) + phase[1] * (end.sin1 - begin.sin1);
+    double second = phase[2] * (end.cos2 - begin.cos2) + phase[3] * (end.sin2 - begin.sin2);
+    double energy = 0.375 * (end.energy - begin.energy) - 0.5 * first + 0.125 * second;
+    return std::max(0.0, energy);
+}
+
+double EnergyEnvelope::hannRMS(size_t start) const {
+    return std::sqrt(hannEnergy(start) / hannLength_);
+}
@@ -0,0 +1,70 @@
+#include "fftPlanCache.h"
+#include <iostream>
+#include <stdexcept>
+
+FFTPlanCache& FFTPlanCache::instance(){
+    static FFTPlanCache cache;
+    return cache;
+}
+
+FFTPlanCache::FFTPlanCache()
+    : dirty_(false){}
+
+FFTPlanCache::~FFTPlanCache(){
+    for (auto& entry : forward_){
+        fftw_destroy_plan(entry.second);
+    }
+    for (auto& entry : inverse_){
+        fftw_destroy_plan(entry.second);
+    }
+}
+
+fftw_plan FFTPlanCache::forward(int size){
+    return plan(forward_, size, true);
+}
+
+fftw_plan FFTPlanCache::inverse(int size){
+    return plan(inverse_, size, false);
+}
+
+fftw_plan FFTPlanCache::plan(std::map<int, fftw_plan>& plans, int size, bool isForward){
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = plans.find(size);
+    if (it != plans.end()){
+        return it->second;
+    }
+
+    // Measuring planners overwrite their arrays, so plan on scratch buffers.
+    double* real = fftw_alloc_real(size);
+    fftw_complex* complex = fftw_alloc_complex(size / 2 + 1);
+    fftw_plan p = isForward
+        ? fftw_plan_dft_r2c_1d(size, real, complex, FFT_PLAN_FLAGS)
+        : fftw_plan_dft_c2r_1d(size, complex, real, FFT_PLAN_FLAGS);
+    fftw_free(real);
+    fftw_free(complex);
+
+    if (!p){
+        throw std::runtime_error("Failed to create FFTW plan of size " + std::to_string(size));
+    }
+    plans[size] = p;
+    dirty_ = true;
+    return p;
+}
+
+bool FFTPlanCache::loadWisdom(const std::string& path){
+    std::lock_guard<std::mutex> lock(mutex_);
+    return fftw_import_wisdom_from_filename(path.c_str()) != 0;
+}
+
+bool FFTPlanCache::saveWisdom(const std::string& path){
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!dirty_){
+        return true;
+    }
+    if (!fftw_export_wisdom_to_filename(path.c_str())){
+        std::cerr << "Warning: could not save FFTW wisdom to " << path << std::endl;
+        return false;
+    }
+    dirty_ = false;
+    return true;
+}
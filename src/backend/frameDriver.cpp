@@ -0,0 +1,92 @@
+#include <algorithm>
+#include <stdexcept>
+#include "frameDriver.h"
+
+FrameDriver::FrameDriver() : capacity_(0), guard_(0), written_(0), finished_(false) {}
+
+void FrameDriver::add(FrameConsumer& consumer) {
+    if (capacity_ != 0 || finished_) {
+        throw std::logic_error("FrameDriver consumers must be added before the first push");
+    }
+    if (consumer.frameSize() == 0 || consumer.hopSize() == 0) {
+        throw std::invalid_argument("FrameDriver consumer needs a nonzero frame size and hop");
+    }
+    consumers_.push_back({&consumer, consumer.frameSize(), consumer.hopSize(), 0});
+}
+
+void FrameDriver::allocate() {
+    size_t largest = 1;
+    for (const Registration& r : consumers_) {
+        largest = std::max(largest, r.frameSize);
+    }
+    capacity_ = 1;
+    while (capacity_ < FRAME_DRIVER_RING_FRAMES * largest) {
+        capacity_ <<= 1;
+    }
+    guard_ = largest - 1;
+    ring_.resize(capacity_ + guard_);
+}
+
+//
+// Function: push
+// --------------
+// Copies the block into the ring in runs. A run may not overwrite samples of
+// a frame some consumer has yet to read, and stops at the end of the ring;
+// after each run every consumer is handed the frames it completed.
+//
+void FrameDriver::push(const Sample* block, size_t size) {
+    if (finished_) {
+        throw std::logic_error("FrameDriver::push after finish");
+    }
+    if (capacity_ == 0) {
+        allocate();
+    }
+    const size_t mask = capacity_ - 1;
+    Sample* ring = ring_.data();
+    while (size > 0) {
+        size_t oldest = written_;
+        for (const Registration& r : consumers_) {
+            oldest = std::min(oldest, r.next);
+        }
+        const size_t offset = written_ & mask;
+        const size_t run = std::min(std::min(size, oldest + capacity_ - written_), capacity_ - offset);
+
+        std::copy(block, block + run, ring + offset);
+        if (offset < guard_) {
+            std::copy(block, block + std::min(run, guard_ - offset), ring + capacity_ + offset);
+        }
+        written_ += run;
+        block += run;
+        size -= run;
+        dispatch();
+    }
+}
+
+void FrameDriver::dispatch() {
+    const size_t mask = capacity_ - 1;
+    for (Registration& r : consumers_) {
+        while (r.next + r.frameSize <= written_) {
+            r.consumer->consume(ring_.data() + (r.next & mask), r.next);
+            r.next += r.hopSize;
+        }
+    }
+}
+
+void FrameDriver::finish() {
+    if (finished_) {
+        return;
+    }
+    if (capacity_ == 0) {
+        allocate();
+    }
+    finished_ = true;
+    const size_t mask = capacity_ - 1;
+    for (Registration& r : consumers_) {
+        size_t rest = r.next < written_ ? written_ - r.next : 0;
+        r.consumer->flush(ring_.data() + (r.next & mask), rest);
+    }
+}
+
+size_t FrameDriver::size() const {
+    return written_;
+}
@@ -1,5 +1,6 @@
 #include <fstream>
 #include "generateMusicXML.h"
+#include "pitchSpelling.h"
 
 using namespace std;
 using namespace MusicXML2;
@@ -96,6 +97,8 @@ TElement MusicXMLGenerator::createScorePart(const string& partId,
 //------------------------------------------------------------------------------
 // Create a part by grouping the note sequence into measures.
 // This implementation splits notes crossing measure boundaries and ties them.
+// A note followed by notes with the chord flag set forms one chord: it takes
+// the first note's duration, and every chord tone is split and tied with it.
 //------------------------------------------------------------------------------
 TElement MusicXMLGenerator::createPart(const vector<XMLNote>& noteSequence,
     const string& clef,
@@ -112,19 +115,25 @@ TElement MusicXMLGenerator::createPart(const vector<XMLNote>& noteSequence,
     int currentDivision = 0;
     int measureNumber = 1;
     vector<TElement> currentMeasureNotes;
-    TElement tieCarryOver = nullptr;
-    int tieDurationCarryOver = 0; // store the duration of the carried-over tied note
+    vector<TElement> tieCarryOver;
+    int tieDurationCarryOver = 0; // store the duration of the carried-over tied notes
 
-    for (size_t i = 0; i < noteSequence.size(); i++) {
-        XMLNote note = noteSequence[i];
-        int remainingNoteDuration = note.duration;
+    for (size_t i = 0; i < noteSequence.size(); ) {
+        // The note and the chord tones that sound with it.
+        size_t chordEnd = i + 1;
+        while (chordEnd < noteSequence.size() && noteSequence[chordEnd].chord) {
+            chordEnd++;
+        }
+        vector<XMLNote> chord(noteSequence.begin() + i, noteSequence.begin() + chordEnd);
+        i = chordEnd;
+        int remainingNoteDuration = chord[0].duration;
 
-        // At the beginning of a measure, if there is a tied note carried over,
-        // add it and update the currentDivision.
-        if (currentDivision == 0 && tieCarryOver != nullptr) {
-            currentMeasureNotes.push_back(tieCarryOver);
+        // At the beginning of a measure, if there are tied notes carried over,
+        // add them and update the currentDivision.
+        if (currentDivision == 0 && !tieCarryOver.empty()) {
+            currentMeasureNotes.insert(currentMeasureNotes.end(), tieCarryOver.begin(), tieCarryOver.end());
             currentDivision += tieDurationCarryOver;
-            tieCarryOver = nullptr;
+            tieCarryOver.clear();
             tieDurationCarryOver = 0;
         }
 
@@ -136,32 +145,26 @@ TElement MusicXMLGenerator::createPart(const vector<XMLNote>& noteSequence,
                 currentDivision = 0;
                 currentMeasureNotes.clear();
                 spaceLeft = measureDivisions;
-                // If there's a carried-over tie note from before, add it.
-                if (tieCarryOver != nullptr) {
-                    currentMeasureNotes.push_back(tieCarryOver);
+                // If there are carried-over tie notes from before, add them.
+                if (!tieCarryOver.empty()) {
+                    currentMeasureNotes.insert(currentMeasureNotes.end(), tieCarryOver.begin(), tieCarryOver.end());
                     currentDivision += tieDurationCarryOver;
-                    tieCarryOver = nullptr;
+                    tieCarryOver.clear();
                     tieDurationCarryOver = 0;
                 }
             }
 
             if (remainingNoteDuration <= spaceLeft) {
-                XMLNote partialNote = note;
-                partialNote.duration = remainingNoteDuration;
-                partialNote.type = getNoteTypeFromDuration(partialNote.duration, divisions);
-                TElement noteElem = createNoteElement(partialNote, partialNote.duration, divisions);
-                currentMeasureNotes.push_back(noteElem);
+                vector<TElement> noteElems = createChordElements(chord, remainingNoteDuration, divisions);
+                currentMeasureNotes.insert(currentMeasureNotes.end(), noteElems.begin(), noteElems.end());
                 currentDivision += remainingNoteDuration;
                 remainingNoteDuration = 0;
             } else {
                 int durationThisMeasure = spaceLeft;
                 int durationNext = remainingNoteDuration - durationThisMeasure;
 
-                XMLNote partialNote1 = note;
-                partialNote1.duration = durationThisMeasure;
-                partialNote1.type = getNoteTypeFromDuration(durationThisMeasure, divisions);
-                TElement noteElem1 = createNoteElement(partialNote1, partialNote1.duration, divisions);
-                currentMeasureNotes.push_back(noteElem1);
+                vector<TElement> noteElems1 = createChordElements(chord, durationThisMeasure, divisions);
+                currentMeasureNotes.insert(currentMeasureNotes.end(), noteElems1.begin(), noteElems1.end());
                 currentDivision += durationThisMeasure;
                 remainingNoteDuration -= durationThisMeasure;
 
@@ -170,15 +173,13 @@ TElement MusicXMLGenerator::createPart(const vector<XMLNote>& noteSequence,
                 currentDivision = 0;
                 currentMeasureNotes.clear();
 
-                XMLNote partialNote2 = note;
-                partialNote2.duration = durationNext;
-                partialNote2.type = getNoteTypeFromDuration(durationNext, divisions);
-                TElement noteElem2 = createNoteElement(partialNote2, partialNote2.duration, divisions);
-
-                factoryTie(factory, noteElem1, noteElem2);
+                vector<TElement> noteElems2 = createChordElements(chord, durationNext, divisions);
+                for (size_t k = 0; k < chord.size(); k++) {
+                    factoryTie(factory, noteElems1[k], noteElems2[k]);
+                }
 
                 // Set tieCarryOver and record its duration so it reduces space in the new measure.
-                tieCarryOver = noteElem2;
+                tieCarryOver = noteElems2;
                 tieDurationCarryOver = durationNext;
                 remainingNoteDuration = 0;
                 break;
@@ -193,6 +194,27 @@ TElement MusicXMLGenerator::createPart(const vector<XMLNote>& noteSequence,
     return part;
 }
 
+//------------------------------------------------------------------------------
+// createChordElements: Creates one note element per chord tone, all with the
+// given duration, and marks every element after the first with <chord/>.
+//------------------------------------------------------------------------------
+vector<TElement> MusicXMLGenerator::createChordElements(const vector<XMLNote>& chord, int duration, int divisions)
+{
+    vector<TElement> elements;
+    for (const XMLNote& note : chord) {
+        XMLNote partialNote = note;
+        partialNote.duration = duration;
+        partialNote.type = getNoteTypeFromDuration(duration, divisions);
+        elements.push_back(createNoteElement(partialNote, duration, divisions));
+    }
+    if (elements.size() > 1) {
+        vector<TElement> chordList(elements);
+        chordList.push_back(nullptr); // factoryChord takes a null-terminated list
+        factoryChord(factory, chordList.data());
+    }
+    return elements;
+}
+
 //------------------------------------------------------------------------------
 // finishMeasure: Helper function to create a measure element from note elements,
 // then add it to the given part.
@@ -227,22 +249,22 @@ void MusicXMLGenerator::finishMeasure(TElement part,
 }
 
 //------------------------------------------------------------------------------
-// createNoteElement: Creates a note element. If note.isRest is true, uses factoryRest;
-// otherwise, factoryNote. The durationOverride is used to set the note's duration.
+// createNoteElement: Creates a note element. If note.isRest() is true, uses factoryRest;
+// otherwise, factoryNote with the step and octave spelled from the MIDI number. The durationOverride is used to set the note's duration.
 //------------------------------------------------------------------------------
 TElement MusicXMLGenerator::createNoteElement(const XMLNote& note, int durationOverride, int divisions)
 {
     int usedDuration = (durationOverride > 0) ? durationOverride : note.duration;
     std::string noteType = getNoteTypeFromDuration(usedDuration, divisions);
 
-    if (note.isRest) {
+    if (note.isRest()) {
         return factoryRest(factory, usedDuration, noteType.c_str());
     }
 
     return factoryNote(factory,
-        note.pitch.c_str(),
+        spelledStep(note.midi, note.alter),
         note.alter,
-        note.octave,
+        spelledOctave(note.midi, note.alter),
         usedDuration,
         noteType.c_str());
 }
\ No newline at end of file
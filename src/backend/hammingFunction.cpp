@@ -1,15 +1,8 @@
-#define _USE_MATH_DEFINES
 #include "hammingFunction.h"
-#include <cmath>
-#include <stdexcept>
+#include "windowRegistry.h"
 
+// Copy of the shared table; hot paths should use WindowRegistry directly.
 std::vector<double> hammingFunction(int windowSize) {
-    if (windowSize < 2) {
-        throw std::invalid_argument("Error: windowSize must be >= 2");
-    }
-    std::vector<double> window(windowSize);
-    for (int i = 0; i < windowSize; i++) {
-        window[i] = 0.54 - 0.46 * cos((2 * M_PI * i) / (windowSize - 1));
-    }
-    return window;
-}
\ No newline at end of file
+    Span<const double> window = WindowRegistry::instance().get<double>(WindowType::Hamming, windowSize);
+    return std::vector<double>(window.begin(), window.end());
+}
@@ -0,0 +1,124 @@
+#include "mappedFile.h"
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#ifdef _WIN32
+MappedFile::MappedFile()
+    : data_(nullptr), size_(0), fileHandle_(INVALID_HANDLE_VALUE), mappingHandle_(nullptr){}
+#else
+MappedFile::MappedFile()
+    : data_(nullptr), size_(0), fd_(-1){}
+#endif
+
+MappedFile::~MappedFile(){
+    close();
+}
+
+#ifdef _WIN32
+bool MappedFile::open(const std::string& path){
+    close();
+
+    HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+                              OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+    if (file == INVALID_HANDLE_VALUE){
+        return false;
+    }
+    fileHandle_ = file;
+
+    LARGE_INTEGER fileSize;
+    if (!GetFileSizeEx(file, &fileSize) || fileSize.QuadPart == 0){
+        close();
+        return false;
+    }
+    size_ = static_cast<size_t>(fileSize.QuadPart);
+
+    HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (!mapping){
+        close();
+        return false;
+    }
+    mappingHandle_ = mapping;
+
+    data_ = static_cast<const uint8_t*>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+    if (!data_){
+        close();
+        return false;
+    }
+    return true;
+}
+
+void MappedFile::close(){
+    if (data_){
+        UnmapViewOfFile(data_);
+    }
+    if (mappingHandle_){
+        CloseHandle(mappingHandle_);
+    }
+    if (fileHandle_ != INVALID_HANDLE_VALUE){
+        CloseHandle(fileHandle_);
+    }
+    data_ = nullptr;
+    size_ = 0;
+    mappingHandle_ = nullptr;
+    fileHandle_ = INVALID_HANDLE_VALUE;
+}
+#else
+bool MappedFile::open(const std::string& path){
+    close();
+
+    fd_ = ::open(path.c_str(), O_RDONLY);
+    if (fd_ < 0){
+        return false;
+    }
+
+    struct stat st;
+    if (fstat(fd_, &st) != 0 || st.st_size == 0){
+        close();
+        return false;
+    }
+    size_ = static_cast<size_t>(st.st_size);
+
+    void* mapped = mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd_, 0);
+    if (mapped == MAP_FAILED){
+        close();
+        return false;
+    }
+    // The data is consumed front to back exactly once.
+    madvise(mapped, size_, MADV_SEQUENTIAL);
+    data_ = static_cast<const uint8_t*>(mapped);
+    return true;
+}
+
+void MappedFile::close(){
+    if (data_){
+        munmap(const_cast<uint8_t*>(data_), size_);
+    }
+    if (fd_ >= 0){
+        ::close(fd_);
+    }
+    data_ = nullptr;
+    size_ = 0;
+    fd_ = -1;
+}
+#endif
+
+const uint8_t* MappedFile::data() const{
+    return data_;
+}
+
+size_t MappedFile::size() const{
+    return size_;
+}
+
+bool MappedFile::isOpen() const{
+    return data_ != nullptr;
+}
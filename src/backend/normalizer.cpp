@@ -0,0 +1,27 @@
+#include <algorithm>
+#include <cmath>
+#include "normalizer.h"
+
+template <typename T>
+Normalizer<T>::Normalizer(T peak)
+    : peak_(peak){}
+
+template <typename T>
+Normalizer<T>::~Normalizer(){}
+
+template <typename T>
+size_t Normalizer<T>::process(Span<const T> in, Span<T> out){
+    T maxAbs = 0;
+    for (size_t i = 0; i < in.size(); i++){
+        maxAbs = std::max(maxAbs, std::abs(in[i]));
+    }
+
+    const T scale = maxAbs > 0 ? peak_ / maxAbs : 1;
+    for (size_t i = 0; i < in.size(); i++){
+        out[i] = in[i] * scale;
+    }
+    return in.size();
+}
+
+template class Normalizer<float>;
+template class Normalizer<double>;
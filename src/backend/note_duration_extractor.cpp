@@ -1,71 +1,14 @@
 #define _USE_MATH_DEFINES
 #include "note_duration_extractor.h"
 
-//
-// Function: detectPitch
-// ---------------------
-// Uses an autocorrelation–based method to estimate the dominant pitch (in Hz)
-// from a windowed frame. Returns 0 if no clear pitch is detected.
-//
-double detectPitch(const std::vector<double>& frame, int sampleRate) {
-    int N = frame.size();
-    
-    double r0 = 0.0;
-    for (int i = 0; i < N; i++) {
-        r0 += frame[i] * frame[i];
-    }
-    if (r0 < 1e-6)
-        return 0.0;
-    
-    double minFreq = 100.0;
-    double maxFreq = 2000.0;
-    int maxLag = std::min(N - 1, static_cast<int>(sampleRate / minFreq));
-    int minLag = std::max(1, static_cast<int>(sampleRate / maxFreq));
-    
-    double bestCorr = 0.0;
-    int bestLag = 0;
-    for (int lag = minLag; lag <= maxLag; lag++) {
-        double sum = 0.0;
-        for (int i = 0; i < N - lag; i++) {
-            sum += frame[i] * frame[i + lag];
-        }
-        double normCorr = sum / r0;
-        if (normCorr > bestCorr) {
-            bestCorr = normCorr;
-            bestLag = lag;
-        }
-    }
-    if (bestCorr < 0.5)
-        return 0.0;
-    
-    return sampleRate / static_cast<double>(bestLag);
-}
-
-//
-// Function: frequencyToNoteString
-// -------------------------------
-// Converts a frequency (Hz) to a musical note name (e.g., "A4", "C#3").
-// Uses A4 = 440 Hz as reference. Frequencies <= 0 return "Rest".
-//
-std::string frequencyToNoteString(double frequency) {
-    if (frequency <= 0)
-        return "Rest";
-    int midiNote = static_cast<int>(std::round(12 * std::log2(frequency / 440.0))) + 69;
-    const char* noteNames[] = {"C", "C#", "D", "D#", "E", "F",
-                               "F#", "G", "G#", "A", "A#", "B"};
-    std::string note = noteNames[midiNote % 12];
-    int octave = midiNote / 12 - 1;
-    return note + std::to_string(octave);
-}
-
 // Internal structure to hold note segment information.
 struct NoteSegment {
-    std::string note;
+    int midi;       // MIDI note number, REST_MIDI for a rest
     int startFrame; // First frame index of the note.
     int endFrame;   // Last frame index of the note.
 };
 
-std::string determineNoteType(float noteDuration, int bpm) {
+static std::string noteTypeForBeats(float beatsPerNote) {
     // Predefined note durations
     std::map<std::string, float> note_durations = {
         {"sixteenth", 0.25},
@@ -77,9 +20,6 @@ std::string determineNoteType(float noteDuration, int bpm) {
         {"whole", 4.0}
     };
 
-    float beatDuration = 60.0f / bpm;
-    float beatsPerNote = noteDuration / beatDuration;
-
     auto closest = min_element(
         note_durations.begin(),
         note_durations.end(),
@@ -90,56 +30,200 @@ std::string determineNoteType(float noteDuration, int bpm) {
     return closest->first;
 }
 
+std::string determineNoteType(float noteDuration, int bpm) {
+    float beatDuration = 60.0f / bpm;
+    return noteTypeForBeats(noteDuration / beatDuration);
+}
+
+// Same arithmetic as above at the map's average tempo over the note, so a
+// constant map types notes exactly as its BPM does.
+std::string determineNoteType(double startTime, double endTime, const TempoMap& tempo) {
+    float noteDuration = endTime - startTime;
+    float beatDuration = 60.0f / static_cast<float>(tempo.averageBPM(startTime, endTime));
+    return noteTypeForBeats(noteDuration / beatDuration);
+}
+
+#define PITCH_FRAMES_PER_TASK 32
+
+static size_t countFrames(size_t numSamples, size_t frameSize, size_t hopSize) {
+    return numSamples < frameSize ? 0 : (numSamples - frameSize) / hopSize + 1;
+}
+
 //
-// Function: extract_note_durations
-// --------------------------------
-// Processes the WAV file and returns a vector of Note objects that contain
-// start time, end time, pitch (as a note string), and note type (set to "unknown").
-// Now also performs a simple onset detection: if an onset is detected in the middle
-// of a note segment, that segment is split into multiple notes.
+// Class: OnsetStream
+// ------------------
+// The energy feed runs first on every block of samples, so by the time an
+// onset frame (or any later consumer's frame) is complete, the envelope
+// already covers it and the frame's RMS is a constant-time lookup. An onset
+// time is recorded whenever that RMS rises sharply from the previous frame.
 //
-std::vector<Note> extract_note_durations(const char* infilename, int bpm) {
-    std::vector<Note> notes;
-    std::vector<double> audio;
-    int sampleRate;
-    if (!readWav(infilename, audio, sampleRate)) {
-        std::cerr << "Error reading WAV file.\n";
-        return notes;
+OnsetStream::OnsetStream(int sampleRate, std::vector<double>& onsetTimes, size_t hannLength,
+                         const FrameGeometry& geometry)
+    : sampleRate_(sampleRate),
+      geometry_(geometry),
+      onsetTimes_(onsetTimes),
+      envelope_(geometry.energyResolution, hannLength),
+      energyFeed_(*this),
+      onsetFrames_(*this),
+      nextOnsetFrame_(0),
+      prevOnsetRMS_(0.0) {}
+
+void OnsetStream::attach(FrameDriver& driver) {
+    driver.add(energyFeed_);
+    driver.add(onsetFrames_);
+}
+
+const EnergyEnvelope& OnsetStream::envelope() const {
+    return envelope_;
+}
+
+void OnsetStream::discardBefore(size_t index) {
+    envelope_.discardBefore(std::min(index, nextOnsetFrame_));
+}
+
+void OnsetStream::EnergyFeed::consume(const Sample* frame, size_t start) {
+    owner.envelope_.append(frame, owner.geometry_.energyResolution);
+}
+
+void OnsetStream::EnergyFeed::flush(const Sample* rest, size_t size) {
+    owner.envelope_.append(rest, size);
+}
+
+void OnsetStream::OnsetFrames::consume(const Sample* frame, size_t start) {
+    // Collect onset times (in seconds) when the RMS difference exceeds a threshold.
+    double rms = owner.envelope_.rms(start, owner.geometry_.onsetFrameSize);
+    if (start > 0 && AnalysisContext::isOnset(rms, owner.prevOnsetRMS_)) {
+        owner.onsetTimes_.push_back(start / static_cast<double>(owner.sampleRate_));
     }
-    
-    // Analysis parameters for pitch detection.
-    int frameSize = 2048;  // larger window for robust pitch detection
-    int hopSize   = 512;   // hop size in samples
-    
-    int totalSamples = static_cast<int>(audio.size());
-    int numFrames = (totalSamples >= frameSize) ? ((totalSamples - frameSize) / hopSize + 1) : 0;
-    
-    std::vector<double> window = hanningFunction(frameSize);
-    std::vector<double> pitchEstimates(numFrames, 0.0);
-    std::vector<double> frameRMS(numFrames, 0.0); // RMS energy per pitch frame
-    
-    // Compute pitch estimates and RMS using the larger window.
-    for (int frame = 0; frame < numFrames; frame++) {
-        int start = frame * hopSize;
-        std::vector<double> frameBuffer(frameSize);
-        double sumSq = 0.0;
-        for (int n = 0; n < frameSize; n++) {
-            frameBuffer[n] = audio[start + n] * window[n];
-            sumSq += frameBuffer[n] * frameBuffer[n];
+    owner.prevOnsetRMS_ = rms;
+    owner.nextOnsetFrame_ = start + owner.geometry_.onsetHopSize;
+}
+
+//
+// Class: StreamingFrameAnalyzer
+// -----------------------------
+// Pitch frames (PITCH_FRAME_SIZE / PITCH_HOP_SIZE unless the geometry is
+// scaled) are gated on their Hann-windowed RMS from the onset stream's
+// envelope and passed to the selected PitchEstimator. The driver hands every
+// frame over contiguously, whatever block boundaries it straddles; after each
+// one, envelope totals before the next pitch frame are dropped.
+//
+StreamingFrameAnalyzer::StreamingFrameAnalyzer(int sampleRate, const PitchOptions& pitchOptions,
+                                               const FrameGeometry& geometry)
+    : context_(sampleRate, pitchOptions, geometry.pitchFrameSize),
+      onsets_(sampleRate, analysis_.onsetTimes, geometry.pitchFrameSize, geometry) {
+    analysis_.sampleRate = sampleRate;
+    analysis_.frameSize = static_cast<int>(geometry.pitchFrameSize);
+    analysis_.hopSize = static_cast<int>(geometry.pitchHopSize);
+}
+
+void StreamingFrameAnalyzer::attach(FrameDriver& driver) {
+    onsets_.attach(driver);
+    driver.add(*this);
+}
+
+void StreamingFrameAnalyzer::push(const Sample* block, size_t size) {
+    if (!driver_) {
+        driver_.reset(new FrameDriver());
+        attach(*driver_);
+    }
+    driver_->push(block, size);
+}
+
+const FrameAnalysis& StreamingFrameAnalyzer::analysis() const {
+    return analysis_;
+}
+
+size_t StreamingFrameAnalyzer::frameSize() const {
+    return analysis_.frameSize;
+}
+
+size_t StreamingFrameAnalyzer::hopSize() const {
+    return analysis_.hopSize;
+}
+
+void StreamingFrameAnalyzer::consume(const Sample* frame, size_t start) {
+    analysis_.pitchEstimates.push_back(context_.pitchFrame(frame, onsets_.envelope().hannRMS(start)));
+    onsets_.discardBefore(start + analysis_.hopSize);
+}
+
+//
+// Function: analyzeFrames
+// -----------------------
+// Whole-signal analysis. One driver pass builds the EnergyEnvelope and finds
+// the onsets, alongside whatever else the caller registered; after that every
+// frame's RMS is a constant-time lookup. Pitch frames depend only on their
+// own samples, so they are split into chunks across the pool; each worker has
+// its own AnalysisContext, and results land at their frame index, so the
+// output is identical to the streaming path.
+//
+FrameAnalysis analyzeFrames(const Sample* samples, size_t numSamples, int sampleRate, FrameDriver& driver,
+                            ThreadPool& pool, const PitchOptions& pitchOptions, const FrameGeometry& geometry) {
+    FrameAnalysis analysis;
+    analysis.sampleRate = sampleRate;
+    analysis.frameSize = static_cast<int>(geometry.pitchFrameSize);
+    analysis.hopSize = static_cast<int>(geometry.pitchHopSize);
+    const int frameSize = analysis.frameSize;
+    const int hopSize = analysis.hopSize;
+
+    OnsetStream onsets(sampleRate, analysis.onsetTimes, frameSize, geometry);
+    onsets.attach(driver);
+    driver.push(samples, numSamples);
+    driver.finish();
+    const EnergyEnvelope& envelope = onsets.envelope();
+
+    std::vector<std::unique_ptr<AnalysisContext>> contexts(pool.size());
+    const size_t pitchFrames = countFrames(numSamples, frameSize, hopSize);
+    analysis.pitchEstimates.resize(pitchFrames);
+    pool.parallelFor(pitchFrames, PITCH_FRAMES_PER_TASK, [&](size_t first, size_t last, size_t worker) {
+        if (!contexts[worker]) {
+            contexts[worker].reset(new AnalysisContext(sampleRate, pitchOptions, frameSize));
         }
-        double rms = std::sqrt(sumSq / frameSize);
-        frameRMS[frame] = rms;
-        if (rms < 0.001) {
-            pitchEstimates[frame] = 0.0;
-        } else {
-            double pitch = detectPitch(frameBuffer, sampleRate);
-            pitchEstimates[frame] = pitch;
+        AnalysisContext& context = *contexts[worker];
+        for (size_t f = first; f < last; f++) {
+            analysis.pitchEstimates[f] = context.pitchFrame(samples + f * hopSize, envelope.hannRMS(f * hopSize));
         }
-    }
-        
+    });
+    return analysis;
+}
+
+FrameAnalysis analyzeFrames(const Sample* samples, size_t numSamples, int sampleRate,
+                            ThreadPool& pool, const PitchOptions& pitchOptions, const FrameGeometry& geometry) {
+    FrameDriver driver;
+    return analyzeFrames(samples, numSamples, sampleRate, driver, pool, pitchOptions, geometry);
+}
+
+FrameAnalysis analyzeFrames(const Sample* samples, size_t numSamples, int sampleRate,
+                            const PitchOptions& pitchOptions, const FrameGeometry& geometry) {
+    return analyzeFrames(samples, numSamples, sampleRate, ThreadPool::shared(), pitchOptions, geometry);
+}
+
+//
+// Function: segmentNotes
+// ----------------------
+// Groups frame pitch estimates into note and rest segments, merges repeated
+// notes separated by tiny gaps, and splits notes where an onset is detected in
+// the middle of a segment.
+//
+std::vector<Note> segmentNotes(const FrameAnalysis& analysis, int bpm) {
+    return segmentNotes(analysis, TempoMap::constant(bpm));
+}
+
+std::vector<Note> segmentNotes(const FrameAnalysis& analysis, const TempoMap& tempo) {
+    std::vector<Note> notes;
+    const std::vector<double>& pitchEstimates = analysis.pitchEstimates;
+    const std::vector<double>& onsetTimes = analysis.onsetTimes;
+    const int sampleRate = analysis.sampleRate;
+    const int frameSize = analysis.frameSize;
+    const int hopSize = analysis.hopSize;
+    const int numFrames = static_cast<int>(pitchEstimates.size());
+
     // Segment frames into note and rest segments.
     double tolerance = 0.05;         // allow ~4% pitch variation within a note
-    double minNoteDuration = 60.0 / (bpm * 4); // minimum segment duration in seconds
+    // A segment must last a sixteenth note at the tempo where it starts.
+    auto longEnough = [&](double startTime, double duration) {
+        return duration >= 60.0 / (tempo.bpmAt(startTime) * 4);
+    };
     bool inSegment = false;
     bool isNoteSegment = false;      // true if current segment is a note, false if a rest
     double currentPitch = 0.0;       // used if in a note segment
@@ -163,9 +247,8 @@ std::vector<Note> extract_note_durations(const char* infilename, int bpm) {
                     double startTime = segmentStartFrame * hopSize / static_cast<double>(sampleRate);
                     double endTime = (segmentEndFrame * hopSize + frameSize) / static_cast<double>(sampleRate);
                     double duration = endTime - startTime;
-                    if (duration >= minNoteDuration) {
-                        std::string noteName = frequencyToNoteString(currentPitch);
-                        segments.push_back({noteName, segmentStartFrame, segmentEndFrame});
+                    if (longEnough(startTime, duration)) {
+                        segments.push_back({frequencyToMidi(currentPitch), segmentStartFrame, segmentEndFrame});
                     }
                     // Start a new segment.
                     inSegment = true;
@@ -181,8 +264,8 @@ std::vector<Note> extract_note_durations(const char* infilename, int bpm) {
                     double startTime = segmentStartFrame * hopSize / static_cast<double>(sampleRate);
                     double endTime = (segmentEndFrame * hopSize + frameSize) / static_cast<double>(sampleRate);
                     double duration = endTime - startTime;
-                    if (duration >= minNoteDuration) {
-                        segments.push_back({"Rest", segmentStartFrame, segmentEndFrame});
+                    if (longEnough(startTime, duration)) {
+                        segments.push_back({REST_MIDI, segmentStartFrame, segmentEndFrame});
                     }
                     inSegment = true;
                     segmentStartFrame = i;
@@ -197,12 +280,11 @@ std::vector<Note> extract_note_durations(const char* infilename, int bpm) {
         double startTime = segmentStartFrame * hopSize / static_cast<double>(sampleRate);
         double endTime = (segmentEndFrame * hopSize + frameSize) / static_cast<double>(sampleRate);
         double duration = endTime - startTime;
-        if (duration >= minNoteDuration) {
+        if (longEnough(startTime, duration)) {
             if (isNoteSegment) {
-                std::string noteName = frequencyToNoteString(currentPitch);
-                segments.push_back({noteName, segmentStartFrame, segmentEndFrame});
+                segments.push_back({frequencyToMidi(currentPitch), segmentStartFrame, segmentEndFrame});
             } else {
-                segments.push_back({"Rest", segmentStartFrame, segmentEndFrame});
+                segments.push_back({REST_MIDI, segmentStartFrame, segmentEndFrame});
             }
         }
     }
@@ -217,7 +299,7 @@ std::vector<Note> extract_note_durations(const char* infilename, int bpm) {
             NoteSegment &curr = segments[i];
             double prevEndTime = (prev.endFrame * hopSize + frameSize) / static_cast<double>(sampleRate);
             double currStartTime = (curr.startFrame * hopSize) / static_cast<double>(sampleRate);
-            if (prev.note == curr.note && (currStartTime - prevEndTime) < mergeThreshold) {
+            if (prev.midi == curr.midi && (currStartTime - prevEndTime) < mergeThreshold) {
                 prev.endFrame = curr.endFrame;
             } else {
                 mergedSegments.push_back(curr);
@@ -225,36 +307,12 @@ std::vector<Note> extract_note_durations(const char* infilename, int bpm) {
         }
     }
     
-    // --- Onset Detection with a Smaller Window ---
-    int onsetFrameSize = 512;  // smaller window for onset detection
-    int onsetHopSize = 256;    // higher time resolution
-    int numOnsetFrames = (totalSamples >= onsetFrameSize) ?
-                         ((totalSamples - onsetFrameSize) / onsetHopSize + 1) : 0;
-    std::vector<double> onsetRMS(numOnsetFrames, 0.0);
-    for (int i = 0; i < numOnsetFrames; i++) {
-        int start = i * onsetHopSize;
-        double sumSq = 0.0;
-        for (int n = 0; n < onsetFrameSize; n++) {
-            sumSq += audio[start + n] * audio[start + n];
-        }
-        onsetRMS[i] = std::sqrt(sumSq / onsetFrameSize);
-    }
-    // Collect onset times (in seconds) when the RMS difference exceeds a threshold.
-    std::vector<double> onsetTimes;
-    double onsetThresholdSmall = 0.02;  // adjust as needed
-    for (int i = 1; i < numOnsetFrames; i++) {
-        if ((onsetRMS[i] - onsetRMS[i - 1]) > onsetThresholdSmall) {
-            double T = (i * onsetHopSize) / static_cast<double>(sampleRate);
-            onsetTimes.push_back(T);
-        }
-    }
-    
     // --- Split Note Segments at Onsets ---
     // For each merged note segment (ignoring rests), check if any onset (from the small-window analysis)
     // occurs within its time boundaries. If so, split the segment at the corresponding pitch-frame indices.
     std::vector<NoteSegment> finalSegments;
     for (const auto &seg : mergedSegments) {
-        if (seg.note != "Rest") {
+        if (seg.midi != REST_MIDI) {
             double segStartTime = seg.startFrame * hopSize / static_cast<double>(sampleRate);
             double segEndTime = (seg.endFrame * hopSize + frameSize) / static_cast<double>(sampleRate);
             std::vector<int> splitPoints;
@@ -275,15 +333,15 @@ std::vector<Note> extract_note_durations(const char* infilename, int bpm) {
                     double startTime = currentStart * hopSize / static_cast<double>(sampleRate);
                     double endTime = (segmentEnd * hopSize + frameSize) / static_cast<double>(sampleRate);
                     double duration = endTime - startTime;
-                    if (duration >= minNoteDuration)
-                        finalSegments.push_back({seg.note, currentStart, segmentEnd});
+                    if (longEnough(startTime, duration))
+                        finalSegments.push_back({seg.midi, currentStart, segmentEnd});
                     currentStart = pf;
                 }
                 double startTimeFinal = currentStart * hopSize / static_cast<double>(sampleRate);
                 double endTimeFinal = (seg.endFrame * hopSize + frameSize) / static_cast<double>(sampleRate);
                 double durationFinal = endTimeFinal - startTimeFinal;
-                if (durationFinal >= minNoteDuration)
-                    finalSegments.push_back({seg.note, currentStart, seg.endFrame});
+                if (longEnough(startTimeFinal, durationFinal))
+                    finalSegments.push_back({seg.midi, currentStart, seg.endFrame});
             }
         } else {
             finalSegments.push_back(seg);
@@ -294,10 +352,38 @@ std::vector<Note> extract_note_durations(const char* infilename, int bpm) {
     for (const auto &seg : finalSegments) {
         double startTime = seg.startFrame * hopSize / static_cast<double>(sampleRate);
         double endTime = (seg.endFrame * hopSize + frameSize) / static_cast<double>(sampleRate);
-        std::string noteType = determineNoteType((endTime - startTime), bpm);
-        notes.push_back({static_cast<float>(startTime), static_cast<float>(endTime), seg.note, noteType});
-        std::cout << "Note: " << seg.note << " | Start Time: " << startTime 
+        std::string noteType = determineNoteType(startTime, endTime, tempo);
+        notes.push_back({static_cast<float>(startTime), static_cast<float>(endTime), seg.midi, noteType});
+        std::cout << "Note: " << midiToNoteString(seg.midi) << " | Start Time: " << startTime 
                   << " s | End Time: " << endTime << " s | Type: " << noteType << "\n";
     }
     return notes;
 }
+
+//
+// Function: extract_note_durations
+// --------------------------------
+// Processes the WAV file and returns a vector of Note objects that contain
+// start time, end time, pitch (as a MIDI note number), and note type.
+// Now also performs a simple onset detection: if an onset is detected in the middle
+// of a note segment, that segment is split into multiple notes.
+//
+std::vector<Note> extract_note_durations(const char* infilename, int bpm, const PitchOptions& pitchOptions) {
+    std::vector<Sample> audio;
+    int sampleRate;
+    if (!readWav(infilename, audio, sampleRate)) {
+        std::cerr << "Error reading WAV file.\n";
+        return std::vector<Note>();
+    }
+    return extract_note_durations(audio.data(), audio.size(), sampleRate, bpm, pitchOptions);
+}
+
+std::vector<Note> extract_note_durations(const std::vector<Sample>& samples, int sampleRate, int bpm,
+                                         const PitchOptions& pitchOptions) {
+    return extract_note_durations(samples.data(), samples.size(), sampleRate, bpm, pitchOptions);
+}
+
+std::vector<Note> extract_note_durations(const Sample* audio, size_t numSamples, int sampleRate, int bpm,
+                                         const PitchOptions& pitchOptions) {
+    return segmentNotes(analyzeFrames(audio, numSamples, sampleRate, pitchOptions), bpm);
+}
\ No newline at end of file
@@ -0,0 +1,472 @@
+#define _USE_MATH_DEFINES
+#include "pitchEstimator.h"
+#include "simd.h"
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+//
+// Lag kernels
+// -----------
+// Sums over two runs of n samples, accumulated in double. The SSE2 paths
+// widen four floats at a time into two double lanes each.
+//
+static double dotProduct(const Sample* a, const Sample* b, size_t n) {
+    double sum = 0.0;
+    size_t i = 0;
+#ifdef SCOREGEN_SSE2
+    __m128d acc0 = _mm_setzero_pd();
+    __m128d acc1 = _mm_setzero_pd();
+    for (; i + 4 <= n; i += 4) {
+        __m128 va = _mm_loadu_ps(a + i);
+        __m128 vb = _mm_loadu_ps(b + i);
+        acc0 = _mm_add_pd(acc0, _mm_mul_pd(_mm_cvtps_pd(va), _mm_cvtps_pd(vb)));
+        acc1 = _mm_add_pd(acc1, _mm_mul_pd(_mm_cvtps_pd(_mm_movehl_ps(va, va)),
+                                           _mm_cvtps_pd(_mm_movehl_ps(vb, vb))));
+    }
+    double lanes[2];
+    _mm_storeu_pd(lanes, _mm_add_pd(acc0, acc1));
+    sum = lanes[0] + lanes[1];
+#endif
+    for (; i < n; i++) {
+        sum += static_cast<double>(a[i]) * b[i];
+    }
+    return sum;
+}
+
+static double squaredDifference(const Sample* a, const Sample* b, size_t n) {
+    double sum = 0.0;
+    size_t i = 0;
+#ifdef SCOREGEN_SSE2
+    __m128d acc0 = _mm_setzero_pd();
+    __m128d acc1 = _mm_setzero_pd();
+    for (; i + 4 <= n; i += 4) {
+        __m128 va = _mm_loadu_ps(a + i);
+        __m128 vb = _mm_loadu_ps(b + i);
+        __m128d d0 = _mm_sub_pd(_mm_cvtps_pd(va), _mm_cvtps_pd(vb));
+        __m128d d1 = _mm_sub_pd(_mm_cvtps_pd(_mm_movehl_ps(va, va)), _mm_cvtps_pd(_mm_movehl_ps(vb, vb)));
+        acc0 = _mm_add_pd(acc0, _mm_mul_pd(d0, d0));
+        acc1 = _mm_add_pd(acc1, _mm_mul_pd(d1, d1));
+    }
+    double lanes[2];
+    _mm_storeu_pd(lanes, _mm_add_pd(acc0, acc1));
+    sum = lanes[0] + lanes[1];
+#endif
+    for (; i < n; i++) {
+        double d = static_cast<double>(a[i]) - b[i];
+        sum += d * d;
+    }
+    return sum;
+}
+
+// Offset in (-1, 1) of the vertex of the parabola through (-1, a), (0, b),
+// (1, c), used to refine a lag to sub-sample precision.
+static double parabolicOffset(double a, double b, double c) {
+    double denominator = a - 2.0 * b + c;
+    if (denominator == 0.0) {
+        return 0.0;
+    }
+    return std::max(-1.0, std::min(1.0, 0.5 * (a - c) / denominator));
+}
+
+// Lag search range for the difference-based methods. The longest lag is kept
+// to three quarters of the frame so every lag still compares a quarter frame.
+static bool lagRange(const PitchOptions& options, size_t size, int sampleRate,
+                     size_t& minLag, size_t& maxLag) {
+    maxLag = std::min(size * 3 / 4, static_cast<size_t>(sampleRate / options.minFrequency));
+    minLag = std::max<size_t>(2, static_cast<size_t>(sampleRate / options.maxFrequency));
+    return minLag < maxLag;
+}
+
+PitchOptions defaultPitchOptions(PitchMethod method) {
+    PitchOptions options;
+    options.method = method;
+    switch (method) {
+    case PitchMethod::YIN:
+        options.minFrequency = 27.5;
+        options.maxFrequency = 4200.0;
+        options.threshold = 0.15;
+        break;
+    case PitchMethod::MPM:
+        options.minFrequency = 27.5;
+        options.maxFrequency = 4200.0;
+        options.threshold = 0.93;
+        break;
+    case PitchMethod::Autocorrelation:
+        break;
+    }
+    return options;
+}
+
+std::unique_ptr<PitchEstimator> makePitchEstimator(const PitchOptions& options) {
+    switch (options.method) {
+    case PitchMethod::YIN:
+        return std::unique_ptr<PitchEstimator>(new YinPitchEstimator(options));
+    case PitchMethod::MPM:
+        return std::unique_ptr<PitchEstimator>(new McLeodPitchEstimator(options));
+    case PitchMethod::Autocorrelation:
+        break;
+    }
+    return std::unique_ptr<PitchEstimator>(new AutocorrelationPitchEstimator(options));
+}
+
+//
+// Class: AutocorrelationPitchEstimator
+// ------------------------------------
+// Picks the lag with the highest autocorrelation normalized by r(0) and
+// reports it if it clears the threshold. The lag correlations come from the
+// FFT-based Autocorrelator, which reuses its plans and buffers across frames.
+// With decimation > 1 the search runs coarse-to-fine instead (see
+// estimateCoarseToFine).
+//
+AutocorrelationPitchEstimator::AutocorrelationPitchEstimator(const PitchOptions& options)
+    : options_(options) {
+    if (options_.decimation < 1) {
+        throw std::invalid_argument("Pitch decimation factor must be at least 1");
+    }
+    if (options_.decimation == 1) {
+        return;
+    }
+    // Hamming-windowed sinc cutting off just below the decimated Nyquist.
+    const int length = PITCH_DECIMATION_TAPS_PER_FACTOR * options_.decimation + 1;
+    const int half = length / 2;
+    const double cutoff = 0.45 / options_.decimation; // cycles per sample
+    double sum = 0.0;
+    decimationTaps_.resize(length);
+    for (int n = 0; n < length; n++) {
+        double x = n - half;
+        double sinc = x == 0.0 ? 2.0 * cutoff : std::sin(2.0 * M_PI * cutoff * x) / (M_PI * x);
+        decimationTaps_[n] = sinc * (0.54 - 0.46 * std::cos(2.0 * M_PI * n / (length - 1)));
+        sum += decimationTaps_[n];
+    }
+    for (double& tap : decimationTaps_) {
+        tap /= sum;
+    }
+}
+
+double AutocorrelationPitchEstimator::estimate(const Sample* frame, size_t size, int sampleRate, ScratchArena& scratch) {
+    int N = static_cast<int>(size);
+
+    double r0 = 0.0;
+    for (int i = 0; i < N; i++) {
+        r0 += static_cast<double>(frame[i]) * frame[i];
+    }
+    if (r0 < 1e-6)
+        return 0.0;
+
+    int maxLag = std::min(N - 1, static_cast<int>(sampleRate / options_.minFrequency));
+    int minLag = std::max(1, static_cast<int>(sampleRate / options_.maxFrequency));
+    if (maxLag < minLag)
+        return 0.0;
+    if (options_.decimation > 1) {
+        return estimateCoarseToFine(frame, size, sampleRate, r0, minLag, maxLag, scratch);
+    }
+
+    ScratchArena::Scope scope(scratch);
+    double* correlation = scratch.allocate<double>(maxLag + 1);
+    autocorrelator_.compute(frame, size, maxLag, correlation, scratch);
+
+    double bestCorr = 0.0;
+    int bestLag = 0;
+    for (int lag = minLag; lag <= maxLag; lag++) {
+        double normCorr = correlation[lag] / r0;
+        if (normCorr > bestCorr) {
+            bestCorr = normCorr;
+            bestLag = lag;
+        }
+    }
+    if (bestCorr < options_.threshold)
+        return 0.0;
+
+    return sampleRate / static_cast<double>(bestLag);
+}
+
+//
+// Function: estimateCoarseToFine
+// ------------------------------
+// Low-passes and decimates the frame by D, takes the highest local maxima of
+// the decimated autocorrelation as candidates, and evaluates full-rate lags
+// only within D samples of each candidate's position, plus the few shortest
+// lags the decimated signal cannot resolve. The best refined lag is
+// thresholded as in the full search and interpolated parabolically. The FFT
+// shrinks by D and the refinement costs a few dozen lags, against every lag in
+// [minLag, maxLag] for the full search.
+//
+double AutocorrelationPitchEstimator::estimateCoarseToFine(const Sample* frame, size_t size, int sampleRate,
+                                                           double r0, int minLag, int maxLag,
+                                                           ScratchArena& scratch) {
+    const int D = options_.decimation;
+    const int N = static_cast<int>(size);
+    const int M = N / D;
+    // Periods under PITCH_COARSE_MIN_PERIOD decimated samples are too coarsely
+    // sampled to rank, so those lags are searched at full rate directly.
+    const int directMax = std::min(maxLag, D * PITCH_COARSE_MIN_PERIOD - 1);
+    const int coarseMax = std::min(M - 1, maxLag / D + 1);
+    const int coarseMin = std::max(PITCH_COARSE_MIN_PERIOD, minLag / D);
+
+    ScratchArena::Scope scope(scratch);
+    int candidates[PITCH_COARSE_CANDIDATES];
+    int numCandidates = 0;
+    if (coarseMin <= coarseMax) {
+        Sample* decimated = scratch.allocate<Sample>(M);
+        const int taps = static_cast<int>(decimationTaps_.size());
+        const int half = taps / 2;
+        for (int k = 0; k < M; k++) {
+            const int center = k * D;
+            const int first = std::max(0, half - center);
+            const int last = std::min(taps, N - center + half);
+            double acc = 0.0;
+            for (int t = first; t < last; t++) {
+                acc += decimationTaps_[t] * frame[center + t - half];
+            }
+            decimated[k] = static_cast<Sample>(acc);
+        }
+
+        double* correlation = scratch.allocate<double>(coarseMax + 1);
+        autocorrelator_.compute(decimated, M, coarseMax, correlation, scratch);
+
+        // The highest local maxima, best first; the range ends count as maxima.
+        // A period a few coarse lags long falls between samples, so maxima are
+        // ranked by the height of the parabola through them, not the sample.
+        double heights[PITCH_COARSE_CANDIDATES];
+        for (int lag = coarseMin; lag <= coarseMax; lag++) {
+            double c = correlation[lag];
+            if ((lag > coarseMin && correlation[lag - 1] > c) || (lag < coarseMax && correlation[lag + 1] > c)) {
+                continue;
+            }
+            double height = c;
+            if (lag > coarseMin && lag < coarseMax) {
+                double a = correlation[lag - 1];
+                double b = correlation[lag + 1];
+                height -= 0.25 * (a - b) * parabolicOffset(a, c, b);
+            }
+            int slot = numCandidates;
+            while (slot > 0 && heights[slot - 1] < height) {
+                slot--;
+            }
+            if (slot >= PITCH_COARSE_CANDIDATES) {
+                continue;
+            }
+            numCandidates = std::min(numCandidates + 1, PITCH_COARSE_CANDIDATES);
+            for (int i = numCandidates - 1; i > slot; i--) {
+                candidates[i] = candidates[i - 1];
+                heights[i] = heights[i - 1];
+            }
+            candidates[slot] = lag;
+            heights[slot] = height;
+        }
+    }
+
+    double bestCorr = 0.0;
+    int bestLag = 0;
+    for (int lag = minLag; lag <= directMax; lag++) {
+        double normCorr = dotProduct(frame, frame + lag, N - lag) / r0;
+        if (normCorr > bestCorr) {
+            bestCorr = normCorr;
+            bestLag = lag;
+        }
+    }
+    for (int i = 0; i < numCandidates; i++) {
+        const int from = std::max(minLag, (candidates[i] - 1) * D);
+        const int to = std::min(maxLag, (candidates[i] + 1) * D);
+        for (int lag = from; lag <= to; lag++) {
+            double normCorr = dotProduct(frame, frame + lag, N - lag) / r0;
+            if (normCorr > bestCorr) {
+                bestCorr = normCorr;
+                bestLag = lag;
+            }
+        }
+    }
+    if (bestCorr < options_.threshold)
+        return 0.0;
+
+    // Interpolated only at a true peak; at a range end the best lag may be
+    // on a slope.
+    double period = static_cast<double>(bestLag);
+    double before = dotProduct(frame, frame + bestLag - 1, N - bestLag + 1) / r0;
+    double after = bestLag + 1 < N ? dotProduct(frame, frame + bestLag + 1, N - bestLag - 1) / r0 : 0.0;
+    if (before <= bestCorr && after <= bestCorr) {
+        period += parabolicOffset(before, bestCorr, after);
+    }
+    return sampleRate / period;
+}
+
+//
+// Class: YinPitchEstimator
+// ------------------------
+// YIN (de Cheveigne & Kawahara, 2002). The difference function
+// d(tau) = sum_{j < W} (x[j] - x[j + tau])^2 is normalized by its running mean,
+// and the first dip below the threshold, followed down to its local minimum,
+// gives the period. With early termination d(tau) is evaluated one lag at a
+// time by the SIMD kernel and the scan stops at that minimum, so high notes
+// never touch the long lags. Otherwise every lag comes from one FFT
+// cross-correlation: d(tau) = E[0, W) + E[tau, tau + W) - 2 c(tau).
+//
+YinPitchEstimator::YinPitchEstimator(const PitchOptions& options)
+    : options_(options) {}
+
+double YinPitchEstimator::estimate(const Sample* frame, size_t size, int sampleRate, ScratchArena& scratch) {
+    size_t minLag, maxLag;
+    if (!lagRange(options_, size, sampleRate, minLag, maxLag)) {
+        return 0.0;
+    }
+    const size_t window = size - maxLag;
+    ScratchArena::Scope scope(scratch);
+    double* difference = scratch.allocate<double>(maxLag + 1);
+
+    if (!options_.earlyTermination) {
+        double* energy = scratch.allocate<double>(size + 1); // prefix sums of x^2
+        energy[0] = 0.0;
+        for (size_t i = 0; i < size; i++) {
+            energy[i + 1] = energy[i] + static_cast<double>(frame[i]) * frame[i];
+        }
+        autocorrelator_.computeWindowed(frame, size, window, maxLag, difference, scratch);
+        const double e0 = energy[window];
+        for (size_t tau = 0; tau <= maxLag; tau++) {
+            double d = e0 + (energy[tau + window] - energy[tau]) - 2.0 * difference[tau];
+            difference[tau] = std::max(0.0, d);
+        }
+    }
+
+    // difference is overwritten in place with the normalized values d'(tau).
+    double runningSum = 0.0;
+    size_t found = 0;
+    size_t computed = 0;
+    difference[0] = 1.0;
+    for (size_t tau = 1; tau <= maxLag; tau++) {
+        double d = options_.earlyTermination ? squaredDifference(frame, frame + tau, window)
+                                             : difference[tau];
+        runningSum += d;
+        difference[tau] = runningSum > 0.0 ? d * tau / runningSum : 1.0;
+        computed = tau;
+
+        if (found == 0) {
+            if (tau >= minLag && difference[tau] < options_.threshold) {
+                found = tau;
+            }
+        } else if (difference[tau] < difference[found]) {
+            found = tau;
+        } else {
+            break;
+        }
+    }
+    if (found == 0) {
+        return 0.0;
+    }
+
+    double period = static_cast<double>(found);
+    if (found < computed) {
+        period += parabolicOffset(difference[found - 1], difference[found], difference[found + 1]);
+    }
+    return sampleRate / period;
+}
+
+//
+// Class: McLeodPitchEstimator
+// ---------------------------
+// McLeod pitch method (McLeod & Wyvill, 2005). The normalized square
+// difference n(tau) = 2 r(tau) / m(tau), with m(tau) the energy of both
+// overlapping runs, lies in [-1, 1]. Each positive region after the first
+// zero crossing contributes its maximum as a key maximum; the first key
+// maximum reaching threshold * (best key maximum) is the period. With early
+// termination r(tau) is evaluated lag by lag by the SIMD kernel and the search
+// stops once that choice can no longer change: clarity never exceeds 1, so a
+// candidate whose clarity reaches the threshold itself stays above any later
+// cutoff. Otherwise r(tau) comes from the FFT Autocorrelator. Both paths pick
+// the same key maximum.
+//
+McLeodPitchEstimator::McLeodPitchEstimator(const PitchOptions& options)
+    : options_(options) {}
+
+double McLeodPitchEstimator::estimate(const Sample* frame, size_t size, int sampleRate, ScratchArena& scratch) {
+    size_t minLag, maxLag;
+    if (!lagRange(options_, size, sampleRate, minLag, maxLag)) {
+        return 0.0;
+    }
+    const bool early = options_.earlyTermination;
+    ScratchArena::Scope scope(scratch);
+    double* correlation = nullptr;
+    if (!early) {
+        correlation = scratch.allocate<double>(maxLag + 1);
+        autocorrelator_.compute(frame, size, maxLag, correlation, scratch);
+    }
+    const double r0 = early ? dotProduct(frame, frame, size) : correlation[0];
+    if (r0 <= 0.0) {
+        return 0.0;
+    }
+
+    double* nsdf = scratch.allocate<double>(maxLag + 1);
+    // Positive regions are separated by at least one non-positive lag.
+    size_t* keyMaxima = scratch.allocate<size_t>(maxLag / 2 + 2);
+    size_t numKeyMaxima = 0;
+    nsdf[0] = 1.0;
+    double m = 2.0 * r0;
+    bool pastFirstZero = false;
+    size_t regionPeak = 0;   // lag of the maximum in the current positive region
+    size_t chosen = 0;
+    size_t bestPeak = 0;
+    size_t candidate = 0;    // first key maximum reaching the cutoff so far
+    size_t computed = 0;
+
+    for (size_t tau = 1; tau <= maxLag; tau++) {
+        double r = early ? dotProduct(frame, frame + tau, size - tau) : correlation[tau];
+        m -= static_cast<double>(frame[tau - 1]) * frame[tau - 1] +
+             static_cast<double>(frame[size - tau]) * frame[size - tau];
+        nsdf[tau] = m > 0.0 ? 2.0 * r / m : 0.0;
+        computed = tau;
+
+        if (nsdf[tau] <= 0.0) {
+            pastFirstZero = true;
+            if (regionPeak != 0) {
+                // The positive region just closed.
+                keyMaxima[numKeyMaxima++] = regionPeak;
+                if (bestPeak == 0 || nsdf[regionPeak] > nsdf[bestPeak]) {
+                    bestPeak = regionPeak;
+                }
+                regionPeak = 0;
+                if (early) {
+                    // The cutoff only rises as the best grows, so the
+                    // candidate only moves forward.
+                    while (candidate + 1 < numKeyMaxima && nsdf[keyMaxima[candidate]] < options_.threshold * nsdf[bestPeak]) {
+                        candidate++;
+                    }
+                    if (nsdf[keyMaxima[candidate]] >= options_.threshold) {
+                        chosen = keyMaxima[candidate];
+                        break;
+                    }
+                }
+            }
+        } else if (pastFirstZero && tau >= minLag) {
+            if (regionPeak == 0 || nsdf[tau] > nsdf[regionPeak]) {
+                regionPeak = tau;
+            }
+        }
+    }
+    if (chosen == 0) {
+        if (regionPeak != 0) {
+            keyMaxima[numKeyMaxima++] = regionPeak;
+            if (bestPeak == 0 || nsdf[regionPeak] > nsdf[bestPeak]) {
+                bestPeak = regionPeak;
+            }
+        }
+        if (bestPeak == 0) {
+            return 0.0;
+        }
+        const double cutoff = options_.threshold * nsdf[bestPeak];
+        for (size_t i = 0; i < numKeyMaxima; i++) {
+            if (nsdf[keyMaxima[i]] >= cutoff) {
+                chosen = keyMaxima[i];
+                break;
+            }
+        }
+    }
+    if (nsdf[chosen] < MPM_MIN_CLARITY) {
+        return 0.0;
+    }
+
+    double period = static_cast<double>(chosen);
+    if (chosen < computed) {
+        period += parabolicOffset(nsdf[chosen - 1], nsdf[chosen], nsdf[chosen + 1]);
+    }
+    return sampleRate / period;
+}
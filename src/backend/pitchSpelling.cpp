@@ -0,0 +1,41 @@
+#include <cmath>
+#include <stdexcept>
+#include "pitchSpelling.h"
+
+// Letter of each natural pitch class; nullptr for black keys.
+static const char* const NATURAL_STEPS[12] = {"C", nullptr, "D", nullptr, "E", "F",
+                                              nullptr, "G", nullptr, "A", nullptr, "B"};
+
+int frequencyToMidi(double frequency) {
+    if (frequency <= 0)
+        return REST_MIDI;
+    return static_cast<int>(std::round(12 * std::log2(frequency / 440.0))) + 69;
+}
+
+std::string midiToNoteString(int midi) {
+    if (midi == REST_MIDI)
+        return "Rest";
+    const char* noteNames[] = {"C", "C#", "D", "D#", "E", "F",
+                               "F#", "G", "G#", "A", "A#", "B"};
+    std::string note = noteNames[midi % 12];
+    int octave = midi / 12 - 1;
+    return note + std::to_string(octave);
+}
+
+int spellingAlter(int midi, int keySignature) {
+    if (NATURAL_STEPS[midi % 12] != nullptr)
+        return 0;
+    return keySignature < 0 ? -1 : 1;
+}
+
+const char* spelledStep(int midi, int alter) {
+    const char* step = NATURAL_STEPS[((midi - alter) % 12 + 12) % 12];
+    if (step == nullptr)
+        throw std::invalid_argument("Alteration does not spell the note from a natural");
+    return step;
+}
+
+int spelledOctave(int midi, int alter) {
+    int natural = midi - alter;
+    return (natural >= 0 ? natural / 12 : (natural - 11) / 12) - 1;
+}
@@ -0,0 +1,483 @@
+#define _USE_MATH_DEFINES
+#include "polyphonicDetector.h"
+#include "note_duration_extractor.h"
+#include "fftPlanCache.h"
+#include "windowRegistry.h"
+#include "simd.h"
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <memory>
+
+#define POLY_FRAMES_PER_TASK 16
+
+static size_t roundUpToFour(size_t n) {
+    return (n + 3) & ~static_cast<size_t>(3);
+}
+
+static double sinc(double x) {
+    return x == 0.0 ? 1.0 : std::sin(M_PI * x) / (M_PI * x);
+}
+
+// Magnitude of the Hamming window's spectrum `offset` bins from a partial,
+// relative to N: the main lobe spans two bins either side.
+static double hammingLobe(double offset) {
+    return std::abs(0.54 * sinc(offset) + 0.23 * (sinc(offset - 1.0) + sinc(offset + 1.0)));
+}
+
+//
+// Template kernels
+// ----------------
+// Rows and the residual are aligned and every range is a multiple of four
+// bins, so the SSE paths use aligned loads with no scalar tail.
+//
+static float templateDot(const float* row, const float* residual, size_t first, size_t last) {
+    size_t i = first;
+    float sum = 0.0f;
+#ifdef SCOREGEN_SSE2
+    __m128 acc = _mm_setzero_ps();
+    for (; i + 4 <= last; i += 4) {
+        acc = _mm_add_ps(acc, _mm_mul_ps(_mm_load_ps(row + i), _mm_load_ps(residual + i)));
+    }
+    float lanes[4];
+    _mm_storeu_ps(lanes, acc);
+    sum = (lanes[0] + lanes[1]) + (lanes[2] + lanes[3]);
+#endif
+    for (; i < last; i++) {
+        sum += row[i] * residual[i];
+    }
+    return sum;
+}
+
+// residual = max(0, residual - amplitude * row) over [first, last).
+static void cancelTemplate(const float* row, float amplitude, float* residual, size_t first, size_t last) {
+    size_t i = first;
+#ifdef SCOREGEN_SSE2
+    const __m128 scale = _mm_set1_ps(amplitude);
+    const __m128 zero = _mm_setzero_ps();
+    for (; i + 4 <= last; i += 4) {
+        __m128 r = _mm_sub_ps(_mm_load_ps(residual + i), _mm_mul_ps(scale, _mm_load_ps(row + i)));
+        _mm_store_ps(residual + i, _mm_max_ps(r, zero));
+    }
+#endif
+    for (; i < last; i++) {
+        residual[i] = std::max(0.0f, residual[i] - amplitude * row[i]);
+    }
+}
+
+//
+// Class: PianoTemplates
+// ---------------------
+// One row per key; partials above POLY_MAX_FREQUENCY are left out, so low
+// keys carry up to POLY_MAX_PARTIALS partials and the top octave only its
+// fundamental.
+//
+PianoTemplates::PianoTemplates(int sampleRate, int frameSize)
+    : range_(2 * PIANO_KEYS) {
+    const double binsPerHz = static_cast<double>(frameSize) / sampleRate;
+    numBins_ = std::min<size_t>(frameSize / 2 + 1, static_cast<size_t>(POLY_MAX_FREQUENCY * binsPerHz) + 3);
+    stride_ = roundUpToFour(numBins_);
+    values_.resize(PIANO_KEYS * stride_);
+
+    for (int key = 0; key < PIANO_KEYS; key++) {
+        float* row = values_.data() + key * stride_;
+        double f0 = 440.0 * std::pow(2.0, (PIANO_LOWEST_MIDI + key - 69) / 12.0);
+        for (int h = 1; h <= POLY_MAX_PARTIALS; h++) {
+            double frequency = h * f0 * std::sqrt(1.0 + PIANO_INHARMONICITY * h * h);
+            if (frequency > POLY_MAX_FREQUENCY) {
+                break;
+            }
+            double center = frequency * binsPerHz;
+            int low = std::max(0, static_cast<int>(std::ceil(center - 2.0)));
+            int high = std::min(static_cast<int>(numBins_) - 1, static_cast<int>(std::floor(center + 2.0)));
+            for (int bin = low; bin <= high; bin++) {
+                row[bin] += static_cast<float>(hammingLobe(bin - center) / h);
+            }
+        }
+
+        double norm = 0.0;
+        size_t first = stride_;
+        size_t last = 0;
+        for (size_t bin = 0; bin < numBins_; bin++) {
+            if (row[bin] > 0.0f) {
+                norm += static_cast<double>(row[bin]) * row[bin];
+                first = std::min(first, bin);
+                last = bin + 1;
+            }
+        }
+        norm = std::sqrt(norm);
+        for (size_t bin = first; bin < last; bin++) {
+            row[bin] = static_cast<float>(row[bin] / norm);
+        }
+        range_[2 * key] = first & ~static_cast<size_t>(3);
+        range_[2 * key + 1] = roundUpToFour(last);
+    }
+}
+
+//
+// Class: PolyphonicDetector
+// -------------------------
+// Since the templates have unit norm, a key's match against the residual is
+// also the least-squares amplitude of its template. A key is kept while that
+// amplitude is a large enough share of both the remaining spectrum (minMatch,
+// the cosine between the two) and the strongest key of the frame
+// (relativeThreshold). Subtraction is clipped at zero so partials shared by
+// several keys are not cancelled twice.
+//
+PolyphonicDetector::PolyphonicDetector(int sampleRate, int frameSize, const PolyphonicOptions& options)
+    : templates_(sampleRate, frameSize), options_(options), frameSize_(frameSize),
+      residual_(roundUpToFour(templates_.numBins())), scores_(PIANO_KEYS) {}
+
+KeySet PolyphonicDetector::detect(const float* magnitudes) {
+    KeySet keys;
+
+    // Parseval: the windowed frame's RMS from its half spectrum.
+    double energy = 0.0;
+    for (int bin = 0; bin <= frameSize_ / 2; bin++) {
+        energy += static_cast<double>(magnitudes[bin]) * magnitudes[bin];
+    }
+    if (std::sqrt(2.0 * energy) / frameSize_ < options_.gateRMS) {
+        return keys;
+    }
+
+    const size_t numBins = templates_.numBins();
+    float* residual = residual_.data();
+    std::copy(magnitudes, magnitudes + numBins, residual);
+    double residualEnergy = 0.0;
+    for (size_t bin = 0; bin < numBins; bin++) {
+        residualEnergy += static_cast<double>(residual[bin]) * residual[bin];
+    }
+
+    float strongest = 0.0f;
+    for (int n = 0; n < options_.maxPolyphony; n++) {
+        for (int key = 0; key < PIANO_KEYS; key++) {
+            scores_[key] = keys[key] ? 0.0f
+                : templateDot(templates_.row(key), residual, templates_.firstBin(key), templates_.lastBin(key));
+        }
+        int best = static_cast<int>(std::max_element(scores_.begin(), scores_.end()) - scores_.begin());
+        float amplitude = scores_[best];
+        if (amplitude <= 0.0f || amplitude < options_.minMatch * std::sqrt(residualEnergy)) {
+            break;
+        }
+        if (n == 0) {
+            strongest = amplitude;
+        } else if (amplitude < options_.relativeThreshold * strongest) {
+            break;
+        }
+        keys.set(best);
+
+        size_t first = templates_.firstBin(best);
+        size_t last = templates_.lastBin(best);
+        for (size_t bin = first; bin < last; bin++) {
+            residualEnergy -= static_cast<double>(residual[bin]) * residual[bin];
+        }
+        cancelTemplate(templates_.row(best), amplitude, residual, first, last);
+        for (size_t bin = first; bin < last; bin++) {
+            residualEnergy += static_cast<double>(residual[bin]) * residual[bin];
+        }
+        residualEnergy = std::max(0.0, residualEnergy);
+    }
+    return keys;
+}
+
+static size_t countFrames(size_t numSamples, size_t frameSize, size_t hopSize) {
+    return numSamples < frameSize ? 0 : (numSamples - frameSize) / hopSize + 1;
+}
+
+//
+// Class: ChordWorker
+// ------------------
+// FFT buffers and detector for one thread: Hamming-windows a frame,
+// transforms it with the cached r2c plan and matches its magnitudes.
+//
+struct ChordWorker {
+    ChordWorker(int sampleRate, int frameSize, const PolyphonicOptions& options)
+        : detector(sampleRate, frameSize, options),
+          frameSize(frameSize),
+          plan(FFTPlanCache::instance().forward(frameSize)),
+          window(WindowRegistry::instance().get<double>(WindowType::Hamming, frameSize)),
+          in(fftw_alloc_real(frameSize)),
+          out(fftw_alloc_complex(frameSize / 2 + 1)),
+          magnitudes(frameSize / 2 + 1) {}
+    ~ChordWorker() {
+        fftw_free(in);
+        fftw_free(out);
+    }
+
+    ChordWorker(const ChordWorker&) = delete;
+    ChordWorker& operator=(const ChordWorker&) = delete;
+
+    KeySet detectFrame(const Sample* frame) {
+        for (int i = 0; i < frameSize; i++) {
+            in[i] = frame[i] * window[i];
+        }
+        fftw_execute_dft_r2c(plan, in, out);
+        for (int bin = 0; bin <= frameSize / 2; bin++) {
+            magnitudes[bin] = static_cast<float>(std::sqrt(out[bin][0] * out[bin][0] + out[bin][1] * out[bin][1]));
+        }
+        return detector.detect(magnitudes.data());
+    }
+
+    PolyphonicDetector detector;
+    int frameSize;
+    fftw_plan plan;
+    Span<const double> window;
+    double* in;
+    fftw_complex* out;
+    AlignedBuffer<float> magnitudes;
+};
+
+//
+// Class: StreamingChordAnalyzer
+// -----------------------------
+// The spectrum consumer of the chord pass. Onsets come from the same onset
+// stream as the monophonic path, registered ahead of it on the driver.
+//
+StreamingChordAnalyzer::StreamingChordAnalyzer(int sampleRate, const PolyphonicOptions& options)
+    : onsets_(sampleRate, analysis_.onsetTimes),
+      worker_(new ChordWorker(sampleRate, POLY_FRAME_SIZE, options)) {
+    analysis_.sampleRate = sampleRate;
+}
+
+StreamingChordAnalyzer::~StreamingChordAnalyzer() {}
+
+void StreamingChordAnalyzer::attach(FrameDriver& driver) {
+    onsets_.attach(driver);
+    driver.add(*this);
+}
+
+void StreamingChordAnalyzer::push(const Sample* block, size_t size) {
+    if (!driver_) {
+        driver_.reset(new FrameDriver());
+        attach(*driver_);
+    }
+    driver_->push(block, size);
+}
+
+const PolyphonicAnalysis& StreamingChordAnalyzer::analysis() const {
+    return analysis_;
+}
+
+size_t StreamingChordAnalyzer::frameSize() const {
+    return analysis_.frameSize;
+}
+
+size_t StreamingChordAnalyzer::hopSize() const {
+    return analysis_.hopSize;
+}
+
+void StreamingChordAnalyzer::consume(const Sample* frame, size_t start) {
+    analysis_.frameKeys.push_back(worker_->detectFrame(frame));
+    onsets_.discardBefore(start + analysis_.hopSize);
+}
+
+//
+// Function: analyzePolyphonicFrames
+// ---------------------------------
+// Onsets are found in one driver pass alongside the caller's consumers. Chord
+// frames are independent, so they are then spread across the pool with one
+// ChordWorker per worker; results land at their frame index.
+//
+PolyphonicAnalysis analyzePolyphonicFrames(const Sample* samples, size_t numSamples, int sampleRate,
+                                           FrameDriver& driver, ThreadPool& pool,
+                                           const PolyphonicOptions& options) {
+    PolyphonicAnalysis analysis;
+    analysis.sampleRate = sampleRate;
+    const int frameSize = analysis.frameSize;
+    const int hopSize = analysis.hopSize;
+
+    OnsetStream onsets(sampleRate, analysis.onsetTimes);
+    onsets.attach(driver);
+    driver.push(samples, numSamples);
+    driver.finish();
+
+    std::vector<std::unique_ptr<ChordWorker>> workers(pool.size());
+    const size_t numFrames = countFrames(numSamples, frameSize, hopSize);
+    analysis.frameKeys.resize(numFrames);
+    pool.parallelFor(numFrames, POLY_FRAMES_PER_TASK, [&](size_t first, size_t last, size_t worker) {
+        if (!workers[worker]) {
+            workers[worker].reset(new ChordWorker(sampleRate, frameSize, options));
+        }
+        for (size_t f = first; f < last; f++) {
+            analysis.frameKeys[f] = workers[worker]->detectFrame(samples + f * hopSize);
+        }
+    });
+    return analysis;
+}
+
+PolyphonicAnalysis analyzePolyphonicFrames(const Sample* samples, size_t numSamples, int sampleRate,
+                                           ThreadPool& pool, const PolyphonicOptions& options) {
+    FrameDriver driver;
+    return analyzePolyphonicFrames(samples, numSamples, sampleRate, driver, pool, options);
+}
+
+PolyphonicAnalysis analyzePolyphonicFrames(const Sample* samples, size_t numSamples, int sampleRate,
+                                           const PolyphonicOptions& options) {
+    return analyzePolyphonicFrames(samples, numSamples, sampleRate, ThreadPool::shared(), options);
+}
+
+// Internal structure to hold a run of frames with the same keys.
+struct ChordSegment {
+    KeySet keys;
+    int startFrame; // First frame index of the chord.
+    int endFrame;   // Last frame index of the chord.
+};
+
+// Keys a tone at `key` excites besides its own: the octave, twelfth and
+// double octave above.
+static KeySet overtoneKeys(const KeySet& keys) {
+    return (keys << 12) | (keys << 19) | (keys << 24);
+}
+
+//
+// Function: segmentChords
+// -----------------------
+// Smooths each key over three frames and groups frames with the same key set
+// into runs. A run joins the segment before it when it is shorter than a
+// sixteenth note, or when, with no onset at its start, it only drops keys
+// (the chord decaying) or only adds overtones of keys already sounding (upper
+// partials outlasting the fundamental's match). Each segment keeps the keys
+// of its opening run that stay active for at least half of its frames.
+// Onsets inside a segment split it, so repeated chords stay separate.
+// Segment boundaries sit midway between frame centres, so segments tile the
+// signal without overlapping.
+//
+std::vector<Note> segmentChords(const PolyphonicAnalysis& analysis, int bpm) {
+    return segmentChords(analysis, TempoMap::constant(bpm));
+}
+
+std::vector<Note> segmentChords(const PolyphonicAnalysis& analysis, const TempoMap& tempo) {
+    std::vector<Note> notes;
+    const int sampleRate = analysis.sampleRate;
+    const int hopSize = analysis.hopSize;
+    const double frameOffset = (analysis.frameSize - hopSize) / 2.0;
+    const int numFrames = static_cast<int>(analysis.frameKeys.size());
+
+    // Pitch-frame index of each onset.
+    std::vector<double> onsetFrames;
+    for (double T : analysis.onsetTimes) {
+        onsetFrames.push_back((T * sampleRate - frameOffset) / hopSize);
+    }
+    auto onsetNear = [&](int frame) {
+        for (double onset : onsetFrames) {
+            if (std::abs(onset - frame) <= 1.0)
+                return true;
+        }
+        return false;
+    };
+    auto boundaryTime = [&](int frame) {
+        return frame == 0 ? 0.0 : (frame * hopSize + frameOffset) / sampleRate;
+    };
+    // Frames in a sixteenth note at the tempo where a segment starts.
+    auto minFrames = [&](int frame) {
+        double minNoteDuration = 60.0 / (tempo.bpmAt(boundaryTime(frame)) * 4); // seconds
+        return std::max(1, static_cast<int>(std::ceil(minNoteDuration * sampleRate / hopSize)));
+    };
+
+    // Majority vote of each key over the frame and its neighbours.
+    std::vector<KeySet> keys(numFrames);
+    for (int f = 0; f < numFrames; f++) {
+        const KeySet& a = analysis.frameKeys[std::max(0, f - 1)];
+        const KeySet& b = analysis.frameKeys[f];
+        const KeySet& c = analysis.frameKeys[std::min(numFrames - 1, f + 1)];
+        keys[f] = (a & b) | (a & c) | (b & c);
+    }
+
+    // Runs of identical key sets, absorbed into the segment before them where
+    // they do not start anything new.
+    // The opening segment takes its keys from its first full-length run.
+    std::vector<ChordSegment> segments;
+    bool settled = false;
+    for (int f = 0; f < numFrames; ) {
+        ChordSegment run = {keys[f], f, f};
+        while (run.endFrame + 1 < numFrames && keys[run.endFrame + 1] == run.keys)
+            run.endFrame++;
+        f = run.endFrame + 1;
+        bool tooShort = run.endFrame - run.startFrame + 1 < minFrames(run.startFrame);
+
+        if (segments.empty()) {
+            segments.push_back(run);
+            settled = !tooShort;
+            continue;
+        }
+        ChordSegment& prev = segments.back();
+        if (!settled) {
+            if (!tooShort)
+                prev.keys = run.keys;
+            prev.endFrame = run.endFrame;
+            settled = !tooShort;
+            continue;
+        }
+        bool attack = onsetNear(run.startFrame);
+        bool decay = run.keys.any() && (run.keys & ~prev.keys).none();
+        KeySet added = run.keys & ~prev.keys;
+        bool overtones = added.any() && (added & ~overtoneKeys(prev.keys)).none();
+        if (tooShort || (!attack && (decay || overtones))) {
+            prev.endFrame = run.endFrame;
+            continue;
+        }
+        segments.push_back(run);
+    }
+    // Keys of the opening run held for at least half of each segment;
+    // neighbours that end up with the same keys and no onset between them
+    // are one segment.
+    std::vector<ChordSegment> voted;
+    for (ChordSegment seg : segments) {
+        const int length = seg.endFrame - seg.startFrame + 1;
+        for (int key = 0; key < PIANO_KEYS; key++) {
+            if (seg.keys[key]) {
+                int count = 0;
+                for (int f = seg.startFrame; f <= seg.endFrame; f++)
+                    count += keys[f][key];
+                seg.keys[key] = 2 * count >= length;
+            }
+        }
+        if (!voted.empty() && voted.back().keys == seg.keys && !onsetNear(seg.startFrame))
+            voted.back().endFrame = seg.endFrame;
+        else
+            voted.push_back(seg);
+    }
+
+    // Split sounding segments at onsets.
+    std::vector<ChordSegment> finalSegments;
+    for (const ChordSegment& seg : voted) {
+        int currentStart = seg.startFrame;
+        if (seg.keys.any()) {
+            for (double onset : onsetFrames) {
+                int frame = static_cast<int>(std::round(onset));
+                if (frame - currentStart >= minFrames(currentStart) && seg.endFrame - frame + 1 >= minFrames(frame)) {
+                    finalSegments.push_back({seg.keys, currentStart, frame - 1});
+                    currentStart = frame;
+                }
+            }
+        }
+        finalSegments.push_back({seg.keys, currentStart, seg.endFrame});
+    }
+
+    // Convert segments to Note objects, lowest key first.
+    for (const ChordSegment& seg : finalSegments) {
+        double startTime = boundaryTime(seg.startFrame);
+        double endTime = boundaryTime(seg.endFrame + 1);
+        std::string noteType = determineNoteType(startTime, endTime, tempo);
+        std::string names;
+        if (seg.keys.none()) {
+            notes.push_back({static_cast<float>(startTime), static_cast<float>(endTime), REST_MIDI, noteType});
+            names = "Rest";
+        }
+        for (int key = 0; key < PIANO_KEYS; key++) {
+            if (seg.keys[key]) {
+                int midi = PIANO_LOWEST_MIDI + key;
+                notes.push_back({static_cast<float>(startTime), static_cast<float>(endTime), midi, noteType, !names.empty()});
+                names += (names.empty() ? "" : " ") + midiToNoteString(midi);
+            }
+        }
+        std::cout << "Chord: " << names << " | Start Time: " << startTime
+                  << " s | End Time: " << endTime << " s | Type: " << noteType << "\n";
+    }
+    return notes;
+}
+
+std::vector<Note> extract_chord_durations(const Sample* samples, size_t numSamples, int sampleRate, int bpm,
+                                          const PolyphonicOptions& options) {
+    return segmentChords(analyzePolyphonicFrames(samples, numSamples, sampleRate, options), bpm);
+}
@@ -1,143 +1,292 @@
 #include "readWav.h"
+#include "mappedFile.h"
+#include "simd.h"
+#include <cstring>
+#include <cstdint>
+#include <algorithm>
 
-// Helper function to read little-endian values.
-template <typename T>
-T readLE(std::ifstream &in) {
-    T value;
-    in.read(reinterpret_cast<char*>(&value), sizeof(T));
-    return value;
+#define WAVE_FORMAT_PCM 1
+#define WAVE_FORMAT_IEEE_FLOAT 3
+#define WAVE_FORMAT_EXTENSIBLE 0xFFFE
+
+namespace {
+
+// Little-endian field readers for the mapped header bytes.
+uint16_t readU16(const uint8_t* p) {
+    return static_cast<uint16_t>(p[0] | (p[1] << 8));
+}
+
+uint32_t readU32(const uint8_t* p) {
+    return static_cast<uint32_t>(p[0]) | (static_cast<uint32_t>(p[1]) << 8) |
+           (static_cast<uint32_t>(p[2]) << 16) | (static_cast<uint32_t>(p[3]) << 24);
+}
+
+// Signed 24-bit sample from three little-endian bytes.
+int32_t readS24(const uint8_t* p) {
+    uint32_t value = static_cast<uint32_t>(p[0]) << 8 | static_cast<uint32_t>(p[1]) << 16 |
+                     static_cast<uint32_t>(p[2]) << 24;
+    return static_cast<int32_t>(value) >> 8;
+}
+
+#ifdef SCOREGEN_SSE2
+// Converts four int32 lanes to floats, scales them and stores them to out.
+inline void storeScaledInt32(__m128i v, __m128 scale, float* out) {
+    _mm_storeu_ps(out, _mm_mul_ps(_mm_cvtepi32_ps(v), scale));
+}
+
+// Adds the left/right halves of four interleaved stereo frames:
+// [L0 R0 L1 R1], [L2 R2 L3 R3] -> [L0+R0, L1+R1, L2+R2, L3+R3].
+inline __m128 sumStereoPairs(__m128 a, __m128 b) {
+    return _mm_add_ps(_mm_shuffle_ps(a, b, _MM_SHUFFLE(2, 0, 2, 0)),
+                      _mm_shuffle_ps(a, b, _MM_SHUFFLE(3, 1, 3, 1)));
+}
+#endif
+
+//
+// Conversion kernels
+// ------------------
+// Each kernel converts `frames` interleaved frames of one sample format into
+// mono floats in [-1, 1], mixing the channels down in the same pass. The
+// format is fixed per kernel so the inner loops carry no format branches;
+// mono and stereo, the common cases, get SSE2 paths four frames wide.
+//
+void convertPCM16(const uint8_t* src, size_t frames, int channels, Sample* out) {
+    const float scale = static_cast<float>(1.0 / (32768.0 * channels));
+    size_t i = 0;
+#ifdef SCOREGEN_SSE2
+    const __m128 vscale = _mm_set1_ps(scale);
+    if (channels == 1) {
+        for (; i + 8 <= frames; i += 8) {
+            __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i * 2));
+            storeScaledInt32(_mm_srai_epi32(_mm_unpacklo_epi16(v, v), 16), vscale, out + i);
+            storeScaledInt32(_mm_srai_epi32(_mm_unpackhi_epi16(v, v), 16), vscale, out + i + 4);
+        }
+    } else if (channels == 2) {
+        // madd against ones sums each L/R pair exactly in 32 bits.
+        const __m128i ones = _mm_set1_epi16(1);
+        for (; i + 4 <= frames; i += 4) {
+            __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i * 4));
+            storeScaledInt32(_mm_madd_epi16(v, ones), vscale, out + i);
+        }
+    }
+#endif
+    for (; i < frames; i++) {
+        const uint8_t* frame = src + i * 2 * channels;
+        int32_t sum = 0;
+        for (int ch = 0; ch < channels; ch++) {
+            int16_t sample;
+            std::memcpy(&sample, frame + ch * 2, sizeof(sample));
+            sum += sample;
+        }
+        out[i] = sum * scale;
+    }
+}
+
+void convertPCM24(const uint8_t* src, size_t frames, int channels, Sample* out) {
+    const float scale = static_cast<float>(1.0 / (8388608.0 * channels));
+    const size_t samples = frames * channels;
+    size_t i = 0;
+#ifdef SCOREGEN_SSE2
+    if (channels <= 2 && samples >= 4) {
+        // Gather four samples as 32-bit words (the top byte belongs to the next
+        // sample) and sign-extend them with a shift pair. The last sample is
+        // left to the scalar tail so no word read runs past the data chunk.
+        const __m128 vscale = _mm_set1_ps(scale);
+        const size_t step = 4 / channels;
+        for (; (i + step) * channels + 1 <= samples; i += step) {
+            const uint8_t* p = src + i * 3 * channels;
+            uint32_t w[4];
+            std::memcpy(&w[0], p, 4);
+            std::memcpy(&w[1], p + 3, 4);
+            std::memcpy(&w[2], p + 6, 4);
+            std::memcpy(&w[3], p + 9, 4);
+            __m128i v = _mm_set_epi32(w[3], w[2], w[1], w[0]);
+            v = _mm_srai_epi32(_mm_slli_epi32(v, 8), 8);
+            if (channels == 1) {
+                storeScaledInt32(v, vscale, out + i);
+            } else {
+                // 24-bit pairs sum exactly in 32 bits: lanes 0 and 2 hold L+R.
+                __m128i sum = _mm_add_epi32(v, _mm_srli_epi64(v, 32));
+                sum = _mm_shuffle_epi32(sum, _MM_SHUFFLE(3, 1, 2, 0));
+                _mm_storel_pi(reinterpret_cast<__m64*>(out + i),
+                              _mm_mul_ps(_mm_cvtepi32_ps(sum), vscale));
+            }
+        }
+    }
+#endif
+    for (; i < frames; i++) {
+        const uint8_t* frame = src + i * 3 * channels;
+        int64_t sum = 0;
+        for (int ch = 0; ch < channels; ch++) {
+            sum += readS24(frame + ch * 3);
+        }
+        out[i] = static_cast<float>(sum * static_cast<double>(scale));
+    }
+}
+
+void convertPCM32(const uint8_t* src, size_t frames, int channels, Sample* out) {
+    const float scale = static_cast<float>(1.0 / (2147483648.0 * channels));
+    size_t i = 0;
+#ifdef SCOREGEN_SSE2
+    const __m128 vscale = _mm_set1_ps(scale);
+    if (channels == 1) {
+        for (; i + 4 <= frames; i += 4) {
+            __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i * 4));
+            storeScaledInt32(v, vscale, out + i);
+        }
+    } else if (channels == 2) {
+        // Sum after conversion; two full-scale int32 samples overflow 32 bits.
+        for (; i + 4 <= frames; i += 4) {
+            __m128 a = _mm_cvtepi32_ps(_mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i * 8)));
+            __m128 b = _mm_cvtepi32_ps(_mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i * 8 + 16)));
+            _mm_storeu_ps(out + i, _mm_mul_ps(sumStereoPairs(a, b), vscale));
+        }
+    }
+#endif
+    for (; i < frames; i++) {
+        const uint8_t* frame = src + i * 4 * channels;
+        double sum = 0.0;
+        for (int ch = 0; ch < channels; ch++) {
+            int32_t sample;
+            std::memcpy(&sample, frame + ch * 4, sizeof(sample));
+            sum += sample;
+        }
+        out[i] = static_cast<float>(sum * scale);
+    }
 }
 
+void convertFloat32(const uint8_t* src, size_t frames, int channels, Sample* out) {
+    const float scale = 1.0f / channels;
+    size_t i = 0;
+    if (channels == 1) {
+        // Already in the output format.
+        std::memcpy(out, src, frames * sizeof(float));
+        return;
+    }
+#ifdef SCOREGEN_SSE2
+    if (channels == 2) {
+        const __m128 half = _mm_set1_ps(0.5f);
+        for (; i + 4 <= frames; i += 4) {
+            __m128 a = _mm_loadu_ps(reinterpret_cast<const float*>(src + i * 8));
+            __m128 b = _mm_loadu_ps(reinterpret_cast<const float*>(src + i * 8 + 16));
+            _mm_storeu_ps(out + i, _mm_mul_ps(sumStereoPairs(a, b), half));
+        }
+    }
+#endif
+    for (; i < frames; i++) {
+        const uint8_t* frame = src + i * 4 * channels;
+        float sum = 0.0f;
+        for (int ch = 0; ch < channels; ch++) {
+            float sample;
+            std::memcpy(&sample, frame + ch * 4, sizeof(sample));
+            sum += sample;
+        }
+        out[i] = sum * scale;
+    }
+}
+
+typedef void (*ConvertKernel)(const uint8_t*, size_t, int, Sample*);
+
+ConvertKernel selectKernel(uint16_t audioFormat, uint16_t bitsPerSample) {
+    if (audioFormat == WAVE_FORMAT_PCM) {
+        switch (bitsPerSample) {
+            case 16: return convertPCM16;
+            case 24: return convertPCM24;
+            case 32: return convertPCM32;
+            default: return nullptr;
+        }
+    }
+    if (audioFormat == WAVE_FORMAT_IEEE_FLOAT && bitsPerSample == 32) {
+        return convertFloat32;
+    }
+    return nullptr;
+}
+
+} // namespace
+
 //
 // Function: readWav
 // -----------------
 // Reads a WAV file (16-, 24-, 32-bit PCM or 32-bit float)
 // and mixes down multi-channel data into a mono signal with normalized
-// samples in the range [-1, 1].
+// float samples in the range [-1, 1].
+// The file is memory-mapped, its RIFF chunks are walked once, and the data
+// chunk is converted in a single pass by a format-specific kernel.
 //
-bool readWav(const std::string& filename, std::vector<double>& samples, int& sampleRate) {
-    std::ifstream in(filename, std::ios::binary);
-    if (!in) {
+bool readWav(const std::string& filename, std::vector<Sample>& samples, int& sampleRate) {
+    MappedFile file;
+    if (!file.open(filename)) {
         std::cerr << "Error: cannot open input file " << filename << "\n";
         return false;
     }
+    const uint8_t* bytes = file.data();
+    const size_t fileSize = file.size();
 
-    // Read the RIFF header (first 12 bytes)
-    char riff[4];
-    in.read(riff, 4);
-    if (std::strncmp(riff, "RIFF", 4) != 0) {
+    if (fileSize < 12 || std::memcmp(bytes, "RIFF", 4) != 0) {
         std::cerr << "Error: not a valid RIFF file.\n";
         return false;
     }
-    uint32_t chunkSize = readLE<uint32_t>(in);
-    char wave[4];
-    in.read(wave, 4);
-    if (std::strncmp(wave, "WAVE", 4) != 0) {
+    if (std::memcmp(bytes + 8, "WAVE", 4) != 0) {
         std::cerr << "Error: not a valid WAVE file.\n";
         return false;
     }
 
-    // Read chunks until we find "fmt " chunk.
-    char chunkID[4];
-    uint32_t subchunkSize = 0;
+    // Walk the chunk list once, picking up "fmt " and "data".
     uint16_t audioFormat = 0;
     uint16_t numChannels = 0;
     uint32_t sRate = 0;
-    uint32_t byteRate = 0;
-    uint16_t blockAlign = 0;
     uint16_t bitsPerSample = 0;
     bool fmtFound = false;
-    while (!fmtFound && in.read(chunkID, 4)) {
-        subchunkSize = readLE<uint32_t>(in);
-        if (std::strncmp(chunkID, "fmt ", 4) == 0) {
+    const uint8_t* data = nullptr;
+    size_t dataSize = 0;
+    size_t pos = 12;
+    while (pos + 8 <= fileSize && !(fmtFound && data)) {
+        const uint8_t* chunk = bytes + pos;
+        uint32_t chunkSize = readU32(chunk + 4);
+        size_t body = pos + 8;
+        size_t available = fileSize - body;
+
+        if (std::memcmp(chunk, "fmt ", 4) == 0 && chunkSize >= 16 && available >= 16) {
             fmtFound = true;
-            audioFormat = readLE<uint16_t>(in);
-            numChannels = readLE<uint16_t>(in);
-            sRate = readLE<uint32_t>(in);
-            byteRate = readLE<uint32_t>(in);
-            blockAlign = readLE<uint16_t>(in);
-            bitsPerSample = readLE<uint16_t>(in);
-            if (subchunkSize > 16) {
-                in.ignore(subchunkSize - 16);
+            audioFormat = readU16(bytes + body);
+            numChannels = readU16(bytes + body + 2);
+            sRate = readU32(bytes + body + 4);
+            bitsPerSample = readU16(bytes + body + 14);
+            // WAVE_FORMAT_EXTENSIBLE keeps the real format in the sub-format GUID.
+            if (audioFormat == WAVE_FORMAT_EXTENSIBLE && chunkSize >= 40 && available >= 40) {
+                audioFormat = readU16(bytes + body + 24);
             }
-        } else {
-            in.ignore(subchunkSize);
+        } else if (std::memcmp(chunk, "data", 4) == 0) {
+            data = bytes + body;
+            dataSize = std::min<size_t>(chunkSize, available);
         }
+        // Chunks are padded to an even length.
+        pos = body + chunkSize + (chunkSize & 1);
     }
     if (!fmtFound) {
         std::cerr << "Error: fmt chunk not found.\n";
         return false;
     }
+    if (!data) {
+        std::cerr << "Error: data chunk not found.\n";
+        return false;
+    }
     sampleRate = sRate;
 
-    // Search for the "data" chunk.
-    bool dataFound = false;
-    uint32_t dataSize = 0;
-    while (!dataFound && in.read(chunkID, 4)) {
-        dataSize = readLE<uint32_t>(in);
-        if (std::strncmp(chunkID, "data", 4) == 0) {
-            dataFound = true;
-            break;
-        } else {
-            in.ignore(dataSize);
-        }
-    }
-    if (!dataFound) {
-        std::cerr << "Error: data chunk not found.\n";
+    ConvertKernel kernel = selectKernel(audioFormat, bitsPerSample);
+    if (!kernel || numChannels == 0) {
+        std::cerr << "Unsupported audio format: " << audioFormat
+                  << " (" << bitsPerSample << " bit, " << numChannels << " channels)\n";
         return false;
     }
-    
+
+    // Files too long to hold in memory can be analysed block by block
+    // instead; see AudioStream and StreamingFrameAnalyzer.
     int bytesPerSample = bitsPerSample / 8;
     size_t totalFrames = dataSize / (numChannels * bytesPerSample);
     
-    if (totalFrames > 100000000) {
-        std::cerr << "Error: WAV file is too large to process as a single block." << std::endl;
-        return false;
-    }
-    
     samples.resize(totalFrames);
-    
-    // Read samples and mix down to mono.
-    for (size_t i = 0; i < totalFrames; i++) {
-        double mixedSample = 0.0;
-        for (int ch = 0; ch < numChannels; ch++) {
-            double sampleValue = 0.0;
-            if (audioFormat == 1) { // PCM integer
-                if (bitsPerSample == 16) {
-                    int16_t sampleInt;
-                    in.read(reinterpret_cast<char*>(&sampleInt), sizeof(sampleInt));
-                    sampleValue = sampleInt / 32768.0;
-                } else if (bitsPerSample == 24) {
-                    unsigned char bytes[3];
-                    in.read(reinterpret_cast<char*>(bytes), 3);
-                    int32_t sampleInt = bytes[0] | (bytes[1] << 8) | (bytes[2] << 16);
-                    if (sampleInt & 0x800000) sampleInt |= 0xFF000000;
-                    sampleValue = sampleInt / 8388608.0;
-                } else if (bitsPerSample == 32) {
-                    int32_t sampleInt;
-                    in.read(reinterpret_cast<char*>(&sampleInt), sizeof(sampleInt));
-                    sampleValue = sampleInt / 2147483648.0;
-                } else {
-                    std::cerr << "Unsupported PCM bit depth: " << bitsPerSample << "\n";
-                    return false;
-                }
-            } else if (audioFormat == 3) { // IEEE float
-                if (bitsPerSample == 32) {
-                    float sampleFloat;
-                    in.read(reinterpret_cast<char*>(&sampleFloat), sizeof(sampleFloat));
-                    sampleValue = sampleFloat;
-                } else {
-                    std::cerr << "Unsupported float bit depth: " << bitsPerSample << "\n";
-                    return false;
-                }
-            } else {
-                std::cerr << "Unsupported audio format: " << audioFormat << "\n";
-                return false;
-            }
-            mixedSample += sampleValue;
-        }
-        samples[i] = mixedSample / numChannels;
-    }
+    kernel(data, totalFrames, numChannels, samples.data());
     
     return true;
-}
\ No newline at end of file
+}
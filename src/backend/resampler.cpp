@@ -0,0 +1,147 @@
+#define _USE_MATH_DEFINES
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include "resampler.h"
+
+static size_t greatestCommonDivisor(size_t a, size_t b){
+    while (b != 0){
+        size_t r = a % b;
+        a = b;
+        b = r;
+    }
+    return a;
+}
+
+//
+// Class: Resampler
+// ----------------
+// Output n falls at input time n * M / L = i + p / L, with i = floor(n M / L)
+// and phase p = n M mod L, and is the sum over k < taps of row p's k-th
+// coefficient times x[i + D - k], D = taps / 2. That coefficient is the
+// kernel at t = k + p / L - D, the distance between the output instant and
+// the input sample, so x[i - D + 1, i + D] is all an output reads.
+//
+template <typename T>
+Resampler<T>::Resampler(int inputRate, int outputRate)
+    : inputRate_(inputRate), outputRate_(outputRate), historyBase_(0), received_(0), emitted_(0){
+    if (inputRate <= 0 || outputRate <= 0){
+        throw std::invalid_argument("Resampler rates must be positive");
+    }
+    const size_t divisor = greatestCommonDivisor(inputRate, outputRate);
+    up_ = outputRate / divisor;
+    down_ = inputRate / divisor;
+
+    // Kernel half-width in input samples: the zero crossings at the lower
+    // rate, whose spacing grows with the decimation factor.
+    const size_t halfWidth = RESAMPLER_ZERO_CROSSINGS * ((down_ + up_ - 1) / up_);
+    taps_ = 2 * halfWidth;
+    const double cutoff = 0.5 * RESAMPLER_ROLLOFF * std::min(1.0, static_cast<double>(up_) / down_);
+
+    coefficients_.resize(up_ * taps_);
+    std::vector<double> row(taps_);
+    for (size_t p = 0; p < up_; p++){
+        double sum = 0.0;
+        for (size_t k = 0; k < taps_; k++){
+            double t = k + static_cast<double>(p) / up_ - static_cast<double>(halfWidth);
+            double u = t / halfWidth;
+            double window = std::abs(u) >= 1.0 ? 0.0 : 0.42 + 0.5 * std::cos(M_PI * u) + 0.08 * std::cos(2.0 * M_PI * u);
+            double x = 2.0 * cutoff * t;
+            double sinc = x == 0.0 ? 1.0 : std::sin(M_PI * x) / (M_PI * x);
+            row[k] = 2.0 * cutoff * sinc * window;
+            sum += row[k];
+        }
+        for (size_t k = 0; k < taps_; k++){
+            coefficients_[p * taps_ + k] = static_cast<T>(row[k] / sum);
+        }
+    }
+}
+
+template <typename T>
+Resampler<T>::~Resampler(){}
+
+template <typename T>
+size_t Resampler<T>::totalOutputs(size_t inputSize) const{
+    return (inputSize * up_ + down_ - 1) / down_;
+}
+
+template <typename T>
+size_t Resampler<T>::outputSize(size_t inputSize) const{
+    return totalOutputs(inputSize);
+}
+
+template <typename T>
+T Resampler<T>::outputAt(size_t n, const T* data, size_t base, size_t end) const{
+    const size_t position = n * down_;
+    const size_t i = position / up_;
+    const T* row = coefficients_.data() + (position % up_) * taps_;
+    const size_t halfWidth = taps_ / 2;
+
+    double acc = 0.0;
+    if (i + 1 >= base + halfWidth && i + halfWidth < end){
+        // Whole span inside the held input.
+        const T* x = data + (i + halfWidth - base);
+        for (size_t k = 0; k < taps_; k++){
+            acc += static_cast<double>(row[k]) * x[-static_cast<ptrdiff_t>(k)];
+        }
+    } else {
+        for (size_t k = 0; k < taps_; k++){
+            ptrdiff_t m = static_cast<ptrdiff_t>(i + halfWidth) - static_cast<ptrdiff_t>(k);
+            if (m >= static_cast<ptrdiff_t>(base) && m < static_cast<ptrdiff_t>(end)){
+                acc += static_cast<double>(row[k]) * data[m - base];
+            }
+        }
+    }
+    return static_cast<T>(acc);
+}
+
+template <typename T>
+size_t Resampler<T>::process(Span<const T> in, Span<T> out){
+    const size_t total = totalOutputs(in.size());
+    for (size_t n = 0; n < total; n++){
+        out[n] = outputAt(n, in.data(), 0, in.size());
+    }
+    return total;
+}
+
+//
+// Function: push
+// --------------
+// An output is emitted once the last input sample it reads has arrived.
+// Input before the next output's span is dropped, in bulk once it makes up
+// half the history, so the history stays about one kernel span plus a block.
+//
+template <typename T>
+void Resampler<T>::push(const T* block, size_t size, std::vector<T>& out){
+    history_.insert(history_.end(), block, block + size);
+    received_ += size;
+
+    const size_t halfWidth = taps_ / 2;
+    while ((emitted_ * down_) / up_ + halfWidth < received_){
+        out.push_back(outputAt(emitted_, history_.data(), historyBase_, received_));
+        emitted_++;
+    }
+
+    const size_t next = (emitted_ * down_) / up_;
+    const size_t keepFrom = next + 1 > halfWidth ? next + 1 - halfWidth : 0;
+    const size_t drop = keepFrom > historyBase_ ? keepFrom - historyBase_ : 0;
+    if (drop > history_.size() / 2){
+        history_.erase(history_.begin(), history_.begin() + drop);
+        historyBase_ += drop;
+    }
+}
+
+template <typename T>
+void Resampler<T>::finish(std::vector<T>& out){
+    const size_t total = totalOutputs(received_);
+    for (; emitted_ < total; emitted_++){
+        out.push_back(outputAt(emitted_, history_.data(), historyBase_, received_));
+    }
+    history_.clear();
+    historyBase_ = 0;
+    received_ = 0;
+    emitted_ = 0;
+}
+
+template class Resampler<float>;
+template class Resampler<double>;
@@ -0,0 +1,61 @@
+#include "scratchArena.h"
+#include <algorithm>
+
+static size_t roundToAlignment(size_t bytes){
+    const size_t alignment = AlignedBuffer<unsigned char>::ALIGNMENT;
+    return (bytes + alignment - 1) / alignment * alignment;
+}
+
+ScratchArena::ScratchArena(size_t initialBytes)
+    : used_(0), overflowBytes_(0), highWater_(0), heapAllocations_(0){
+    if (initialBytes > 0){
+        block_.resize(roundToAlignment(initialBytes));
+        heapAllocations_++;
+    }
+}
+
+void* ScratchArena::allocateBytes(size_t bytes){
+    bytes = roundToAlignment(std::max<size_t>(bytes, 1));
+    void* p;
+    if (overflow_.empty() && used_ + bytes <= block_.size()){
+        p = block_.data() + used_;
+        used_ += bytes;
+    } else {
+        // Too big for what is left: give the request its own block until the
+        // arena is next idle.
+        overflow_.emplace_back(bytes);
+        heapAllocations_++;
+        p = overflow_.back().data();
+        overflowBytes_ += bytes;
+    }
+    highWater_ = std::max(highWater_, used_ + overflowBytes_);
+    return p;
+}
+
+ScratchArena::Marker ScratchArena::mark() const{
+    Marker marker;
+    marker.used = used_;
+    marker.overflowBlocks = overflow_.size();
+    return marker;
+}
+
+void ScratchArena::release(Marker marker){
+    while (overflow_.size() > marker.overflowBlocks){
+        overflowBytes_ -= overflow_.back().size();
+        overflow_.pop_back();
+    }
+    used_ = marker.used;
+
+    if (used_ == 0 && overflow_.empty() && highWater_ > block_.size()){
+        block_.resize(highWater_);
+        heapAllocations_++;
+    }
+}
+
+size_t ScratchArena::capacity() const{
+    return block_.size();
+}
+
+size_t ScratchArena::heapAllocations() const{
+    return heapAllocations_;
+}
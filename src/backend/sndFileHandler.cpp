@@ -1,6 +1,9 @@
 #include "sndFileHandler.h"
+#include <cstring>
+#include <algorithm>
 
-#define FRAME_SIZE 2048
+#define BLOCK_FRAMES 65536
+#define TAIL_BLOCK_FRAMES 4096
 
 SndFileHandler::SndFileHandler(const std::string& sndInputPath, const std::string& sndOutputPath)
     : sndInputPath_(sndInputPath), sndOutputPath_(sndOutputPath){}
@@ -9,28 +12,50 @@ SndFileHandler::~SndFileHandler(){}
 
 std::tuple<SF_INFO, std::vector<double>> SndFileHandler::readSndFile(){
     SF_INFO sfInfo;
-    int readCount;
-    double buffer[FRAME_SIZE];
+    std::vector<double> data;
+    readSndFile(sfInfo, data);
+    return std::make_tuple(sfInfo, std::move(data));
+}
+
+bool SndFileHandler::readSndFile(SF_INFO& sfInfo, std::vector<double>& data){
+    memset(&sfInfo, 0, sizeof(sfInfo));
+    data.clear();
 
     SNDFILE* inputFile = sf_open(sndInputPath_.c_str(), SFM_READ, &sfInfo);
     if (!inputFile){
         printf("Error: Cannot open input file -- %s\n", sf_strerror(inputFile));
-        return std::make_tuple(sfInfo, std::vector<double>());
+        return false;
     }
 
-    std::vector<double> data;
-    while ((readCount = sf_readf_double(inputFile, buffer, FRAME_SIZE))){
-        for (int i = 0; i < readCount; i++){
-            data.push_back(buffer[i]);
-        }
+    // Size the destination from the header and decode large blocks of
+    // interleaved frames straight into it; every channel is kept.
+    const size_t channels = static_cast<size_t>(sfInfo.channels);
+    size_t capacity = sfInfo.frames > 0 ? static_cast<size_t>(sfInfo.frames) : 0;
+    data.resize(capacity * channels);
+
+    size_t framesRead = 0;
+    sf_count_t readCount;
+    while (framesRead < capacity){
+        size_t request = std::min<size_t>(BLOCK_FRAMES, capacity - framesRead);
+        readCount = sf_readf_double(inputFile, data.data() + framesRead * channels, request);
+        if (readCount <= 0){
+            break;
         }
+        framesRead += static_cast<size_t>(readCount);
+    }
+    data.resize(framesRead * channels);
+
+    // The header can under-report the length (e.g. unseekable input); append the rest.
+    std::vector<double> block(TAIL_BLOCK_FRAMES * channels);
+    while ((readCount = sf_readf_double(inputFile, block.data(), TAIL_BLOCK_FRAMES)) > 0){
+        data.insert(data.end(), block.begin(), block.begin() + readCount * channels);
+    }
 
     sf_close(inputFile);
-    
-    return std::make_tuple(sfInfo, data);
+    return true;
 }
 
-void SndFileHandler::writeSndFile(SF_INFO info, std::vector<double> data){
+void SndFileHandler::writeSndFile(SF_INFO info, const std::vector<double>& data){
 
     SNDFILE* outputFile = sf_open(sndOutputPath_.c_str(), SFM_WRITE, &info);
     if (!outputFile){
@@ -39,4 +64,4 @@ void SndFileHandler::writeSndFile(SF_INFO info, std::vector<double> data){
     }
     sf_write_double(outputFile, data.data(), data.size());
     sf_close(outputFile);
-}
\ No newline at end of file
+}
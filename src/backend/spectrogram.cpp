@@ -0,0 +1,12 @@
+#include "spectrogram.h"
+
+template <typename T>
+BasicSpectrogram<T>::BasicSpectrogram()
+    : numFrames_(0), numBins_(0){}
+
+template <typename T>
+BasicSpectrogram<T>::BasicSpectrogram(size_t numFrames, size_t numBins)
+    : numFrames_(numFrames), numBins_(numBins), values_(numFrames * numBins){}
+
+template class BasicSpectrogram<float>;
+template class BasicSpectrogram<double>;
@@ -0,0 +1,163 @@
+#define _USE_MATH_DEFINES
+#include "tempoMap.h"
+#include "tempogram.h"
+#include <algorithm>
+#include <cmath>
+
+TempoMap TempoMap::constant(double bpm) {
+    TempoMap map;
+    map.times.push_back(0.0);
+    map.bpms.push_back(bpm);
+    return map;
+}
+
+double TempoMap::bpmAt(double seconds) const {
+    if (bpms.empty()) {
+        return 0.0;
+    }
+    if (seconds <= times.front()) {
+        return bpms.front();
+    }
+    if (seconds >= times.back()) {
+        return bpms.back();
+    }
+    size_t next = std::upper_bound(times.begin(), times.end(), seconds) - times.begin();
+    double fraction = (seconds - times[next - 1]) / (times[next] - times[next - 1]);
+    return bpms[next - 1] + fraction * (bpms[next] - bpms[next - 1]);
+}
+
+// The tempo is linear between points, so the trapezoid rule over the points
+// inside the interval is exact.
+double TempoMap::beatsBetween(double start, double end) const {
+    if (end <= start) {
+        return 0.0;
+    }
+    double beats = 0.0;
+    double from = start;
+    size_t next = std::upper_bound(times.begin(), times.end(), start) - times.begin();
+    for (; next < times.size() && times[next] < end; next++) {
+        beats += (times[next] - from) * (bpmAt(from) + bpms[next]) / 120.0;
+        from = times[next];
+    }
+    return beats + (end - from) * (bpmAt(from) + bpmAt(end)) / 120.0;
+}
+
+double TempoMap::averageBPM(double start, double end) const {
+    if (bpms.size() == 1) {
+        return bpms.front();
+    }
+    if (end <= start) {
+        return bpmAt(start);
+    }
+    return beatsBetween(start, end) * 60.0 / (end - start);
+}
+
+double TempoMap::medianBPM() const {
+    if (bpms.empty()) {
+        return 0.0;
+    }
+    std::vector<double> sorted = bpms;
+    std::sort(sorted.begin(), sorted.end());
+    size_t n = sorted.size();
+    return n % 2 == 0 ? (sorted[n / 2 - 1] + sorted[n / 2]) / 2.0 : sorted[n / 2];
+}
+
+//
+// Function: estimateTempoMap
+// --------------------------
+// Windows start every TEMPO_MAP_HOP_SECONDS and are independent, so they
+// run across the pool. A window's tempogram can lock onto half or twice the
+// beat where the rhythm thins out; folding each estimate into the octave
+// around the whole envelope's tempo, then taking a running median, keeps
+// those from showing up as jumps in the curve.
+//
+TempoMap estimateTempoMap(const std::vector<double>& envelope, double framesPerSecond, ThreadPool& pool) {
+    TempoMap map;
+    const double overall = tempogramBPM(envelope, framesPerSecond);
+    const size_t window = static_cast<size_t>(std::round(TEMPO_MAP_WINDOW_SECONDS * framesPerSecond));
+    const size_t hop = static_cast<size_t>(std::round(TEMPO_MAP_HOP_SECONDS * framesPerSecond));
+    if (envelope.size() <= window) {
+        if (overall > 0.0) {
+            map.times.push_back(envelope.size() / (2.0 * framesPerSecond));
+            map.bpms.push_back(overall);
+        }
+        return map;
+    }
+
+    const size_t count = (envelope.size() - window) / hop + 1;
+    std::vector<double> estimates(count);
+    pool.parallelFor(count, 1, [&](size_t begin, size_t end, size_t) {
+        for (size_t i = begin; i < end; i++) {
+            estimates[i] = tempogramBPM(envelope.data() + i * hop, window, framesPerSecond);
+        }
+    });
+
+    if (overall > 0.0) {
+        for (double& bpm : estimates) {
+            while (bpm > 0.0 && bpm > overall * M_SQRT2) {
+                bpm /= 2.0;
+            }
+            while (bpm > 0.0 && bpm < overall / M_SQRT2) {
+                bpm *= 2.0;
+            }
+        }
+    }
+
+    // Windows without an estimate take the one before them, or at the start
+    // the first one after.
+    auto found = std::find_if(estimates.begin(), estimates.end(), [](double bpm) { return bpm > 0.0; });
+    if (found == estimates.end()) {
+        return overall > 0.0 ? TempoMap::constant(overall) : map;
+    }
+    double last = *found;
+    for (double& bpm : estimates) {
+        if (bpm > 0.0) {
+            last = bpm;
+        } else {
+            bpm = last;
+        }
+    }
+
+    const size_t half = TEMPO_MAP_SMOOTHING / 2;
+    std::vector<double> neighbourhood;
+    for (size_t i = 0; i < count; i++) {
+        neighbourhood.assign(estimates.begin() + (i > half ? i - half : 0),
+                             estimates.begin() + std::min(count, i + half + 1));
+        std::nth_element(neighbourhood.begin(), neighbourhood.begin() + neighbourhood.size() / 2, neighbourhood.end());
+        map.times.push_back((i * hop + window / 2.0) / framesPerSecond);
+        map.bpms.push_back(neighbourhood[neighbourhood.size() / 2]);
+    }
+    return map;
+}
+
+TempoMap estimateTempoMap(const std::vector<double>& envelope, double framesPerSecond) {
+    return estimateTempoMap(envelope, framesPerSecond, ThreadPool::shared());
+}
+
+// Flux frames are cut the way a FrameDriver serves a TempogramTracker: whole
+// frames, then the rest zero-padded. Each task runs a tracker of its own from
+// the frame before its first, which only sets the flux baseline, so the
+// envelope matches a single tracker's.
+TempoMap estimateTempoMap(const Sample* samples, size_t size, int sampleRate, ThreadPool& pool) {
+    const size_t whole = size >= TEMPOGRAM_WINDOW ? (size - TEMPOGRAM_WINDOW) / TEMPOGRAM_HOP + 1 : 0;
+    const size_t numFrames = whole + (size > whole * TEMPOGRAM_HOP ? 1 : 0);
+    std::vector<double> envelope(numFrames);
+    pool.parallelFor(numFrames, TEMPO_MAP_FRAMES_PER_TASK, [&](size_t begin, size_t end, size_t) {
+        TempogramTracker tracker(sampleRate);
+        const size_t first = begin > 0 ? begin - 1 : 0;
+        for (size_t frame = first; frame < end; frame++) {
+            const size_t start = frame * TEMPOGRAM_HOP;
+            if (frame < whole) {
+                tracker.consume(samples + start, start);
+            } else {
+                tracker.flush(samples + start, size - start);
+            }
+        }
+        std::copy(tracker.envelope().begin() + (begin - first), tracker.envelope().end(), envelope.begin() + begin);
+    });
+    return estimateTempoMap(envelope, static_cast<double>(sampleRate) / TEMPOGRAM_HOP, pool);
+}
+
+TempoMap estimateTempoMap(const Sample* samples, size_t size, int sampleRate) {
+    return estimateTempoMap(samples, size, sampleRate, ThreadPool::shared());
+}
@@ -0,0 +1,218 @@
+#include "tempogram.h"
+#include "autocorrelation.h"
+#include "fftPlanCache.h"
+#include "windowRegistry.h"
+#include <algorithm>
+#include <cmath>
+
+SpectralFlux::SpectralFlux(size_t numBins) : previous_(numBins, 0.0) {}
+
+template <typename T>
+void SpectralFlux::push(const T* magnitudes) {
+    const bool first = envelope_.empty();
+    double flux = 0.0;
+    for (size_t bin = 0; bin < previous_.size(); bin++) {
+        double level = std::log1p(TEMPOGRAM_COMPRESSION * magnitudes[bin]);
+        if (level > previous_[bin]) {
+            flux += level - previous_[bin];
+        }
+        previous_[bin] = level;
+    }
+    envelope_.push_back(first ? 0.0 : flux);
+}
+
+template <typename S>
+std::vector<double> spectralFlux(const BasicSpectrogram<S>& spectrogram) {
+    SpectralFlux flux(spectrogram.numBins());
+    for (size_t frame = 0; frame < spectrogram.numFrames(); frame++) {
+        flux.push(spectrogram.frame(frame).data());
+    }
+    return flux.envelope();
+}
+
+// Log-normal weight of a tempo: 1 at TEMPOGRAM_PRIOR_BPM, falling by
+// TEMPOGRAM_PRIOR_OCTAVES standard deviations per octave away. Without it
+// the tempogram has as much reason to pick half or twice the beat.
+static double tempoPrior(double bpm) {
+    double octaves = std::log2(bpm / TEMPOGRAM_PRIOR_BPM) / TEMPOGRAM_PRIOR_OCTAVES;
+    return std::exp(-0.5 * octaves * octaves);
+}
+
+// Position of the highest tempogram peak within `reach` lags of lag, to a
+// fraction of a frame by parabolic interpolation; -1 when there is none
+// above zero, i.e. nothing more periodic than the envelope's mean.
+static double refinePeak(const std::vector<double>& tempogram, size_t lag, size_t reach) {
+    const size_t first = lag > reach ? lag - reach : 1;
+    const size_t last = std::min(lag + reach, tempogram.size() - 2);
+    size_t peak = 0;
+    for (size_t m = first; m <= last; m++) {
+        if (tempogram[m] > 0.0 && tempogram[m] > tempogram[m - 1] && tempogram[m] >= tempogram[m + 1]
+            && (peak == 0 || tempogram[m] > tempogram[peak])) {
+            peak = m;
+        }
+    }
+    if (peak == 0) {
+        return -1.0;
+    }
+    double a = tempogram[peak - 1], b = tempogram[peak], c = tempogram[peak + 1];
+    double denominator = a - 2.0 * b + c;
+    return peak + (denominator < 0.0 ? 0.5 * (a - c) / denominator : 0.0);
+}
+
+//
+// Function: tempogramBPM
+// ----------------------
+// The envelope's mean is removed and its autocorrelation, computed through
+// the FFT, is divided by the number of terms at each lag so long lags are
+// not penalized for overlapping less. Each period P between the tempo limits
+// scores the tempogram at P plus half of it at 2P, weighted by the prior, so
+// a pulse whose every other beat is silent (half notes) still counts at the
+// beat rate. The peaks near the multiples kP of the best period are then
+// interpolated, and the period is their sum over the sum of k: the longer
+// multiples pin it down more finely.
+//
+float tempogramBPM(const double* envelope, size_t size, double framesPerSecond) {
+    const size_t minLag = std::max<size_t>(1, static_cast<size_t>(std::floor(framesPerSecond * 60.0 / TEMPOGRAM_MAX_BPM)));
+    const size_t maxLag = static_cast<size_t>(std::ceil(framesPerSecond * 60.0 / TEMPOGRAM_MIN_BPM));
+    if (size < 2 * maxLag + 2) {
+        return 0.0f;
+    }
+
+    double mean = 0.0;
+    for (size_t i = 0; i < size; i++) {
+        mean += envelope[i];
+    }
+    mean /= size;
+    std::vector<double> centred(size);
+    for (size_t i = 0; i < size; i++) {
+        centred[i] = envelope[i] - mean;
+    }
+
+    const size_t lags = std::min(size - 1, TEMPOGRAM_HARMONICS * (maxLag + 1));
+    std::vector<double> tempogram(lags + 1);
+    Autocorrelator autocorrelator;
+    autocorrelator.compute(centred.data(), size, lags, tempogram.data());
+    if (tempogram[0] <= 0.0) {
+        return 0.0f;
+    }
+    for (size_t lag = 0; lag <= lags; lag++) {
+        tempogram[lag] /= static_cast<double>(size - lag);
+    }
+
+    size_t period = 0;
+    double bestScore = 0.0;
+    for (size_t lag = minLag; lag <= maxLag && 2 * lag <= lags; lag++) {
+        double score = (tempogram[lag] + 0.5 * tempogram[2 * lag]) * tempoPrior(framesPerSecond * 60.0 / lag);
+        if (score > bestScore) {
+            bestScore = score;
+            period = lag;
+        }
+    }
+    if (period == 0) {
+        return 0.0f;
+    }
+
+    double lagSum = 0.0;
+    double multipleSum = 0.0;
+    for (size_t k = 1; k <= TEMPOGRAM_HARMONICS && k * period + k + 1 < tempogram.size(); k++) {
+        double peak = refinePeak(tempogram, k * period, k);
+        if (peak > 0.0) {
+            lagSum += peak;
+            multipleSum += k;
+        }
+    }
+    double refined = multipleSum > 0.0 ? lagSum / multipleSum : period;
+    return static_cast<float>(framesPerSecond * 60.0 / refined);
+}
+
+float tempogramBPM(const std::vector<double>& envelope, double framesPerSecond) {
+    return tempogramBPM(envelope.data(), envelope.size(), framesPerSecond);
+}
+
+template <typename S>
+float tempogramBPM(const BasicSpectrogram<S>& spectrogram, int sampleRate, int hopSize) {
+    return tempogramBPM(spectralFlux(spectrogram), static_cast<double>(sampleRate) / hopSize);
+}
+
+//
+// Class: TempogramTracker
+// -----------------------
+// Each frame is windowed and transformed with the cached FFT plan and only
+// its flux is kept.
+//
+TempogramTracker::TempogramTracker(int sampleRate)
+    : sampleRate_(sampleRate),
+      plan_(FFTPlanCache::instance().forward(TEMPOGRAM_WINDOW)),
+      window_(WindowRegistry::instance().get<double>(WindowType::Hamming, TEMPOGRAM_WINDOW)),
+      in_(fftw_alloc_real(TEMPOGRAM_WINDOW)),
+      out_(fftw_alloc_complex(TEMPOGRAM_WINDOW / 2 + 1)),
+      magnitudes_(TEMPOGRAM_WINDOW / 2 + 1),
+      flux_(TEMPOGRAM_WINDOW / 2 + 1) {}
+
+TempogramTracker::~TempogramTracker() {
+    fftw_free(in_);
+    fftw_free(out_);
+}
+
+void TempogramTracker::push(const Sample* block, size_t size) {
+    if (!driver_) {
+        driver_.reset(new FrameDriver());
+        driver_->add(*this);
+    }
+    driver_->push(block, size);
+}
+
+size_t TempogramTracker::frameSize() const {
+    return TEMPOGRAM_WINDOW;
+}
+
+size_t TempogramTracker::hopSize() const {
+    return TEMPOGRAM_HOP;
+}
+
+void TempogramTracker::transform(const Sample* frame, size_t size) {
+    for (size_t i = 0; i < size; i++) {
+        in_[i] = frame[i] * window_[i];
+    }
+    std::fill(in_ + size, in_ + TEMPOGRAM_WINDOW, 0.0);
+    fftw_execute_dft_r2c(plan_, in_, out_);
+    for (size_t bin = 0; bin < magnitudes_.size(); bin++) {
+        magnitudes_[bin] = std::sqrt(out_[bin][0] * out_[bin][0] + out_[bin][1] * out_[bin][1]);
+    }
+    flux_.push(magnitudes_.data());
+}
+
+void TempogramTracker::consume(const Sample* frame, size_t start) {
+    transform(frame, TEMPOGRAM_WINDOW);
+}
+
+void TempogramTracker::flush(const Sample* rest, size_t size) {
+    if (size > 0) {
+        transform(rest, size);
+    }
+}
+
+float TempogramTracker::finish() {
+    if (driver_) {
+        driver_->finish();
+        driver_.reset();
+    }
+    return tempogramBPM(flux_.envelope(), framesPerSecond());
+}
+
+double TempogramTracker::framesPerSecond() const {
+    return static_cast<double>(sampleRate_) / TEMPOGRAM_HOP;
+}
+
+float getTempogramBPM(const Sample* buf, size_t size, int sampleRate) {
+    TempogramTracker tracker(sampleRate);
+    tracker.push(buf, size);
+    return tracker.finish();
+}
+
+template void SpectralFlux::push<float>(const float*);
+template void SpectralFlux::push<double>(const double*);
+template std::vector<double> spectralFlux<float>(const BasicSpectrogram<float>&);
+template std::vector<double> spectralFlux<double>(const BasicSpectrogram<double>&);
+template float tempogramBPM<float>(const BasicSpectrogram<float>&, int, int);
+template float tempogramBPM<double>(const BasicSpectrogram<double>&, int, int);
@@ -0,0 +1,174 @@
+#include "threadPool.h"
+#include <algorithm>
+#include <new>
+
+namespace {
+// Set on pool threads and while the caller runs a job, so nested
+// parallelFor() calls fall back to running serially instead of deadlocking.
+thread_local bool insideJob = false;
+
+uint64_t packRange(uint64_t begin, uint64_t end){
+    return begin << 32 | end;
+}
+
+size_t rangeBegin(uint64_t range){
+    return static_cast<size_t>(range >> 32);
+}
+
+size_t rangeEnd(uint64_t range){
+    return static_cast<size_t>(range & 0xFFFFFFFFu);
+}
+}
+
+ThreadPool::ThreadPool(size_t numThreads)
+    : body_(nullptr), count_(0), grain_(1), cancelled_(false), active_(0), generation_(0), stop_(false){
+    if (numThreads == 0){
+        numThreads = std::max(1u, std::thread::hardware_concurrency());
+    }
+    static_assert(sizeof(WorkQueue) == AlignedBuffer<char>::ALIGNMENT, "one work queue per cache line");
+    queueStorage_.resize(numThreads * sizeof(WorkQueue));
+    queues_ = reinterpret_cast<WorkQueue*>(queueStorage_.data());
+    for (size_t worker = 0; worker < numThreads; worker++){
+        new (&queues_[worker]) WorkQueue();
+        queues_[worker].range = 0;
+    }
+    for (size_t worker = 1; worker < numThreads; worker++){
+        threads_.emplace_back(&ThreadPool::workerLoop, this, worker);
+    }
+}
+
+ThreadPool::~ThreadPool(){
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stop_ = true;
+    }
+    wake_.notify_all();
+    for (std::thread& thread : threads_){
+        thread.join();
+    }
+}
+
+size_t ThreadPool::size() const{
+    return threads_.size() + 1;
+}
+
+ThreadPool& ThreadPool::shared(){
+    static ThreadPool pool;
+    return pool;
+}
+
+void ThreadPool::parallelFor(size_t count, size_t grain,
+                             const std::function<void(size_t, size_t, size_t)>& body){
+    grain = std::max<size_t>(grain, 1);
+    if (count == 0){
+        return;
+    }
+    if (threads_.empty() || count <= grain || insideJob){
+        body(0, count, 0);
+        return;
+    }
+
+    // Chunk indices have to fit the 32-bit halves of a queue range.
+    grain = std::max<size_t>(grain, count / 0xFFFFFFFFu + 1);
+    const size_t chunks = (count + grain - 1) / grain;
+    const size_t workers = size();
+
+    std::lock_guard<std::mutex> job(jobMutex_);
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        body_ = &body;
+        count_ = count;
+        grain_ = grain;
+        cancelled_ = false;
+        for (size_t worker = 0; worker < workers; worker++){
+            queues_[worker].range = packRange(chunks * worker / workers, chunks * (worker + 1) / workers);
+        }
+        active_ = threads_.size();
+        error_ = nullptr;
+        generation_++;
+    }
+    wake_.notify_all();
+
+    insideJob = true;
+    runChunks(0);
+    insideJob = false;
+
+    std::unique_lock<std::mutex> lock(mutex_);
+    done_.wait(lock, [this]{ return active_ == 0; });
+    body_ = nullptr;
+    if (error_){
+        std::rethrow_exception(error_);
+    }
+}
+
+void ThreadPool::workerLoop(size_t worker){
+    insideJob = true;
+    uint64_t seen = 0;
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (true){
+        wake_.wait(lock, [&]{ return stop_ || generation_ != seen; });
+        if (stop_){
+            return;
+        }
+        seen = generation_;
+        lock.unlock();
+        runChunks(worker);
+        lock.lock();
+        if (--active_ == 0){
+            done_.notify_all();
+        }
+    }
+}
+
+void ThreadPool::runChunks(size_t worker){
+    size_t chunk;
+    while (!cancelled_ && (popChunk(worker, chunk) || stealChunk(worker, chunk))){
+        size_t begin = chunk * grain_;
+        size_t end = std::min(begin + grain_, count_);
+        try{
+            (*body_)(begin, end, worker);
+        }
+        catch (...){
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (!error_){
+                error_ = std::current_exception();
+            }
+            cancelled_ = true; // stop handing out chunks
+        }
+    }
+}
+
+// Takes the next chunk from the front of the worker's own queue.
+bool ThreadPool::popChunk(size_t worker, size_t& chunk){
+    std::atomic<uint64_t>& queue = queues_[worker].range;
+    uint64_t range = queue.load();
+    while (rangeBegin(range) < rangeEnd(range)){
+        if (queue.compare_exchange_weak(range, packRange(rangeBegin(range) + 1, rangeEnd(range)))){
+            chunk = rangeBegin(range);
+            return true;
+        }
+    }
+    return false;
+}
+
+// Moves the back half of another worker's queue into this worker's (empty)
+// queue and hands out its first chunk. Only the owner stores to a queue, and
+// a drained range never reappears, so the compare-exchange cannot be fooled.
+bool ThreadPool::stealChunk(size_t worker, size_t& chunk){
+    const size_t workers = size();
+    for (size_t i = 1; i < workers; i++){
+        std::atomic<uint64_t>& victim = queues_[(worker + i) % workers].range;
+        uint64_t range = victim.load();
+        while (rangeBegin(range) < rangeEnd(range)){
+            size_t begin = rangeBegin(range);
+            size_t end = rangeEnd(range);
+            size_t middle = begin + (end - begin) / 2;
+            if (victim.compare_exchange_weak(range, packRange(begin, middle))){
+                chunk = middle;
+                queues_[worker].range = packRange(middle + 1, end);
+                return true;
+            }
+        }
+    }
+    return false;
+}
@@ -0,0 +1,24 @@
+#include <algorithm>
+#include "windowProcessor.h"
+
+template <typename T>
+WindowProcessor<T>::WindowProcessor(const std::vector<double>& window)
+    : window_(window.begin(), window.end()){}
+
+template <typename T>
+WindowProcessor<T>::~WindowProcessor(){}
+
+template <typename T>
+size_t WindowProcessor<T>::process(Span<const T> in, Span<T> out){
+    const size_t windowSize = window_.size();
+    for (size_t frame = 0; frame < in.size(); frame += windowSize){
+        size_t count = std::min(windowSize, in.size() - frame);
+        for (size_t i = 0; i < count; i++){
+            out[frame + i] = in[frame + i] * window_[i];
+        }
+    }
+    return in.size();
+}
+
+template class WindowProcessor<float>;
+template class WindowProcessor<double>;
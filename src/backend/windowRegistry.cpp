@@ -0,0 +1,146 @@
+#include "windowRegistry.h"
+#include "windowTables.h"
+#include <cmath>
+#include <stdexcept>
+
+namespace {
+
+using windowtables::Table;
+using windowtables::makeTable;
+
+constexpr Table<double, 512> HAMMING_512 = makeTable<double, 512>(windowtables::hamming);
+constexpr Table<double, 1024> HAMMING_1024 = makeTable<double, 1024>(windowtables::hamming);
+constexpr Table<double, 2048> HAMMING_2048 = makeTable<double, 2048>(windowtables::hamming);
+constexpr Table<double, 4096> HAMMING_4096 = makeTable<double, 4096>(windowtables::hamming);
+constexpr Table<double, 512> HANNING_512 = makeTable<double, 512>(windowtables::hanning);
+constexpr Table<double, 1024> HANNING_1024 = makeTable<double, 1024>(windowtables::hanning);
+constexpr Table<double, 2048> HANNING_2048 = makeTable<double, 2048>(windowtables::hanning);
+constexpr Table<double, 4096> HANNING_4096 = makeTable<double, 4096>(windowtables::hanning);
+
+constexpr Table<float, 512> HAMMING_512F = makeTable<float, 512>(windowtables::hamming);
+constexpr Table<float, 1024> HAMMING_1024F = makeTable<float, 1024>(windowtables::hamming);
+constexpr Table<float, 2048> HAMMING_2048F = makeTable<float, 2048>(windowtables::hamming);
+constexpr Table<float, 4096> HAMMING_4096F = makeTable<float, 4096>(windowtables::hamming);
+constexpr Table<float, 512> HANNING_512F = makeTable<float, 512>(windowtables::hanning);
+constexpr Table<float, 1024> HANNING_1024F = makeTable<float, 1024>(windowtables::hanning);
+constexpr Table<float, 2048> HANNING_2048F = makeTable<float, 2048>(windowtables::hanning);
+constexpr Table<float, 4096> HANNING_4096F = makeTable<float, 4096>(windowtables::hanning);
+
+template <typename T>
+struct Precompiled;
+
+template <>
+struct Precompiled<double> {
+    static const double* find(WindowType type, int size) {
+        if (type == WindowType::Hamming) {
+            switch (size) {
+                case 512: return HAMMING_512.values;
+                case 1024: return HAMMING_1024.values;
+                case 2048: return HAMMING_2048.values;
+                case 4096: return HAMMING_4096.values;
+            }
+        } else if (type == WindowType::Hanning) {
+            switch (size) {
+                case 512: return HANNING_512.values;
+                case 1024: return HANNING_1024.values;
+                case 2048: return HANNING_2048.values;
+                case 4096: return HANNING_4096.values;
+            }
+        }
+        return nullptr;
+    }
+};
+
+template <>
+struct Precompiled<float> {
+    static const float* find(WindowType type, int size) {
+        if (type == WindowType::Hamming) {
+            switch (size) {
+                case 512: return HAMMING_512F.values;
+                case 1024: return HAMMING_1024F.values;
+                case 2048: return HAMMING_2048F.values;
+                case 4096: return HAMMING_4096F.values;
+            }
+        } else if (type == WindowType::Hanning) {
+            switch (size) {
+                case 512: return HANNING_512F.values;
+                case 1024: return HANNING_1024F.values;
+                case 2048: return HANNING_2048F.values;
+                case 4096: return HANNING_4096F.values;
+            }
+        }
+        return nullptr;
+    }
+};
+
+// Zeroth-order modified Bessel function of the first kind, by power series.
+double besselI0(double x) {
+    double sum = 1.0;
+    double term = 1.0;
+    double halfX = x / 2;
+    for (int k = 1; k < 64 && term > sum * 1e-17; k++) {
+        term *= (halfX / k) * (halfX / k);
+        sum += term;
+    }
+    return sum;
+}
+
+double windowValue(WindowType type, int i, int size, double beta) {
+    const double phase = (2 * windowtables::PI * i) / (size - 1);
+    switch (type) {
+        case WindowType::Hamming:
+            return 0.54 - 0.46 * std::cos(phase);
+        case WindowType::Hanning:
+            return 0.5 * (1 - std::cos(phase));
+        case WindowType::BlackmanHarris:
+            return 0.35875 - 0.48829 * std::cos(phase) + 0.14128 * std::cos(2 * phase)
+                 - 0.01168 * std::cos(3 * phase);
+        case WindowType::Kaiser: {
+            double r = 2.0 * i / (size - 1) - 1.0;
+            return besselI0(beta * std::sqrt(1.0 - r * r)) / besselI0(beta);
+        }
+    }
+    return 0.0;
+}
+
+// All four windows are symmetric, so only the first half is evaluated.
+template <typename T>
+std::unique_ptr<AlignedBuffer<T>> buildTable(WindowType type, int size, double beta) {
+    std::unique_ptr<AlignedBuffer<T>> table(new AlignedBuffer<T>(size));
+    for (int i = 0; i < (size + 1) / 2; i++) {
+        T value = static_cast<T>(windowValue(type, i, size, beta));
+        (*table)[i] = value;
+        (*table)[size - 1 - i] = value;
+    }
+    return table;
+}
+
+} // namespace
+
+WindowRegistry& WindowRegistry::instance() {
+    static WindowRegistry registry;
+    return registry;
+}
+
+WindowRegistry::WindowRegistry() {}
+
+template <typename T>
+Span<const T> WindowRegistry::get(WindowType type, int size, double beta) {
+    if (size < 2) {
+        throw std::invalid_argument("Error: windowSize must be >= 2");
+    }
+    if (const T* table = Precompiled<T>::find(type, size)) {
+        return Span<const T>(table, size);
+    }
+
+    Key key(static_cast<int>(type), size, type == WindowType::Kaiser ? beta : 0.0);
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::unique_ptr<AlignedBuffer<T>>& table = tables(static_cast<T*>(nullptr))[key];
+    if (!table) {
+        table = buildTable<T>(type, size, beta);
+    }
+    return Span<const T>(table->data(), size);
+}
+
+template Span<const float> WindowRegistry::get<float>(WindowType type, int size, double beta);
+template Span<const double> WindowRegistry::get<double>(WindowType type, int size, double beta);